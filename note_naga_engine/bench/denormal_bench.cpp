@@ -0,0 +1,107 @@
+// Denormal regression benchmark: renders a short noise burst through feedback blocks
+// (reverb, delay, filter) followed by a long silent tail and compares the time per block
+// in the tail with the time per block while the input is playing. Without flush-to-zero
+// the tail decays into denormals and gets many times slower. The blocks are processed
+// directly, so the DSP engine cannot skip them as silent.
+//
+// Usage: nn_denormal_bench [tail seconds]
+// Exit code 1 when a second of the tail with denormal protection is slower than
+// MAX_TAIL_RATIO times the playing part.
+
+#include <note_naga_engine/core/dsp_denormals.h>
+#include <note_naga_engine/dsp/dsp_factory.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+static constexpr float SAMPLE_RATE = 44100.0f;
+static constexpr size_t BLOCK_FRAMES = 512;
+static constexpr float BURST_SECONDS = 1.0f;
+static constexpr float MAX_TAIL_RATIO = 3.0f;
+
+struct RenderResult {
+    double burst_block_us = 0.0;   // mean block time while the input plays
+    double worst_tail_block_us = 0.0; // worst mean block time of one second of the tail
+    double worst_tail_second = 0.0;
+};
+
+static RenderResult renderTail(float tail_seconds) {
+    std::vector<std::unique_ptr<NoteNagaDSPBlockBase>> chain;
+    chain.emplace_back(nn_create_filter_block(0, 3000.0f, 0.9f, 1.0f));
+    chain.emplace_back(nn_create_delay_block(250.0f, 0.7f, 0.5f));
+    chain.emplace_back(nn_create_reverb_block(0.9f, 0.3f, 0.5f, 20.0f));
+    for (auto &block : chain) block->prepare(SAMPLE_RATE, BLOCK_FRAMES);
+
+    std::vector<float> left(BLOCK_FRAMES), right(BLOCK_FRAMES);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+
+    const size_t blocks_per_second = size_t(SAMPLE_RATE) / BLOCK_FRAMES;
+    const size_t burst_blocks = size_t(BURST_SECONDS * blocks_per_second);
+    const size_t total_blocks = burst_blocks + size_t(tail_seconds * blocks_per_second);
+
+    RenderResult result;
+    double second_us = 0.0;
+    size_t second_blocks = 0;
+    for (size_t b = 0; b < total_blocks; ++b) {
+        const bool burst = b < burst_blocks;
+        for (size_t i = 0; i < BLOCK_FRAMES; ++i) {
+            left[i] = burst ? noise(rng) : 0.0f;
+            right[i] = burst ? noise(rng) : 0.0f;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto &block : chain) block->process(left.data(), right.data(), BLOCK_FRAMES);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        second_us += us;
+        ++second_blocks;
+        if (b + 1 == burst_blocks) {
+            result.burst_block_us = second_us / double(second_blocks);
+            second_us = 0.0;
+            second_blocks = 0;
+        } else if (!burst && second_blocks == blocks_per_second) {
+            double mean = second_us / double(second_blocks);
+            if (mean > result.worst_tail_block_us) {
+                result.worst_tail_block_us = mean;
+                result.worst_tail_second = double(b + 1 - burst_blocks) / double(blocks_per_second);
+            }
+            second_us = 0.0;
+            second_blocks = 0;
+        }
+    }
+    return result;
+}
+
+static void printResult(const char *name, const RenderResult &r) {
+    std::printf("%-24s playing %8.2f us/block, worst tail second (%5.1f s) %8.2f us/block, ratio %.2f\n", name,
+                r.burst_block_us, r.worst_tail_second, r.worst_tail_block_us,
+                r.worst_tail_block_us / std::max(r.burst_block_us, 1e-9));
+}
+
+int main(int argc, char **argv) {
+    const float tail_seconds = argc > 1 ? float(std::atof(argv[1])) : 60.0f;
+
+    RenderResult unprotected = renderTail(tail_seconds);
+    printResult("without FTZ/DAZ:", unprotected);
+
+    RenderResult protected_result;
+    {
+        NoteNagaScopedNoDenormals no_denormals;
+        protected_result = renderTail(tail_seconds);
+    }
+    printResult("with FTZ/DAZ:", protected_result);
+
+    const double ratio = protected_result.worst_tail_block_us / std::max(protected_result.burst_block_us, 1e-9);
+    if (ratio > MAX_TAIL_RATIO) {
+        std::printf("FAIL: tail is %.2fx slower than the playing part (limit %.1fx)\n", ratio, MAX_TAIL_RATIO);
+        return 1;
+    }
+    std::printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,272 @@
+// Offline DSP benchmark: pushes test signals through every block of DSPBlockFactory at
+// several block sizes and sample rates and reports the cost as JSON, as a baseline to
+// compare optimizations against. Blocks are processed directly (no DSP engine), with
+// denormals flushed like on the audio thread.
+//
+// Usage: nn_dsp_bench [options]
+//   --seconds S             audio rendered per case (default 2)
+//   --block-sizes 64,256    frames per process() call (default 64,256,1024)
+//   --sample-rates 44100    sample rates (default 44100,48000,96000)
+//   --signals noise,sine    any of noise, sine, silence (default all)
+//   --blocks Gain,Reverb    block names from DSPBlockFactory (default all)
+//   --out file.json         write the report to a file instead of stdout
+//
+// Per case: mean ns per sample (one stereo frame), mean and worst time of one process()
+// call, worst load (worst call time / real-time duration of the block) and the number of
+// heap allocations made inside process().
+
+#include <note_naga_engine/core/dsp_denormals.h>
+#include <note_naga_engine/core/dsp_vector_math.h>
+#include <note_naga_engine/dsp/dsp_factory.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*******************************************************************************************************/
+// Allocation counting (replaces the global operator new of this executable)
+/*******************************************************************************************************/
+
+static std::atomic<bool> g_count_allocations{false};
+static std::atomic<size_t> g_allocations{0};
+
+void *operator new(size_t size) {
+    if (g_count_allocations.load(std::memory_order_relaxed)) g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+
+/*******************************************************************************************************/
+// Options
+/*******************************************************************************************************/
+
+struct Options {
+    float seconds = 2.0f;
+    std::vector<size_t> block_sizes = {64, 256, 1024};
+    std::vector<int> sample_rates = {44100, 48000, 96000};
+    std::vector<std::string> signals = {"noise", "sine", "silence"};
+    std::vector<std::string> blocks; // empty = all
+    std::string out_path;
+};
+
+static std::vector<std::string> splitList(const std::string &s) {
+    std::vector<std::string> items;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+static bool parseOptions(int argc, char **argv, Options &opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Missing value of %s\n", arg.c_str());
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--seconds") {
+            opt.seconds = std::max(0.01f, float(std::atof(value.c_str())));
+        } else if (arg == "--block-sizes") {
+            opt.block_sizes.clear();
+            for (const auto &v : splitList(value)) opt.block_sizes.push_back(std::max<size_t>(1, std::stoul(v)));
+        } else if (arg == "--sample-rates") {
+            opt.sample_rates.clear();
+            for (const auto &v : splitList(value)) opt.sample_rates.push_back(std::max(1000, std::stoi(v)));
+        } else if (arg == "--signals") {
+            opt.signals = splitList(value);
+        } else if (arg == "--blocks") {
+            opt.blocks = splitList(value);
+        } else if (arg == "--out") {
+            opt.out_path = value;
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    for (const auto &s : opt.signals) {
+        if (s != "noise" && s != "sine" && s != "silence") {
+            std::fprintf(stderr, "Unknown signal %s\n", s.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************************************/
+// Benchmark
+/*******************************************************************************************************/
+
+struct CaseResult {
+    std::string block;
+    std::string signal;
+    int sample_rate = 0;
+    size_t block_frames = 0;
+    double ns_per_sample = 0.0;
+    double mean_block_ns = 0.0;
+    double worst_block_ns = 0.0;
+    double worst_load = 0.0;
+    size_t allocations = 0;
+};
+
+// One second of the test signal (stereo, -6 dBFS)
+static void makeSignal(const std::string &signal, int sample_rate, std::vector<float> &left,
+                       std::vector<float> &right) {
+    left.assign(size_t(sample_rate), 0.0f);
+    right.assign(size_t(sample_rate), 0.0f);
+    if (signal == "noise") {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+        for (size_t i = 0; i < left.size(); ++i) {
+            left[i] = dist(rng);
+            right[i] = dist(rng);
+        }
+    } else if (signal == "sine") {
+        for (size_t i = 0; i < left.size(); ++i) {
+            left[i] = right[i] = 0.5f * float(std::sin(2.0 * M_PI * 440.0 * double(i) / double(sample_rate)));
+        }
+    }
+}
+
+static CaseResult runCase(const DSPBlockFactoryEntry &entry, const std::string &signal, int sample_rate,
+                          size_t block_frames, float seconds) {
+    CaseResult result;
+    result.block = entry.name;
+    result.signal = signal;
+    result.sample_rate = sample_rate;
+    result.block_frames = block_frames;
+
+    std::unique_ptr<NoteNagaDSPBlockBase> block(entry.create());
+    block->prepare(float(sample_rate), block_frames);
+
+    std::vector<float> src_left, src_right;
+    makeSignal(signal, sample_rate, src_left, src_right);
+    std::vector<float> left(block_frames), right(block_frames);
+
+    const size_t warmup_blocks = std::max<size_t>(1, size_t(0.1f * sample_rate) / block_frames);
+    const size_t measured_blocks = std::max<size_t>(1, size_t(seconds * sample_rate) / block_frames);
+    size_t src_pos = 0;
+    double total_ns = 0.0;
+
+    for (size_t b = 0; b < warmup_blocks + measured_blocks; ++b) {
+        for (size_t i = 0; i < block_frames; ++i) {
+            left[i] = src_left[src_pos];
+            right[i] = src_right[src_pos];
+            if (++src_pos == src_left.size()) src_pos = 0;
+        }
+
+        const bool measured = b >= warmup_blocks;
+        g_count_allocations.store(measured, std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        block->process(left.data(), right.data(), block_frames);
+        auto end = std::chrono::steady_clock::now();
+        g_count_allocations.store(false, std::memory_order_relaxed);
+
+        if (!measured) continue;
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        total_ns += ns;
+        result.worst_block_ns = std::max(result.worst_block_ns, ns);
+    }
+    result.allocations = g_allocations.exchange(0, std::memory_order_relaxed);
+
+    const double block_duration_ns = double(block_frames) * 1e9 / double(sample_rate);
+    result.ns_per_sample = total_ns / double(measured_blocks * block_frames);
+    result.mean_block_ns = total_ns / double(measured_blocks);
+    result.worst_load = result.worst_block_ns / block_duration_ns;
+    return result;
+}
+
+static std::string jsonEscape(const std::string &s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+static std::string toJson(const Options &opt, const std::vector<CaseResult> &results) {
+    std::ostringstream js;
+    js.precision(6);
+    js << "{\n";
+    js << "  \"isa\": \"" << nn_vec_get_isa() << "\",\n";
+    js << "  \"seconds_per_case\": " << opt.seconds << ",\n";
+    js << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const CaseResult &r = results[i];
+        js << "    {\"block\": \"" << jsonEscape(r.block) << "\", \"signal\": \"" << r.signal
+           << "\", \"sample_rate\": " << r.sample_rate << ", \"block_frames\": " << r.block_frames
+           << ", \"ns_per_sample\": " << r.ns_per_sample << ", \"mean_block_ns\": " << r.mean_block_ns
+           << ", \"worst_block_ns\": " << r.worst_block_ns << ", \"worst_load\": " << r.worst_load
+           << ", \"allocations\": " << r.allocations << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    js << "  ]\n";
+    js << "}\n";
+    return js.str();
+}
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) return 2;
+
+    std::vector<const DSPBlockFactoryEntry *> entries;
+    for (const auto &entry : DSPBlockFactory::allBlocks()) {
+        if (opt.blocks.empty() || std::find(opt.blocks.begin(), opt.blocks.end(), entry.name) != opt.blocks.end()) {
+            entries.push_back(&entry);
+        }
+    }
+    if (entries.empty()) {
+        std::fprintf(stderr, "No matching blocks\n");
+        return 2;
+    }
+
+    // Same floating point mode as the audio thread
+    NoteNagaScopedNoDenormals no_denormals;
+
+    std::vector<CaseResult> results;
+    for (const auto *entry : entries) {
+        for (const auto &signal : opt.signals) {
+            for (int sample_rate : opt.sample_rates) {
+                for (size_t block_frames : opt.block_sizes) {
+                    results.push_back(runCase(*entry, signal, sample_rate, block_frames, opt.seconds));
+                    const CaseResult &r = results.back();
+                    std::fprintf(stderr, "%-20s %-8s %6d Hz %5zu frames: %8.2f ns/sample, worst load %.4f\n",
+                                 r.block.c_str(), r.signal.c_str(), r.sample_rate, r.block_frames,
+                                 r.ns_per_sample, r.worst_load);
+                }
+            }
+        }
+    }
+
+    const std::string json = toJson(opt, results);
+    if (opt.out_path.empty()) {
+        std::fputs(json.c_str(), stdout);
+    } else {
+        FILE *f = std::fopen(opt.out_path.c_str(), "w");
+        if (!f) {
+            std::fprintf(stderr, "Cannot write %s\n", opt.out_path.c_str());
+            return 1;
+        }
+        std::fputs(json.c_str(), f);
+        std::fclose(f);
+    }
+    return 0;
+}
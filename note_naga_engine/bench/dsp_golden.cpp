@@ -0,0 +1,378 @@
+// Golden output regression check: renders a fixed stimulus through every block of
+// DSPBlockFactory and through NoteNagaDSPEngine::render (with a deterministic mock synth)
+// and compares the result with the reference outputs checked in under bench/golden.
+// Meant as a safety net for optimizations (SIMD, fast math) which may change the output
+// slightly but must not change what it sounds like. Every block renders with its factory
+// defaults (a few changed, see applyOverrides) and once more per non-default option of
+// its selector parameters, e.g. "Saturator 8x" or "Limiter True Peak".
+//
+// Usage: nn_dsp_golden [options]
+//   --record                write new references instead of comparing
+//   --dir path              reference directory (default: bench/golden of the source tree)
+//   --cases Gain,Engine     only these cases (default all)
+//   --max-abs X             largest allowed sample difference (default 1e-3)
+//   --max-spectral-db X     largest allowed mean spectral difference in dB (default 0.5)
+// Exit code 1 when a case differs more than allowed or its reference is missing.
+//
+// Metrics per case: the largest sample difference, the error energy relative to the
+// reference (dB) and the mean absolute difference of the Hann windowed log magnitude
+// spectra (1024 points, hop 512, magnitudes floored at -100 dB).
+
+#include <note_naga_engine/core/dsp_denormals.h>
+#include <note_naga_engine/core/dsp_fft.h>
+#include <note_naga_engine/core/note_naga_synthesizer.h>
+#include <note_naga_engine/dsp/dsp_factory.h>
+#include <note_naga_engine/module/dsp_engine.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef NN_GOLDEN_DIR
+#define NN_GOLDEN_DIR "golden"
+#endif
+
+static constexpr int SAMPLE_RATE = 44100;
+static constexpr size_t BLOCK_FRAMES = 256;
+static constexpr size_t TOTAL_FRAMES = 8192;
+static constexpr uint32_t FILE_MAGIC = 0x44474E4E; // "NNGD"
+static constexpr uint32_t FILE_VERSION = 1;
+
+/*******************************************************************************************************/
+// Stimulus and mock synth
+/*******************************************************************************************************/
+
+// Deterministic noise, independent of the standard library implementation
+struct XorShift {
+    uint32_t state;
+    explicit XorShift(uint32_t seed) : state(seed) {}
+    float next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return float(state) / 4294967296.0f * 2.0f - 1.0f;
+    }
+};
+
+// Impulse, exponential sine sweep 40 Hz .. 16 kHz, noise burst, silence (tails)
+static void makeStimulus(std::vector<float> &left, std::vector<float> &right) {
+    left.assign(TOTAL_FRAMES, 0.0f);
+    right.assign(TOTAL_FRAMES, 0.0f);
+    left[0] = right[0] = 0.9f;
+
+    const size_t sweep_start = 512, sweep_frames = 4096;
+    const double f0 = 40.0, f1 = 16000.0;
+    const double duration = double(sweep_frames) / SAMPLE_RATE;
+    const double k = std::log(f1 / f0);
+    for (size_t i = 0; i < sweep_frames; ++i) {
+        const double t = double(i) / SAMPLE_RATE;
+        const double phase = 2.0 * M_PI * f0 * duration / k * (std::exp(t / duration * k) - 1.0);
+        left[sweep_start + i] = float(0.5 * std::sin(phase));
+        right[sweep_start + i] = float(0.5 * std::cos(phase));
+    }
+
+    XorShift noise_l(12345), noise_r(67890);
+    for (size_t i = sweep_start + sweep_frames; i < 6144; ++i) {
+        left[i] = 0.5f * noise_l.next();
+        right[i] = 0.5f * noise_r.next();
+    }
+}
+
+// Two decaying partials retriggered every 2048 frames, silent in the last quarter
+class GoldenMockSynth : public INoteNagaSoftSynth {
+public:
+    void renderAudio(float *left, float *right, size_t num_frames) override {
+        for (size_t i = 0; i < num_frames; ++i, ++frame_) {
+            const size_t pos = frame_ % 2048;
+            float value = 0.0f;
+            if (frame_ < TOTAL_FRAMES * 3 / 4) {
+                const double t = double(pos) / SAMPLE_RATE;
+                const double env = std::exp(-t * 20.0);
+                value = float(env * (0.4 * std::sin(2.0 * M_PI * 220.0 * t) + 0.2 * std::sin(2.0 * M_PI * 1320.0 * t)));
+            }
+            left[i] = value;
+            right[i] = 0.8f * value;
+        }
+    }
+
+private:
+    size_t frame_ = 0;
+};
+
+/*******************************************************************************************************/
+// Cases
+/*******************************************************************************************************/
+
+struct GoldenCase {
+    std::string name;
+    std::function<void(std::vector<float> &)> render; // interleaved stereo, TOTAL_FRAMES
+};
+
+// A parameter set by name, e.g. one option of a selector
+struct GoldenParam {
+    std::string name;
+    float value;
+};
+
+static void setParam(NoteNagaDSPBlockBase *block, const std::string &name, float value) {
+    const auto descriptors = block->getParamDescriptors();
+    for (size_t i = 0; i < descriptors.size(); ++i) {
+        if (descriptors[i].name == name) block->setParamValue(i, value);
+    }
+}
+
+// Parameters changed from the factory defaults so the stimulus shows the effect
+static void applyOverrides(NoteNagaDSPBlockBase *block, const std::string &name) {
+    if (name == "Delay") {
+        setParam(block, "Time", 60.0f); // echoes within the render
+    } else if (name == "Single EQ") {
+        setParam(block, "Gain", 9.0f);
+    } else if (name == "Multi Band EQ") {
+        // Every band is a gain, alternating boost / cut
+        const size_t bands = block->getParamDescriptors().size();
+        for (size_t i = 0; i < bands; ++i) block->setParamValue(i, (i % 2) ? -6.0f : 6.0f);
+    }
+}
+
+static void renderBlock(const DSPBlockFactoryEntry &entry, const std::vector<GoldenParam> &params,
+                        std::vector<float> &out) {
+    std::unique_ptr<NoteNagaDSPBlockBase> block(entry.create());
+    block->prepare(float(SAMPLE_RATE), BLOCK_FRAMES);
+    applyOverrides(block.get(), entry.name);
+    for (const GoldenParam &param : params) setParam(block.get(), param.name, param.value);
+
+    std::vector<float> left, right;
+    makeStimulus(left, right);
+    for (size_t offset = 0; offset < TOTAL_FRAMES; offset += BLOCK_FRAMES) {
+        block->process(left.data() + offset, right.data() + offset, BLOCK_FRAMES);
+    }
+
+    out.resize(TOTAL_FRAMES * 2);
+    for (size_t i = 0; i < TOTAL_FRAMES; ++i) {
+        out[i * 2] = left[i];
+        out[i * 2 + 1] = right[i];
+    }
+}
+
+// Synth chain (filter, compressor) and master chain (reverb, limiter) through the engine
+static void renderEngine(std::vector<float> &out) {
+    GoldenMockSynth synth;
+    NoteNagaDSPEngine engine;
+    engine.prepare(SAMPLE_RATE, BLOCK_FRAMES);
+    engine.addSynth(&synth);
+
+    std::vector<std::unique_ptr<NoteNagaDSPBlockBase>> blocks;
+    blocks.emplace_back(nn_create_filter_block());
+    blocks.emplace_back(nn_create_compressor_block());
+    blocks.emplace_back(nn_create_reverb_block());
+    blocks.emplace_back(nn_create_limiter_block());
+    engine.addSynthDSPBlock(&synth, blocks[0].get());
+    engine.addSynthDSPBlock(&synth, blocks[1].get());
+    engine.addDSPBlock(blocks[2].get());
+    engine.addDSPBlock(blocks[3].get());
+
+    out.assign(TOTAL_FRAMES * 2, 0.0f);
+    for (size_t offset = 0; offset < TOTAL_FRAMES; offset += BLOCK_FRAMES) {
+        engine.render(out.data() + offset * 2, BLOCK_FRAMES);
+    }
+
+    engine.removeSynth(&synth);
+    for (auto &block : blocks) engine.removeDSPBlock(block.get());
+}
+
+static std::vector<GoldenCase> allCases() {
+    std::vector<GoldenCase> cases;
+    for (const auto &entry : DSPBlockFactory::allBlocks()) {
+        const DSPBlockFactoryEntry *e = &entry;
+        cases.push_back({entry.name, [e](std::vector<float> &out) { renderBlock(*e, {}, out); }});
+
+        // One more case per non-default option of every selector (oversampling quality,
+        // limiter mode, filter type), named "<block> <option>"
+        for (const DSPParamDescriptor &desc : DSPBlockFactory::paramDescriptors(entry)) {
+            for (size_t o = 0; o < desc.options.size(); ++o) {
+                const float value = desc.min_value + float(o);
+                if (value == desc.default_value) continue;
+                const std::vector<GoldenParam> params = {{desc.name, value}};
+                cases.push_back({entry.name + " " + desc.options[o],
+                                 [e, params](std::vector<float> &out) { renderBlock(*e, params, out); }});
+            }
+        }
+    }
+    cases.push_back({"Engine", [](std::vector<float> &out) { renderEngine(out); }});
+    return cases;
+}
+
+/*******************************************************************************************************/
+// Reference files
+/*******************************************************************************************************/
+
+static std::string referencePath(const std::string &dir, const std::string &name) {
+    std::string file;
+    for (char c : name) file += (c == ' ') ? '_' : char(std::tolower(static_cast<unsigned char>(c)));
+    return dir + "/" + file + ".golden";
+}
+
+// Header (magic, version, sample rate, frames) and interleaved stereo float32, little endian
+static bool writeReference(const std::string &path, const std::vector<float> &data) {
+    FILE *f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    const uint32_t header[4] = {FILE_MAGIC, FILE_VERSION, uint32_t(SAMPLE_RATE), uint32_t(TOTAL_FRAMES)};
+    bool ok = std::fwrite(header, sizeof(header), 1, f) == 1 &&
+              std::fwrite(data.data(), sizeof(float), data.size(), f) == data.size();
+    std::fclose(f);
+    return ok;
+}
+
+static bool readReference(const std::string &path, std::vector<float> &data) {
+    FILE *f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    uint32_t header[4] = {};
+    bool ok = std::fread(header, sizeof(header), 1, f) == 1 && header[0] == FILE_MAGIC &&
+              header[1] == FILE_VERSION && header[2] == uint32_t(SAMPLE_RATE) && header[3] == uint32_t(TOTAL_FRAMES);
+    if (ok) {
+        data.resize(TOTAL_FRAMES * 2);
+        ok = std::fread(data.data(), sizeof(float), data.size(), f) == data.size();
+    }
+    std::fclose(f);
+    return ok;
+}
+
+/*******************************************************************************************************/
+// Metrics
+/*******************************************************************************************************/
+
+struct Difference {
+    double max_abs = 0.0;
+    double error_db = -INFINITY; // error energy relative to the reference
+    double spectral_db = 0.0;    // mean absolute log spectrum difference
+};
+
+static double meanSpectralDifference(const std::vector<float> &out, const std::vector<float> &ref, size_t channel) {
+    constexpr size_t FFT_SIZE = 1024, HOP = 512;
+    constexpr float FLOOR_DB = -100.0f;
+    NoteNagaFFT fft(FFT_SIZE);
+    std::vector<float> window(FFT_SIZE), frame(FFT_SIZE), re(fft.getNumBins()), im(fft.getNumBins());
+    for (size_t i = 0; i < FFT_SIZE; ++i) window[i] = 0.5f - 0.5f * float(std::cos(2.0 * M_PI * i / FFT_SIZE));
+
+    auto spectrum = [&](const std::vector<float> &x, size_t start, std::vector<float> &db) {
+        for (size_t i = 0; i < FFT_SIZE; ++i) frame[i] = x[(start + i) * 2 + channel] * window[i];
+        fft.forwardReal(frame.data(), re.data(), im.data());
+        db.resize(fft.getNumBins());
+        for (size_t b = 0; b < db.size(); ++b) {
+            const float mag = std::sqrt(re[b] * re[b] + im[b] * im[b]) * (2.0f / FFT_SIZE);
+            db[b] = std::max(FLOOR_DB, 20.0f * std::log10(std::max(mag, 1e-12f)));
+        }
+    };
+
+    std::vector<float> out_db, ref_db;
+    double sum = 0.0;
+    size_t count = 0;
+    for (size_t start = 0; start + FFT_SIZE <= TOTAL_FRAMES; start += HOP) {
+        spectrum(out, start, out_db);
+        spectrum(ref, start, ref_db);
+        for (size_t b = 0; b < out_db.size(); ++b) sum += std::fabs(out_db[b] - ref_db[b]);
+        count += out_db.size();
+    }
+    return count ? sum / double(count) : 0.0;
+}
+
+static Difference compare(const std::vector<float> &out, const std::vector<float> &ref) {
+    Difference diff;
+    double err_energy = 0.0, ref_energy = 0.0;
+    for (size_t i = 0; i < out.size(); ++i) {
+        const double e = double(out[i]) - double(ref[i]);
+        diff.max_abs = std::max(diff.max_abs, std::fabs(e));
+        err_energy += e * e;
+        ref_energy += double(ref[i]) * double(ref[i]);
+    }
+    if (err_energy > 0.0) diff.error_db = 10.0 * std::log10(err_energy / std::max(ref_energy, 1e-30));
+    diff.spectral_db = std::max(meanSpectralDifference(out, ref, 0), meanSpectralDifference(out, ref, 1));
+    return diff;
+}
+
+/*******************************************************************************************************/
+// Main
+/*******************************************************************************************************/
+
+int main(int argc, char **argv) {
+    bool record = false;
+    std::string dir = NN_GOLDEN_DIR;
+    std::vector<std::string> only;
+    double max_abs = 1e-3, max_spectral_db = 0.5;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--record") {
+            record = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Missing value of %s\n", arg.c_str());
+            return 2;
+        }
+        std::string value = argv[++i];
+        if (arg == "--dir") {
+            dir = value;
+        } else if (arg == "--cases") {
+            std::stringstream ss(value);
+            std::string item;
+            while (std::getline(ss, item, ',')) only.push_back(item);
+        } else if (arg == "--max-abs") {
+            max_abs = std::atof(value.c_str());
+        } else if (arg == "--max-spectral-db") {
+            max_spectral_db = std::atof(value.c_str());
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    // Same floating point mode as the audio thread
+    NoteNagaScopedNoDenormals no_denormals;
+
+    int failures = 0;
+    for (const GoldenCase &c : allCases()) {
+        if (!only.empty() && std::find(only.begin(), only.end(), c.name) == only.end()) continue;
+
+        std::vector<float> out;
+        c.render(out);
+        const std::string path = referencePath(dir, c.name);
+
+        if (record) {
+            if (!writeReference(path, out)) {
+                std::printf("%-20s cannot write %s\n", c.name.c_str(), path.c_str());
+                ++failures;
+            } else {
+                std::printf("%-20s recorded %s\n", c.name.c_str(), path.c_str());
+            }
+            continue;
+        }
+
+        std::vector<float> ref;
+        if (!readReference(path, ref)) {
+            std::printf("%-20s FAIL: missing or invalid reference %s\n", c.name.c_str(), path.c_str());
+            ++failures;
+            continue;
+        }
+        const Difference d = compare(out, ref);
+        const bool ok = d.max_abs <= max_abs && d.spectral_db <= max_spectral_db;
+        std::printf("%-20s %s max abs %.3g, error %7.1f dB, spectral %.4f dB\n", c.name.c_str(), ok ? "ok  " : "FAIL",
+                    d.max_abs, d.error_db, d.spectral_db);
+        if (!ok) ++failures;
+    }
+
+    if (failures > 0) {
+        std::printf("%d case(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
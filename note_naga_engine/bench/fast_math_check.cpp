@@ -0,0 +1,102 @@
+// Accuracy check of the fast math approximations (core/dsp_fast_math.h): sweeps every
+// function over the input range of its row in the error table of the header, compares
+// with double precision libm and fails when the error exceeds the documented bound.
+// Keep the bounds below in sync with that table.
+//
+// Usage: nn_fast_math_check [points per range]
+// Exit code 1 when a function is less accurate than documented.
+//
+// Errors are absolute (|fast - libm|) or relative (|fast - libm| / |libm|). Ranges of
+// x > 0 functions are swept on a logarithmic scale, all others linearly.
+
+#include <note_naga_engine/core/dsp_fast_math.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static constexpr double PI = 3.14159265358979323846;
+static constexpr double MIN_NORMAL = 1.17549435e-38;
+static constexpr double MAX_FLOAT = 3.40282347e38;
+
+struct AccuracyCase {
+    std::string name;
+    float (*fast)(float);
+    double (*reference)(double);
+    double lo, hi;
+    bool log_sweep;
+    double max_abs; // documented absolute bound, 0 when not documented
+    double max_rel; // documented relative bound, 0 when not documented
+};
+
+struct Accuracy {
+    double abs = 0.0, rel = 0.0;
+    float worst_abs_x = 0.0f, worst_rel_x = 0.0f;
+};
+
+static Accuracy sweep(const AccuracyCase &c, size_t points) {
+    Accuracy acc;
+    for (size_t i = 0; i <= points; ++i) {
+        const double t = double(i) / double(points);
+        const double xd = c.log_sweep ? c.lo * std::pow(c.hi / c.lo, t) : c.lo + (c.hi - c.lo) * t;
+        // Evaluate both at the float the fast function actually sees
+        const float x = std::clamp(float(xd), float(c.lo), float(c.hi));
+        const double ref = c.reference(double(x));
+        const double err = std::fabs(double(c.fast(x)) - ref);
+        if (err > acc.abs) {
+            acc.abs = err;
+            acc.worst_abs_x = x;
+        }
+        if (ref != 0.0 && err / std::fabs(ref) > acc.rel) {
+            acc.rel = err / std::fabs(ref);
+            acc.worst_rel_x = x;
+        }
+    }
+    return acc;
+}
+
+static std::vector<AccuracyCase> allCases() {
+    // clang-format off
+    return {
+        {"exp2",           nn_fast_exp2,         [](double x) { return std::exp2(x); },               -126.0, 126.0, false, 0.0, 2.5e-7},
+        {"exp",            nn_fast_exp,          [](double x) { return std::exp(x); },                -10.0, 10.0,   false, 0.0, 6.9e-7},
+        {"exp (+-87)",     nn_fast_exp,          [](double x) { return std::exp(x); },                -87.0, 87.0,   false, 0.0, 4.0e-6},
+        {"log2 (<1)",      nn_fast_log2,         [](double x) { return std::log2(x); },               MIN_NORMAL, 1.0, true, 4.0e-6, 2.6e-7},
+        {"log2 (>1)",      nn_fast_log2,         [](double x) { return std::log2(x); },               1.0, MAX_FLOAT,  true, 0.0, 2.7e-7},
+        {"sin_turns",      nn_fast_sin_turns,    [](double t) { return std::sin(2.0 * PI * t); },     -1.0, 1.0,     false, 4.1e-7, 0.0},
+        {"cos_turns",      nn_fast_cos_turns,    [](double t) { return std::cos(2.0 * PI * t); },     -1.0, 1.0,     false, 4.1e-7, 0.0},
+        {"sin",            nn_fast_sin,          [](double x) { return std::sin(x); },                -PI, PI,       false, 3.6e-7, 0.0},
+        {"cos",            nn_fast_cos,          [](double x) { return std::cos(x); },                -PI, PI,       false, 3.6e-7, 0.0},
+        {"tanh",           nn_fast_tanh,         [](double x) { return std::tanh(x); },               -20.0, 20.0,   false, 1.5e-7, 0.0},
+        {"db_to_linear",   nn_fast_db_to_linear, [](double db) { return std::pow(10.0, db / 20.0); }, -120.0, 120.0, false, 0.0, 9.4e-7},
+        {"linear_to_db (<1)", nn_fast_linear_to_db, [](double x) { return 20.0 * std::log10(x); },    MIN_NORMAL, 1.0, true, 6.3e-5, 2.7e-7},
+        {"linear_to_db (>1)", nn_fast_linear_to_db, [](double x) { return 20.0 * std::log10(x); },    1.0, MAX_FLOAT,  true, 0.0, 3.0e-7},
+    };
+    // clang-format on
+}
+
+int main(int argc, char **argv) {
+    const size_t points = argc > 1 ? size_t(std::max(1L, std::atol(argv[1]))) : size_t(4000000);
+
+    int failures = 0;
+    for (const AccuracyCase &c : allCases()) {
+        const Accuracy acc = sweep(c, points);
+        const bool abs_ok = c.max_abs <= 0.0 || acc.abs <= c.max_abs;
+        const bool rel_ok = c.max_rel <= 0.0 || acc.rel <= c.max_rel;
+        const bool ok = abs_ok && rel_ok;
+        std::printf("%-18s %s", c.name.c_str(), ok ? "ok  " : "FAIL");
+        if (c.max_abs > 0.0) std::printf(" abs %.3g (x = %g, bound %.2g)", acc.abs, acc.worst_abs_x, c.max_abs);
+        if (c.max_rel > 0.0) std::printf(" rel %.3g (x = %g, bound %.2g)", acc.rel, acc.worst_rel_x, c.max_rel);
+        std::printf("\n");
+        if (!ok) ++failures;
+    }
+
+    if (failures > 0) {
+        std::printf("%d function(s) exceed the documented error\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,246 @@
+#include <note_naga_engine/core/dsp_biquad.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NN_BIQUAD_SIMD 1
+typedef __m128 nn_f4;
+static inline nn_f4 f4_load(const float *p) { return _mm_load_ps(p); }
+static inline void f4_store(float *p, nn_f4 v) { _mm_store_ps(p, v); }
+static inline nn_f4 f4_dup(float a) { return _mm_set1_ps(a); }
+static inline nn_f4 f4_add(nn_f4 a, nn_f4 b) { return _mm_add_ps(a, b); }
+static inline nn_f4 f4_sub(nn_f4 a, nn_f4 b) { return _mm_sub_ps(a, b); }
+static inline nn_f4 f4_mul(nn_f4 a, nn_f4 b) { return _mm_mul_ps(a, b); }
+// {x, v0, v1, v2}: feed a new sample into lane 0, move lane outputs one stage up
+static inline nn_f4 f4_shift_in(nn_f4 v, float x) {
+    return _mm_move_ss(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4)), _mm_set_ss(x));
+}
+static inline float f4_lane3(nn_f4 v) { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))); }
+// lanes k with lo < k <= hi keep the new value, the others the old one
+static inline nn_f4 f4_select_lanes(nn_f4 fresh, nn_f4 old, float lo, float hi) {
+    const nn_f4 idx = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    nn_f4 mask = _mm_and_ps(_mm_cmpgt_ps(idx, _mm_set1_ps(lo)), _mm_cmple_ps(idx, _mm_set1_ps(hi)));
+    return _mm_or_ps(_mm_and_ps(mask, fresh), _mm_andnot_ps(mask, old));
+}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define NN_BIQUAD_SIMD 1
+typedef float32x4_t nn_f4;
+static inline nn_f4 f4_load(const float *p) { return vld1q_f32(p); }
+static inline void f4_store(float *p, nn_f4 v) { vst1q_f32(p, v); }
+static inline nn_f4 f4_dup(float a) { return vdupq_n_f32(a); }
+static inline nn_f4 f4_add(nn_f4 a, nn_f4 b) { return vaddq_f32(a, b); }
+static inline nn_f4 f4_sub(nn_f4 a, nn_f4 b) { return vsubq_f32(a, b); }
+static inline nn_f4 f4_mul(nn_f4 a, nn_f4 b) { return vmulq_f32(a, b); }
+static inline nn_f4 f4_shift_in(nn_f4 v, float x) { return vextq_f32(vdupq_n_f32(x), v, 3); }
+static inline float f4_lane3(nn_f4 v) { return vgetq_lane_f32(v, 3); }
+static inline nn_f4 f4_select_lanes(nn_f4 fresh, nn_f4 old, float lo, float hi) {
+    static const float lanes[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    nn_f4 idx = vld1q_f32(lanes);
+    uint32x4_t mask = vandq_u32(vcgtq_f32(idx, vdupq_n_f32(lo)), vcleq_f32(idx, vdupq_n_f32(hi)));
+    return vbslq_f32(mask, fresh, old);
+}
+#endif
+
+/*******************************************************************************************************/
+// Coefficient design (RBJ audio EQ cookbook)
+/*******************************************************************************************************/
+
+static NN_BiquadCoeffs_t normalize(float b0, float b1, float b2, float a0, float a1, float a2) {
+    NN_BiquadCoeffs_t c;
+    c.b0 = b0 / a0;
+    c.b1 = b1 / a0;
+    c.b2 = b2 / a0;
+    c.a1 = a1 / a0;
+    c.a2 = a2 / a0;
+    return c;
+}
+
+NN_BiquadCoeffs_t nn_biquad_peak(float sample_rate, float freq, float gain_db, float q) {
+    float A = powf(10.0f, gain_db / 40.0f);
+    float omega = 2.0f * float(M_PI) * freq / sample_rate;
+    float sn = sinf(omega);
+    float cs = cosf(omega);
+    float alpha = sn / (2.0f * q);
+    return normalize(1.0f + alpha * A, -2.0f * cs, 1.0f - alpha * A, 1.0f + alpha / A, -2.0f * cs,
+                     1.0f - alpha / A);
+}
+
+NN_BiquadCoeffs_t nn_biquad_lowpass(float sample_rate, float freq, float q) {
+    float omega = 2.0f * float(M_PI) * freq / sample_rate;
+    float sn = sinf(omega);
+    float cs = cosf(omega);
+    float alpha = sn / (2.0f * q);
+    return normalize((1.0f - cs) * 0.5f, 1.0f - cs, (1.0f - cs) * 0.5f, 1.0f + alpha, -2.0f * cs,
+                     1.0f - alpha);
+}
+
+NN_BiquadCoeffs_t nn_biquad_highpass(float sample_rate, float freq, float q) {
+    float omega = 2.0f * float(M_PI) * freq / sample_rate;
+    float sn = sinf(omega);
+    float cs = cosf(omega);
+    float alpha = sn / (2.0f * q);
+    return normalize((1.0f + cs) * 0.5f, -(1.0f + cs), (1.0f + cs) * 0.5f, 1.0f + alpha, -2.0f * cs,
+                     1.0f - alpha);
+}
+
+NN_BiquadCoeffs_t nn_biquad_bandpass(float sample_rate, float freq, float q) {
+    float omega = 2.0f * float(M_PI) * freq / sample_rate;
+    float sn = sinf(omega);
+    float cs = cosf(omega);
+    float alpha = sn / (2.0f * q);
+    return normalize(alpha, 0.0f, -alpha, 1.0f + alpha, -2.0f * cs, 1.0f - alpha);
+}
+
+/*******************************************************************************************************/
+// Biquad cascade
+/*******************************************************************************************************/
+
+NoteNagaBiquadCascade::NoteNagaBiquadCascade() {
+    for (size_t s = 0; s < MAX_STAGES; ++s) setCoeffs(s, NN_BiquadCoeffs_t());
+    reset();
+}
+
+void NoteNagaBiquadCascade::setStageCount(size_t num_stages) {
+    num_stages = std::min(num_stages, MAX_STAGES);
+    for (size_t s = num_stages_; s < num_stages; ++s) {
+        setCoeffs(s, NN_BiquadCoeffs_t());
+        for (int c = 0; c < 2; ++c) x1_[c][s] = x2_[c][s] = y1_[c][s] = y2_[c][s] = 0.0f;
+    }
+    num_stages_ = num_stages;
+}
+
+void NoteNagaBiquadCascade::setCoeffs(size_t stage, const NN_BiquadCoeffs_t &coeffs) {
+    if (stage >= MAX_STAGES) return;
+    b0_[stage] = coeffs.b0;
+    b1_[stage] = coeffs.b1;
+    b2_[stage] = coeffs.b2;
+    a1_[stage] = coeffs.a1;
+    a2_[stage] = coeffs.a2;
+}
+
+void NoteNagaBiquadCascade::reset() {
+    std::fill(&x1_[0][0], &x1_[0][0] + 2 * MAX_STAGES, 0.0f);
+    std::fill(&x2_[0][0], &x2_[0][0] + 2 * MAX_STAGES, 0.0f);
+    std::fill(&y1_[0][0], &y1_[0][0] + 2 * MAX_STAGES, 0.0f);
+    std::fill(&y2_[0][0], &y2_[0][0] + 2 * MAX_STAGES, 0.0f);
+}
+
+void NoteNagaBiquadCascade::process(float *left, float *right, size_t num_frames) {
+    if (num_stages_ == 0 || num_frames == 0) return;
+
+#if defined(NN_BIQUAD_SIMD)
+    // Single stage gains nothing from the lane pipeline
+    if (num_stages_ > 1) {
+        size_t num_groups = (num_stages_ + LANES - 1) / LANES;
+        size_t g = 0;
+        for (; g + 3 <= num_groups; g += 3) processGroups<3>(left, right, num_frames, g * LANES);
+        for (; g + 2 <= num_groups; g += 2) processGroups<2>(left, right, num_frames, g * LANES);
+        if (g < num_groups) processGroups<1>(left, right, num_frames, g * LANES);
+        return;
+    }
+#endif
+
+    for (size_t s = 0; s < num_stages_; ++s) {
+        NN_BiquadCoeffs_t c{b0_[s], b1_[s], b2_[s], a1_[s], a2_[s]};
+        NN_BiquadState_t state_l{x1_[0][s], x2_[0][s], y1_[0][s], y2_[0][s]};
+        NN_BiquadState_t state_r{x1_[1][s], x2_[1][s], y1_[1][s], y2_[1][s]};
+        for (size_t i = 0; i < num_frames; ++i) {
+            left[i] = state_l.process(c, left[i]);
+            right[i] = state_r.process(c, right[i]);
+        }
+        x1_[0][s] = state_l.x1;
+        x2_[0][s] = state_l.x2;
+        y1_[0][s] = state_l.y1;
+        y2_[0][s] = state_l.y2;
+        x1_[1][s] = state_r.x1;
+        x2_[1][s] = state_r.x2;
+        y1_[1][s] = state_r.y1;
+        y2_[1][s] = state_r.y2;
+    }
+}
+
+template <size_t G>
+void NoteNagaBiquadCascade::processGroups(float *left, float *right, size_t num_frames, size_t first_stage) {
+#if defined(NN_BIQUAD_SIMD)
+    // Group state of one channel
+    struct Lanes {
+        nn_f4 x1, x2, y1, y2;
+    };
+
+    nn_f4 b0[G], b1[G], b2[G], a1[G], a2[G];
+    Lanes st[2][G];
+    for (size_t g = 0; g < G; ++g) {
+        const size_t o = first_stage + g * LANES;
+        b0[g] = f4_load(b0_ + o);
+        b1[g] = f4_load(b1_ + o);
+        b2[g] = f4_load(b2_ + o);
+        a1[g] = f4_load(a1_ + o);
+        a2[g] = f4_load(a2_ + o);
+        for (int c = 0; c < 2; ++c) {
+            st[c][g] = {f4_load(x1_[c] + o), f4_load(x2_[c] + o), f4_load(y1_[c] + o),
+                        f4_load(y2_[c] + o)};
+        }
+    }
+
+    // Output of the last step, lanes of stages that had no sample yet hold garbage
+    nn_f4 prev[2][G];
+    for (int c = 0; c < 2; ++c)
+        for (size_t g = 0; g < G; ++g) prev[c][g] = f4_dup(0.0f);
+
+    // Step t: stage k of the pipeline processes sample t - k. Every group and channel
+    // only depends on results of the previous step, so all chains run in parallel.
+    float *data[2] = {left, right};
+    const size_t latency = G * LANES - 1;
+    const size_t total = num_frames + latency;
+    for (size_t t = 0; t < total; ++t) {
+        bool steady = t >= latency && t < num_frames;
+        for (int c = 0; c < 2; ++c) {
+            float in = t < num_frames ? data[c][t] : 0.0f;
+            for (size_t g = 0; g < G; ++g) {
+                // Input of a group is the last lane of the previous group (previous step)
+                nn_f4 x = f4_shift_in(prev[c][g], in);
+                in = f4_lane3(prev[c][g]);
+
+                Lanes &s = st[c][g];
+                nn_f4 ff = f4_add(f4_mul(b0[g], x), f4_add(f4_mul(b1[g], s.x1), f4_mul(b2[g], s.x2)));
+                nn_f4 y = f4_sub(ff, f4_add(f4_mul(a1[g], s.y1), f4_mul(a2[g], s.y2)));
+                prev[c][g] = y;
+                if (steady) {
+                    s.x2 = s.x1;
+                    s.x1 = x;
+                    s.y2 = s.y1;
+                    s.y1 = y;
+                } else {
+                    // Pipeline fill / drain, lanes without a sample keep their state
+                    float shift = float(g * LANES);
+                    float lo = float(t) - float(num_frames) - shift;
+                    float hi = float(t) - shift;
+                    s.x2 = f4_select_lanes(s.x1, s.x2, lo, hi);
+                    s.x1 = f4_select_lanes(x, s.x1, lo, hi);
+                    s.y2 = f4_select_lanes(s.y1, s.y2, lo, hi);
+                    s.y1 = f4_select_lanes(y, s.y1, lo, hi);
+                }
+            }
+            if (t >= latency) data[c][t - latency] = f4_lane3(prev[c][G - 1]);
+        }
+    }
+
+    for (size_t g = 0; g < G; ++g) {
+        const size_t o = first_stage + g * LANES;
+        for (int c = 0; c < 2; ++c) {
+            f4_store(x1_[c] + o, st[c][g].x1);
+            f4_store(x2_[c] + o, st[c][g].x2);
+            f4_store(y1_[c] + o, st[c][g].y1);
+            f4_store(y2_[c] + o, st[c][g].y2);
+        }
+    }
+#else
+    (void)left;
+    (void)right;
+    (void)num_frames;
+    (void)first_stage;
+#endif
+}
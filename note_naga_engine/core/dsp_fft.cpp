@@ -0,0 +1,196 @@
+#include <note_naga_engine/core/dsp_fft.h>
+
+#include <note_naga_engine/core/dsp_vector_math.h>
+
+#include <cmath>
+
+namespace {
+
+// Plain complex multiply, std::complex operator* checks for NaN / inf on every call
+inline std::complex<float> cmul(std::complex<float> a, std::complex<float> b) {
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+
+inline std::complex<float> cmul_conj(std::complex<float> a, std::complex<float> b) {
+    return {a.real() * b.real() + a.imag() * b.imag(), a.imag() * b.real() - a.real() * b.imag()};
+}
+
+} // namespace
+
+void NoteNagaFFT::setSize(size_t size) {
+    size_t n = 4;
+    while (n < size) n <<= 1;
+    size_ = n;
+
+    const size_t half = n / 2;
+    twiddles_.resize(half);
+    for (size_t k = 0; k < half; ++k) {
+        double ang = -2.0 * M_PI * double(k) / double(n);
+        twiddles_[k] = {float(std::cos(ang)), float(std::sin(ang))};
+    }
+
+    // Every twiddle is computed directly in double precision, no recurrence error
+    stage_re_.assign(half, 0.0f);
+    stage_im_.assign(half, 0.0f);
+    stage_im_inv_.assign(half, 0.0f);
+    for (size_t len = 2; len <= half; len <<= 1) {
+        const size_t half_len = len / 2;
+        for (size_t j = 0; j < half_len; ++j) {
+            double ang = -2.0 * M_PI * double(j) / double(len);
+            stage_re_[half_len - 1 + j] = float(std::cos(ang));
+            stage_im_[half_len - 1 + j] = float(std::sin(ang));
+            stage_im_inv_[half_len - 1 + j] = -float(std::sin(ang));
+        }
+    }
+
+    size_t bits = 0;
+    while ((size_t(1) << bits) < half) ++bits;
+    bitrev_.resize(half);
+    for (size_t i = 0; i < half; ++i) {
+        uint32_t r = 0;
+        for (size_t b = 0; b < bits; ++b) r |= uint32_t((i >> b) & 1u) << (bits - 1 - b);
+        bitrev_[i] = r;
+    }
+
+    work_re_.assign(half, 0.0f);
+    work_im_.assign(half, 0.0f);
+    spectrum_re_.assign(getNumBins(), 0.0f);
+    spectrum_im_.assign(getNumBins(), 0.0f);
+    setWindow(window_type_);
+}
+
+void NoteNagaFFT::setWindow(NN_FFTWindow_t window) {
+    window_type_ = window;
+    window_.clear();
+    if (window == NN_FFTWindow_t::Hann) {
+        window_.resize(size_);
+        for (size_t i = 0; i < size_; ++i) {
+            window_[i] = float(0.5 - 0.5 * std::cos(2.0 * M_PI * double(i) / double(size_)));
+        }
+    }
+}
+
+void NoteNagaFFT::transform(bool inverse) {
+    // Iterative radix-2, input is already in bit reversed order
+    const size_t m = work_re_.size();
+    float *re = work_re_.data();
+    float *im = work_im_.data();
+
+    // Stage of length 2, twiddle 1
+    for (size_t i = 0; i < m; i += 2) {
+        const float ur = re[i], ui = im[i];
+        const float vr = re[i + 1], vi = im[i + 1];
+        re[i] = ur + vr;
+        im[i] = ui + vi;
+        re[i + 1] = ur - vr;
+        im[i + 1] = ui - vi;
+    }
+
+    // Stage of length 4, twiddles 1 and -i (i for the inverse)
+    if (m >= 4) {
+        const float sign = inverse ? -1.0f : 1.0f;
+        for (size_t i = 0; i < m; i += 4) {
+            float ur = re[i], ui = im[i];
+            float vr = re[i + 2], vi = im[i + 2];
+            re[i] = ur + vr;
+            im[i] = ui + vi;
+            re[i + 2] = ur - vr;
+            im[i + 2] = ui - vi;
+
+            ur = re[i + 1];
+            ui = im[i + 1];
+            vr = sign * im[i + 3];
+            vi = -sign * re[i + 3];
+            re[i + 1] = ur + vr;
+            im[i + 1] = ui + vi;
+            re[i + 3] = ur - vr;
+            im[i + 3] = ui - vi;
+        }
+    }
+
+    // Larger stages, the twiddles of one stage are contiguous so the butterflies vectorize
+    const float *stage_im = inverse ? stage_im_inv_.data() : stage_im_.data();
+    for (size_t len = 8; len <= m; len <<= 1) {
+        const size_t half_len = len / 2;
+        const float *w_re = stage_re_.data() + half_len - 1;
+        const float *w_im = stage_im + half_len - 1;
+        for (size_t i = 0; i < m; i += len) {
+            nn_vec_fft_butterfly(re + i, im + i, re + i + half_len, im + i + half_len, w_re, w_im, half_len);
+        }
+    }
+}
+
+void NoteNagaFFT::splitSpectrum(float *re, float *im) const {
+    // Split the packed spectrum into the spectrum of the real signal
+    const size_t m = size_ / 2;
+    re[0] = work_re_[0] + work_im_[0];
+    im[0] = 0.0f;
+    re[m] = work_re_[0] - work_im_[0];
+    im[m] = 0.0f;
+    for (size_t k = 1; k < m; ++k) {
+        std::complex<float> a(work_re_[k], work_im_[k]);
+        std::complex<float> b(work_re_[m - k], -work_im_[m - k]);
+        std::complex<float> even = (a + b) * 0.5f;
+        std::complex<float> odd = (a - b) * 0.5f;
+        // X[k] = E[k] + W^k * O[k], where O[k] = odd / i
+        std::complex<float> odd_rot = cmul(std::complex<float>(odd.imag(), -odd.real()), twiddles_[k]);
+        re[k] = even.real() + odd_rot.real();
+        im[k] = even.imag() + odd_rot.imag();
+    }
+}
+
+void NoteNagaFFT::forwardReal(const float *in, float *re, float *im) {
+    // Pack even / odd samples as one complex signal of half length
+    const size_t m = size_ / 2;
+    for (size_t i = 0; i < m; ++i) {
+        work_re_[bitrev_[i]] = in[2 * i];
+        work_im_[bitrev_[i]] = in[2 * i + 1];
+    }
+    transform(false);
+    splitSpectrum(re, im);
+}
+
+void NoteNagaFFT::forwardRealWindowed(const float *in, float *re, float *im) {
+    if (window_.empty()) {
+        forwardReal(in, re, im);
+        return;
+    }
+    const size_t m = size_ / 2;
+    const float *w = window_.data();
+    for (size_t i = 0; i < m; ++i) {
+        work_re_[bitrev_[i]] = in[2 * i] * w[2 * i];
+        work_im_[bitrev_[i]] = in[2 * i + 1] * w[2 * i + 1];
+    }
+    transform(false);
+    splitSpectrum(re, im);
+}
+
+void NoteNagaFFT::magnitudes(const float *in, float *mag) {
+    forwardRealWindowed(in, spectrum_re_.data(), spectrum_im_.data());
+    const size_t bins = getNumBins();
+    for (size_t k = 0; k < bins; ++k) {
+        mag[k] = std::sqrt(spectrum_re_[k] * spectrum_re_[k] + spectrum_im_[k] * spectrum_im_[k]);
+    }
+}
+
+void NoteNagaFFT::inverseReal(const float *re, const float *im, float *out) {
+    const size_t m = size_ / 2;
+
+    // Rebuild the packed half length spectrum
+    for (size_t k = 0; k < m; ++k) {
+        std::complex<float> a(re[k], im[k]);
+        std::complex<float> b(re[m - k], -im[m - k]);
+        std::complex<float> even = (a + b) * 0.5f;
+        std::complex<float> odd = cmul_conj((a - b) * 0.5f, twiddles_[k]);
+        // Z[k] = E[k] + i * O[k]
+        work_re_[bitrev_[k]] = even.real() - odd.imag();
+        work_im_[bitrev_[k]] = even.imag() + odd.real();
+    }
+    transform(true);
+
+    const float scale = 1.0f / float(m);
+    for (size_t i = 0; i < m; ++i) {
+        out[2 * i] = work_re_[i] * scale;
+        out[2 * i + 1] = work_im_[i] * scale;
+    }
+}
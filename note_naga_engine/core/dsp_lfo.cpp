@@ -0,0 +1,46 @@
+#include <note_naga_engine/core/dsp_lfo.h>
+
+#include <array>
+#include <cmath>
+
+namespace {
+
+constexpr size_t TABLE_SIZE = 512;
+
+// One period of sine plus a guard point for the interpolation, built on first use
+const std::array<float, TABLE_SIZE + 1> &sine_table() {
+    static const std::array<float, TABLE_SIZE + 1> table = []() {
+        std::array<float, TABLE_SIZE + 1> t{};
+        for (size_t i = 0; i <= TABLE_SIZE; ++i) t[i] = float(std::sin(2.0 * M_PI * double(i) / double(TABLE_SIZE)));
+        return t;
+    }();
+    return table;
+}
+
+// Wrap a phase to [0, 1), x - floor(x) rounds to 1 for tiny negative x
+inline float wrap_phase(float turns) {
+    turns -= std::floor(turns);
+    return turns < 1.0f ? turns : 0.0f;
+}
+
+inline float sine_lookup(const std::array<float, TABLE_SIZE + 1> &table, float turns) {
+    const float pos = turns * float(TABLE_SIZE);
+    const size_t i = static_cast<size_t>(pos);
+    const float frac = pos - float(i);
+    return table[i] + (table[i + 1] - table[i]) * frac;
+}
+
+} // namespace
+
+void NoteNagaLFO::startSegment() {
+    const auto &table = sine_table();
+    phase_ = wrap_phase(phase_);
+    const float end = wrap_phase(phase_ + increment_ * float(CONTROL_FRAMES));
+
+    const float from = sine_lookup(table, phase_);
+    const float to = sine_lookup(table, end);
+    value_ = from;
+    slope_ = (to - from) / float(CONTROL_FRAMES);
+    phase_ = end;
+    countdown_ = CONTROL_FRAMES;
+}
@@ -0,0 +1,161 @@
+#include <note_naga_engine/core/dsp_oversampler.h>
+
+#include <note_naga_engine/core/dsp_vector_math.h>
+
+#include <cmath>
+
+namespace {
+
+// Nonzero taps on each side of the center tap for the stages at 2x, 4x and 8x
+constexpr size_t STAGE_HALF_TAPS[] = {16, 8, 4};
+// Kaiser window shape, about 80 dB stopband attenuation
+constexpr double KAISER_BETA = 8.0;
+
+// Modified Bessel function of the first kind, order 0 (power series)
+double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+} // namespace
+
+/*******************************************************************************************************/
+// Half-band stage
+/*******************************************************************************************************/
+
+// A half-band filter h[m] of length 4K - 1 has h[0] = 1/2 and h[m] = 0 for every other even m,
+// so only the 2K odd taps m = +-1, +-3, ... are stored: taps[K - 1 - j] = taps[K + j] = h[2j + 1].
+// Buffers keep 2K samples of history in front of the current block.
+void NoteNagaOversampler::Stage::setup(size_t halfTaps, size_t maxInputFrames) {
+    half = halfTaps;
+    taps.assign(2 * half, 0.0f);
+
+    // Windowed sinc, normalized for unity gain at DC (sum of the odd taps = 1/2)
+    const double support = double(2 * half);
+    double sum = 0.0;
+    for (size_t j = 0; j < half; ++j) {
+        const double m = double(2 * j + 1);
+        const double sinc = ((j & 1) ? -1.0 : 1.0) / (M_PI * m);
+        const double r = m / support;
+        const double window = bessel_i0(KAISER_BETA * std::sqrt(1.0 - r * r)) / bessel_i0(KAISER_BETA);
+        const double tap = sinc * window;
+        taps[half - 1 - j] = float(tap);
+        taps[half + j] = float(tap);
+        sum += 2.0 * tap;
+    }
+    for (float &tap : taps) tap = float(tap * (0.5 / sum));
+
+    const size_t history = 2 * half;
+    upHist.assign(history + maxInputFrames, 0.0f);
+    interp.assign(maxInputFrames, 0.0f);
+    downEven.assign(history + maxInputFrames, 0.0f);
+    downOdd.assign(history + maxInputFrames, 0.0f);
+}
+
+void NoteNagaOversampler::Stage::clear() {
+    std::fill(upHist.begin(), upHist.end(), 0.0f);
+    std::fill(downEven.begin(), downEven.end(), 0.0f);
+    std::fill(downOdd.begin(), downOdd.end(), 0.0f);
+}
+
+void NoteNagaOversampler::Stage::upsample(const float *in, float *out, size_t n) {
+    const size_t history = 2 * half;
+    float *x = upHist.data();
+    std::copy(in, in + n, x + history);
+
+    // Even outputs are the input delayed by K (center tap), odd outputs are interpolated
+    // halfway between, both scaled by 2 to keep the gain of the zero stuffed signal
+    float *odd = interp.data();
+    std::fill(odd, odd + n, 0.0f);
+    for (size_t i = 0; i < history; ++i) nn_vec_mul_add(odd, x + 1 + i, 2.0f * taps[i], n);
+    nn_vec_interleave(out, x + half, odd, n);
+
+    std::copy(x + n, x + n + history, x);
+}
+
+void NoteNagaOversampler::Stage::downsample(const float *in, float *out, size_t n) {
+    const size_t history = 2 * half;
+    float *even = downEven.data();
+    float *odd = downOdd.data();
+    for (size_t i = 0; i < n; ++i) {
+        even[history + i] = in[2 * i];
+        odd[history + i] = in[2 * i + 1];
+    }
+
+    // Center tap on the even phase, all other nonzero taps on the odd phase
+    for (size_t i = 0; i < n; ++i) out[i] = 0.5f * even[half + i];
+    for (size_t i = 0; i < history; ++i) nn_vec_mul_add(out, odd + i, taps[i], n);
+
+    std::copy(even + n, even + n + history, even);
+    std::copy(odd + n, odd + n + history, odd);
+}
+
+/*******************************************************************************************************/
+// Oversampler
+/*******************************************************************************************************/
+
+void NoteNagaOversampler::prepare(size_t maxBlockFrames) {
+    maxFrames_ = std::max<size_t>(maxBlockFrames, 1);
+    for (int s = 0; s < MAX_STAGES; ++s) {
+        const size_t stageInput = maxFrames_ << s;
+        for (int c = 0; c < 2; ++c) {
+            stages_[s][c].setup(STAGE_HALF_TAPS[s], stageInput);
+            buffers_[s][c].assign(2 * stageInput, 0.0f);
+        }
+    }
+}
+
+void NoteNagaOversampler::setFactor(int factor) {
+    int stages = 0;
+    while (stages < MAX_STAGES && (2 << stages) <= factor) ++stages;
+    if (stages == numStages_) return;
+    numStages_ = stages;
+    factor_ = 1 << stages;
+    reset();
+}
+
+size_t NoteNagaOversampler::getLatencyFrames() const {
+    return latencyForFactor(factor_);
+}
+
+size_t NoteNagaOversampler::latencyForFactor(int factor) {
+    // Each stage delays by K samples of its input rate going up and K going down
+    size_t latency = 0;
+    for (int s = 0; s < MAX_STAGES && (2 << s) <= factor; ++s) latency += (2 * STAGE_HALF_TAPS[s]) >> s;
+    return latency;
+}
+
+void NoteNagaOversampler::reset() {
+    for (auto &stage : stages_) {
+        stage[0].clear();
+        stage[1].clear();
+    }
+}
+
+void NoteNagaOversampler::upsample(const float *left, const float *right, size_t numFrames) {
+    const float *in[2] = {left, right};
+    for (int c = 0; c < 2; ++c) {
+        size_t n = numFrames;
+        for (int s = 0; s < numStages_; ++s) {
+            float *out = buffers_[s][c].data();
+            stages_[s][c].upsample(in[c], out, n);
+            in[c] = out;
+            n *= 2;
+        }
+    }
+}
+
+void NoteNagaOversampler::downsample(float *left, float *right, size_t numFrames) {
+    float *out[2] = {left, right};
+    for (int c = 0; c < 2; ++c) {
+        for (int s = numStages_ - 1; s >= 0; --s) {
+            const size_t n = numFrames << s;
+            float *dst = s > 0 ? buffers_[s - 1][c].data() : out[c];
+            stages_[s][c].downsample(buffers_[s][c].data(), dst, n);
+        }
+    }
+}
@@ -0,0 +1,120 @@
+#include <note_naga_engine/core/dsp_thread_pool.h>
+
+#include <note_naga_engine/core/dsp_denormals.h>
+#include <note_naga_engine/logger.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define NN_CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define NN_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+#define NN_CPU_RELAX() std::this_thread::yield()
+#endif
+
+// Number of polls a worker spins before it goes to sleep
+static constexpr int WORKER_SPIN_COUNT = 4000;
+// Upper bound of a missed wake-up (notify is not synchronized with the mutex)
+static constexpr std::chrono::milliseconds WORKER_SLEEP_TIMEOUT(5);
+
+NoteNagaDSPThreadPool::NoteNagaDSPThreadPool(size_t num_workers) {
+    if (num_workers == 0) {
+        unsigned int hw = std::thread::hardware_concurrency();
+        num_workers = hw > 1 ? std::min<size_t>(hw - 1, 7) : 0;
+    }
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers_.emplace_back([this]() { this->workerLoop(); });
+    }
+    NOTE_NAGA_LOG_INFO("DSP thread pool initialized with " + std::to_string(num_workers) +
+                       " workers");
+}
+
+NoteNagaDSPThreadPool::~NoteNagaDSPThreadPool() {
+    stop_.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_cv_.notify_all();
+    }
+    for (auto &worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void NoteNagaDSPThreadPool::run(JobFunc func, void *context, size_t num_jobs) {
+    if (num_jobs == 0 || !func) return;
+
+    // Nothing to parallelize, run inline
+    if (workers_.empty() || num_jobs == 1) {
+        for (size_t i = 0; i < num_jobs; ++i)
+            func(context, i);
+        return;
+    }
+
+    uint32_t gen = ++generation_;
+    JobSlot &slot = slots_[gen & 1];
+    slot.func.store(func, std::memory_order_relaxed);
+    slot.context.store(context, std::memory_order_relaxed);
+    slot.num_jobs.store(uint32_t(num_jobs), std::memory_order_relaxed);
+    remaining_.store(uint32_t(num_jobs), std::memory_order_relaxed);
+    state_.store(uint64_t(gen) << 32, std::memory_order_release);
+
+    // notify without the mutex, the audio thread must never block on it
+    wake_cv_.notify_all();
+
+    // calling thread takes part in the work
+    processJobs(gen);
+
+    // wait for jobs claimed by workers
+    while (remaining_.load(std::memory_order_acquire) != 0) {
+        NN_CPU_RELAX();
+    }
+}
+
+void NoteNagaDSPThreadPool::processJobs(uint32_t generation) {
+    JobSlot &slot = slots_[generation & 1];
+    for (;;) {
+        uint64_t s = state_.load(std::memory_order_acquire);
+        if (uint32_t(s >> 32) != generation) return;
+        uint32_t idx = uint32_t(s & 0xFFFFFFFFu);
+        if (idx >= slot.num_jobs.load(std::memory_order_relaxed)) return;
+        if (!state_.compare_exchange_weak(s, s + 1, std::memory_order_acq_rel,
+                                          std::memory_order_relaxed))
+            continue;
+
+        // successful claim guarantees the slot belongs to this generation
+        JobFunc func = slot.func.load(std::memory_order_relaxed);
+        func(slot.context.load(std::memory_order_relaxed), idx);
+        remaining_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+void NoteNagaDSPThreadPool::workerLoop() {
+    // Workers render synth chains like the audio thread, same floating point mode
+    NoteNagaScopedNoDenormals no_denormals;
+    uint32_t seen = 0;
+    while (!stop_.load(std::memory_order_acquire)) {
+        // short spin, audio blocks usually follow each other closely
+        uint32_t gen = seen;
+        for (int i = 0; i < WORKER_SPIN_COUNT; ++i) {
+            gen = uint32_t(state_.load(std::memory_order_acquire) >> 32);
+            if (gen != seen || stop_.load(std::memory_order_relaxed)) break;
+            NN_CPU_RELAX();
+        }
+
+        if (gen != seen) {
+            seen = gen;
+            processJobs(gen);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait_for(lock, WORKER_SLEEP_TIMEOUT, [this, seen]() {
+            return stop_.load(std::memory_order_acquire) ||
+                   uint32_t(state_.load(std::memory_order_acquire) >> 32) != seen;
+        });
+    }
+}
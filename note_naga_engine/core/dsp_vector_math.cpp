@@ -0,0 +1,500 @@
+#include <note_naga_engine/core/dsp_vector_math.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NN_VEC_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define NN_VEC_TARGET_AVX2
+#else
+#define NN_VEC_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#define NN_VEC_NEON 1
+#include <arm_neon.h>
+#endif
+
+/*******************************************************************************************************/
+// Scalar kernels (fallback and tails of the SIMD kernels)
+/*******************************************************************************************************/
+
+static void add_scalar(float *dst, const float *src, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] += src[i];
+}
+
+static void scale_scalar(float *dst, float gain, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] *= gain;
+}
+
+static void mul_add_scalar(float *dst, const float *src, float gain, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] += src[i] * gain;
+}
+
+static void interleave_scalar(float *out, const float *left, const float *right, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[2 * i] = left[i];
+        out[2 * i + 1] = right[i];
+    }
+}
+
+static void stereo_matrix_scalar(float *left, float *right, float ll, float rl, float lr, float rr,
+                                 size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        float l = left[i], r = right[i];
+        left[i] = l * ll + r * rl;
+        right[i] = l * lr + r * rr;
+    }
+}
+
+static float abs_max_scalar(const float *src, size_t n) {
+    float peak = 0.0f;
+    for (size_t i = 0; i < n; ++i) peak = std::max(peak, std::fabs(src[i]));
+    return peak;
+}
+
+static float sum_squares_scalar(const float *src, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) sum += src[i] * src[i];
+    return sum;
+}
+
+static void complex_mul_add_scalar(float *acc_re, float *acc_im, const float *a_re, const float *a_im,
+                                   const float *b_re, const float *b_im, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        acc_re[i] += a_re[i] * b_re[i] - a_im[i] * b_im[i];
+        acc_im[i] += a_re[i] * b_im[i] + a_im[i] * b_re[i];
+    }
+}
+
+static void fft_butterfly_scalar(float *a_re, float *a_im, float *b_re, float *b_im, const float *w_re,
+                                 const float *w_im, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        float v_re = b_re[i] * w_re[i] - b_im[i] * w_im[i];
+        float v_im = b_re[i] * w_im[i] + b_im[i] * w_re[i];
+        b_re[i] = a_re[i] - v_re;
+        b_im[i] = a_im[i] - v_im;
+        a_re[i] += v_re;
+        a_im[i] += v_im;
+    }
+}
+
+/*******************************************************************************************************/
+// SSE2 / AVX2 kernels
+/*******************************************************************************************************/
+
+#if defined(NN_VEC_X86)
+
+static void add_sse2(float *dst, const float *src, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+    add_scalar(dst + i, src + i, n - i);
+}
+
+static void scale_sse2(float *dst, float gain, size_t n) {
+    __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(dst + i), g));
+    scale_scalar(dst + i, gain, n - i);
+}
+
+static void mul_add_sse2(float *dst, const float *src, float gain, size_t n) {
+    __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(dst + i,
+                      _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+    mul_add_scalar(dst + i, src + i, gain, n - i);
+}
+
+static void interleave_sse2(float *out, const float *left, const float *right, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 l = _mm_loadu_ps(left + i);
+        __m128 r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+    interleave_scalar(out + 2 * i, left + i, right + i, n - i);
+}
+
+static void stereo_matrix_sse2(float *left, float *right, float ll, float rl, float lr, float rr,
+                               size_t n) {
+    __m128 vll = _mm_set1_ps(ll), vrl = _mm_set1_ps(rl);
+    __m128 vlr = _mm_set1_ps(lr), vrr = _mm_set1_ps(rr);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 l = _mm_loadu_ps(left + i);
+        __m128 r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(left + i, _mm_add_ps(_mm_mul_ps(l, vll), _mm_mul_ps(r, vrl)));
+        _mm_storeu_ps(right + i, _mm_add_ps(_mm_mul_ps(l, vlr), _mm_mul_ps(r, vrr)));
+    }
+    stereo_matrix_scalar(left + i, right + i, ll, rl, lr, rr, n - i);
+}
+
+static float abs_max_sse2(const float *src, size_t n) {
+    const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 peak = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) peak = _mm_max_ps(peak, _mm_and_ps(_mm_loadu_ps(src + i), mask));
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, peak);
+    float result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    return std::max(result, abs_max_scalar(src + i, n - i));
+}
+
+static float sum_squares_sse2(const float *src, size_t n) {
+    __m128 sum = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 x = _mm_loadu_ps(src + i);
+        sum = _mm_add_ps(sum, _mm_mul_ps(x, x));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, sum);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sum_squares_scalar(src + i, n - i);
+}
+
+static void complex_mul_add_sse2(float *acc_re, float *acc_im, const float *a_re, const float *a_im,
+                                 const float *b_re, const float *b_im, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 ar = _mm_loadu_ps(a_re + i), ai = _mm_loadu_ps(a_im + i);
+        __m128 br = _mm_loadu_ps(b_re + i), bi = _mm_loadu_ps(b_im + i);
+        __m128 re = _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi));
+        __m128 im = _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br));
+        _mm_storeu_ps(acc_re + i, _mm_add_ps(_mm_loadu_ps(acc_re + i), re));
+        _mm_storeu_ps(acc_im + i, _mm_add_ps(_mm_loadu_ps(acc_im + i), im));
+    }
+    complex_mul_add_scalar(acc_re + i, acc_im + i, a_re + i, a_im + i, b_re + i, b_im + i, n - i);
+}
+
+static void fft_butterfly_sse2(float *a_re, float *a_im, float *b_re, float *b_im, const float *w_re,
+                               const float *w_im, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 br = _mm_loadu_ps(b_re + i), bi = _mm_loadu_ps(b_im + i);
+        __m128 wr = _mm_loadu_ps(w_re + i), wi = _mm_loadu_ps(w_im + i);
+        __m128 vr = _mm_sub_ps(_mm_mul_ps(br, wr), _mm_mul_ps(bi, wi));
+        __m128 vi = _mm_add_ps(_mm_mul_ps(br, wi), _mm_mul_ps(bi, wr));
+        __m128 ar = _mm_loadu_ps(a_re + i), ai = _mm_loadu_ps(a_im + i);
+        _mm_storeu_ps(b_re + i, _mm_sub_ps(ar, vr));
+        _mm_storeu_ps(b_im + i, _mm_sub_ps(ai, vi));
+        _mm_storeu_ps(a_re + i, _mm_add_ps(ar, vr));
+        _mm_storeu_ps(a_im + i, _mm_add_ps(ai, vi));
+    }
+    fft_butterfly_scalar(a_re + i, a_im + i, b_re + i, b_im + i, w_re + i, w_im + i, n - i);
+}
+
+NN_VEC_TARGET_AVX2 static void add_avx2(float *dst, const float *src, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_loadu_ps(src + i)));
+    add_sse2(dst + i, src + i, n - i);
+}
+
+NN_VEC_TARGET_AVX2 static void scale_avx2(float *dst, float gain, size_t n) {
+    __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(dst + i), g));
+    scale_sse2(dst + i, gain, n - i);
+}
+
+NN_VEC_TARGET_AVX2 static void mul_add_avx2(float *dst, const float *src, float gain, size_t n) {
+    __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(_mm256_loadu_ps(src + i), g, _mm256_loadu_ps(dst + i)));
+    mul_add_sse2(dst + i, src + i, gain, n - i);
+}
+
+NN_VEC_TARGET_AVX2 static void interleave_avx2(float *out, const float *left, const float *right,
+                                               size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 l = _mm256_loadu_ps(left + i);
+        __m256 r = _mm256_loadu_ps(right + i);
+        // unpack works per 128-bit lane, permute restores frame order
+        __m256 lo = _mm256_unpacklo_ps(l, r);
+        __m256 hi = _mm256_unpackhi_ps(l, r);
+        _mm256_storeu_ps(out + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(out + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    interleave_sse2(out + 2 * i, left + i, right + i, n - i);
+}
+
+NN_VEC_TARGET_AVX2 static void stereo_matrix_avx2(float *left, float *right, float ll, float rl,
+                                                  float lr, float rr, size_t n) {
+    __m256 vll = _mm256_set1_ps(ll), vrl = _mm256_set1_ps(rl);
+    __m256 vlr = _mm256_set1_ps(lr), vrr = _mm256_set1_ps(rr);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 l = _mm256_loadu_ps(left + i);
+        __m256 r = _mm256_loadu_ps(right + i);
+        _mm256_storeu_ps(left + i, _mm256_fmadd_ps(l, vll, _mm256_mul_ps(r, vrl)));
+        _mm256_storeu_ps(right + i, _mm256_fmadd_ps(l, vlr, _mm256_mul_ps(r, vrr)));
+    }
+    stereo_matrix_sse2(left + i, right + i, ll, rl, lr, rr, n - i);
+}
+
+NN_VEC_TARGET_AVX2 static float abs_max_avx2(const float *src, size_t n) {
+    const __m256 mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 peak = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        peak = _mm256_max_ps(peak, _mm256_and_ps(_mm256_loadu_ps(src + i), mask));
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, peak);
+    float result = abs_max_sse2(src + i, n - i);
+    for (float lane : lanes) result = std::max(result, lane);
+    return result;
+}
+
+NN_VEC_TARGET_AVX2 static float sum_squares_avx2(const float *src, size_t n) {
+    __m256 sum = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(src + i);
+        sum = _mm256_fmadd_ps(x, x, sum);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, sum);
+    float result = sum_squares_sse2(src + i, n - i);
+    for (float lane : lanes) result += lane;
+    return result;
+}
+
+NN_VEC_TARGET_AVX2 static void complex_mul_add_avx2(float *acc_re, float *acc_im, const float *a_re,
+                                                    const float *a_im, const float *b_re, const float *b_im,
+                                                    size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 ar = _mm256_loadu_ps(a_re + i), ai = _mm256_loadu_ps(a_im + i);
+        __m256 br = _mm256_loadu_ps(b_re + i), bi = _mm256_loadu_ps(b_im + i);
+        __m256 re = _mm256_fmadd_ps(ar, br, _mm256_loadu_ps(acc_re + i));
+        __m256 im = _mm256_fmadd_ps(ar, bi, _mm256_loadu_ps(acc_im + i));
+        _mm256_storeu_ps(acc_re + i, _mm256_fnmadd_ps(ai, bi, re));
+        _mm256_storeu_ps(acc_im + i, _mm256_fmadd_ps(ai, br, im));
+    }
+    complex_mul_add_sse2(acc_re + i, acc_im + i, a_re + i, a_im + i, b_re + i, b_im + i, n - i);
+}
+
+NN_VEC_TARGET_AVX2 static void fft_butterfly_avx2(float *a_re, float *a_im, float *b_re, float *b_im,
+                                                  const float *w_re, const float *w_im, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 br = _mm256_loadu_ps(b_re + i), bi = _mm256_loadu_ps(b_im + i);
+        __m256 wr = _mm256_loadu_ps(w_re + i), wi = _mm256_loadu_ps(w_im + i);
+        __m256 vr = _mm256_fmsub_ps(br, wr, _mm256_mul_ps(bi, wi));
+        __m256 vi = _mm256_fmadd_ps(br, wi, _mm256_mul_ps(bi, wr));
+        __m256 ar = _mm256_loadu_ps(a_re + i), ai = _mm256_loadu_ps(a_im + i);
+        _mm256_storeu_ps(b_re + i, _mm256_sub_ps(ar, vr));
+        _mm256_storeu_ps(b_im + i, _mm256_sub_ps(ai, vi));
+        _mm256_storeu_ps(a_re + i, _mm256_add_ps(ar, vr));
+        _mm256_storeu_ps(a_im + i, _mm256_add_ps(ai, vi));
+    }
+    fft_butterfly_sse2(a_re + i, a_im + i, b_re + i, b_im + i, w_re + i, w_im + i, n - i);
+}
+
+static bool cpu_has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool fma = (info[2] & (1 << 12)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!fma || !osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+#endif // NN_VEC_X86
+
+/*******************************************************************************************************/
+// NEON kernels
+/*******************************************************************************************************/
+
+#if defined(NN_VEC_NEON)
+
+static void add_neon(float *dst, const float *src, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+    add_scalar(dst + i, src + i, n - i);
+}
+
+static void scale_neon(float *dst, float gain, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(dst + i), gain));
+    scale_scalar(dst + i, gain, n - i);
+}
+
+static void mul_add_neon(float *dst, const float *src, float gain, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), gain));
+    mul_add_scalar(dst + i, src + i, gain, n - i);
+}
+
+static void interleave_neon(float *out, const float *left, const float *right, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4x2_t lr;
+        lr.val[0] = vld1q_f32(left + i);
+        lr.val[1] = vld1q_f32(right + i);
+        vst2q_f32(out + 2 * i, lr);
+    }
+    interleave_scalar(out + 2 * i, left + i, right + i, n - i);
+}
+
+static void stereo_matrix_neon(float *left, float *right, float ll, float rl, float lr, float rr,
+                               size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t l = vld1q_f32(left + i);
+        float32x4_t r = vld1q_f32(right + i);
+        vst1q_f32(left + i, vmlaq_n_f32(vmulq_n_f32(l, ll), r, rl));
+        vst1q_f32(right + i, vmlaq_n_f32(vmulq_n_f32(l, lr), r, rr));
+    }
+    stereo_matrix_scalar(left + i, right + i, ll, rl, lr, rr, n - i);
+}
+
+static float abs_max_neon(const float *src, size_t n) {
+    float32x4_t peak = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) peak = vmaxq_f32(peak, vabsq_f32(vld1q_f32(src + i)));
+    float lanes[4];
+    vst1q_f32(lanes, peak);
+    float result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    return std::max(result, abs_max_scalar(src + i, n - i));
+}
+
+static float sum_squares_neon(const float *src, size_t n) {
+    float32x4_t sum = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t x = vld1q_f32(src + i);
+        sum = vmlaq_f32(sum, x, x);
+    }
+    float lanes[4];
+    vst1q_f32(lanes, sum);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sum_squares_scalar(src + i, n - i);
+}
+
+static void complex_mul_add_neon(float *acc_re, float *acc_im, const float *a_re, const float *a_im,
+                                 const float *b_re, const float *b_im, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t ar = vld1q_f32(a_re + i), ai = vld1q_f32(a_im + i);
+        float32x4_t br = vld1q_f32(b_re + i), bi = vld1q_f32(b_im + i);
+        float32x4_t re = vmlaq_f32(vld1q_f32(acc_re + i), ar, br);
+        float32x4_t im = vmlaq_f32(vld1q_f32(acc_im + i), ar, bi);
+        vst1q_f32(acc_re + i, vmlsq_f32(re, ai, bi));
+        vst1q_f32(acc_im + i, vmlaq_f32(im, ai, br));
+    }
+    complex_mul_add_scalar(acc_re + i, acc_im + i, a_re + i, a_im + i, b_re + i, b_im + i, n - i);
+}
+
+static void fft_butterfly_neon(float *a_re, float *a_im, float *b_re, float *b_im, const float *w_re,
+                               const float *w_im, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t br = vld1q_f32(b_re + i), bi = vld1q_f32(b_im + i);
+        float32x4_t wr = vld1q_f32(w_re + i), wi = vld1q_f32(w_im + i);
+        float32x4_t vr = vmlsq_f32(vmulq_f32(br, wr), bi, wi);
+        float32x4_t vi = vmlaq_f32(vmulq_f32(br, wi), bi, wr);
+        float32x4_t ar = vld1q_f32(a_re + i), ai = vld1q_f32(a_im + i);
+        vst1q_f32(b_re + i, vsubq_f32(ar, vr));
+        vst1q_f32(b_im + i, vsubq_f32(ai, vi));
+        vst1q_f32(a_re + i, vaddq_f32(ar, vr));
+        vst1q_f32(a_im + i, vaddq_f32(ai, vi));
+    }
+    fft_butterfly_scalar(a_re + i, a_im + i, b_re + i, b_im + i, w_re + i, w_im + i, n - i);
+}
+
+#endif // NN_VEC_NEON
+
+/*******************************************************************************************************/
+// Runtime dispatch
+/*******************************************************************************************************/
+
+namespace {
+
+struct VectorKernels {
+    const char *isa;
+    void (*add)(float *, const float *, size_t);
+    void (*scale)(float *, float, size_t);
+    void (*mul_add)(float *, const float *, float, size_t);
+    void (*interleave)(float *, const float *, const float *, size_t);
+    void (*stereo_matrix)(float *, float *, float, float, float, float, size_t);
+    float (*abs_max)(const float *, size_t);
+    float (*sum_squares)(const float *, size_t);
+    void (*complex_mul_add)(float *, float *, const float *, const float *, const float *, const float *, size_t);
+    void (*fft_butterfly)(float *, float *, float *, float *, const float *, const float *, size_t);
+};
+
+VectorKernels selectKernels() {
+#if defined(NN_VEC_X86)
+    if (cpu_has_avx2()) {
+        return {"avx2", add_avx2, scale_avx2, mul_add_avx2, interleave_avx2,
+                stereo_matrix_avx2, abs_max_avx2, sum_squares_avx2, complex_mul_add_avx2,
+                fft_butterfly_avx2};
+    }
+    return {"sse2", add_sse2, scale_sse2, mul_add_sse2, interleave_sse2,
+            stereo_matrix_sse2, abs_max_sse2, sum_squares_sse2, complex_mul_add_sse2,
+            fft_butterfly_sse2};
+#elif defined(NN_VEC_NEON)
+    return {"neon", add_neon, scale_neon, mul_add_neon, interleave_neon,
+            stereo_matrix_neon, abs_max_neon, sum_squares_neon, complex_mul_add_neon,
+            fft_butterfly_neon};
+#else
+    return {"scalar", add_scalar, scale_scalar, mul_add_scalar, interleave_scalar,
+            stereo_matrix_scalar, abs_max_scalar, sum_squares_scalar, complex_mul_add_scalar,
+            fft_butterfly_scalar};
+#endif
+}
+
+// Selected once on first use (thread-safe static initialization)
+const VectorKernels &getKernels() {
+    static const VectorKernels kernels = selectKernels();
+    return kernels;
+}
+
+} // namespace
+
+void nn_vec_add(float *dst, const float *src, size_t n) { getKernels().add(dst, src, n); }
+
+void nn_vec_scale(float *dst, float gain, size_t n) { getKernels().scale(dst, gain, n); }
+
+void nn_vec_mul_add(float *dst, const float *src, float gain, size_t n) {
+    getKernels().mul_add(dst, src, gain, n);
+}
+
+void nn_vec_interleave(float *out, const float *left, const float *right, size_t n) {
+    getKernels().interleave(out, left, right, n);
+}
+
+void nn_vec_stereo_matrix(float *left, float *right, float ll, float rl, float lr, float rr, size_t n) {
+    getKernels().stereo_matrix(left, right, ll, rl, lr, rr, n);
+}
+
+float nn_vec_abs_max(const float *src, size_t n) { return getKernels().abs_max(src, n); }
+
+float nn_vec_sum_squares(const float *src, size_t n) { return getKernels().sum_squares(src, n); }
+
+void nn_vec_complex_mul_add(float *acc_re, float *acc_im, const float *a_re, const float *a_im,
+                            const float *b_re, const float *b_im, size_t n) {
+    getKernels().complex_mul_add(acc_re, acc_im, a_re, a_im, b_re, b_im, n);
+}
+
+void nn_vec_fft_butterfly(float *a_re, float *a_im, float *b_re, float *b_im, const float *w_re,
+                          const float *w_im, size_t n) {
+    getKernels().fft_butterfly(a_re, a_im, b_re, b_im, w_re, w_im, n);
+}
+
+const char *nn_vec_get_isa() { return getKernels().isa; }
@@ -807,36 +807,3 @@ double nn_ticks_to_seconds(int ticks, int ppq, int tempo) {
   double us_per_tick = double(tempo) / double(ppq);
   return ticks * us_per_tick / 1'000'000.0;
 }
-
-/*******************************************************************************************************/
-// Audio Analysis Utils
-/*******************************************************************************************************/
-
-void nn_fft(std::vector<std::complex<float>> &a) {
-  const size_t N = a.size();
-  size_t j = 0;
-  for (size_t i = 1; i < N; ++i) {
-    size_t bit = N >> 1;
-    while (j & bit) {
-      j ^= bit;
-      bit >>= 1;
-    }
-    j ^= bit;
-    if (i < j)
-      std::swap(a[i], a[j]);
-  }
-  for (size_t len = 2; len <= N; len <<= 1) {
-    float ang = -2 * M_PI / len;
-    std::complex<float> wlen(cosf(ang), sinf(ang));
-    for (size_t i = 0; i < N; i += len) {
-      std::complex<float> w(1);
-      for (size_t j = 0; j < len / 2; ++j) {
-        auto u = a[i + j];
-        auto v = a[i + j + len / 2] * w;
-        a[i + j] = u + v;
-        a[i + j + len / 2] = u - v;
-        w *= wlen;
-      }
-    }
-  }
-}
\ No newline at end of file
@@ -3,48 +3,80 @@
 #include <cmath>
 #include <algorithm>
 
+// Length of the mix ramp after a parameter change (base rate frames)
+static constexpr size_t PARAM_RAMP_FRAMES = 512;
+
 DSPBlockBitcrusher::DSPBlockBitcrusher(float bitDepth, int sampleRateReduce, float mix)
-    : bitDepth_(bitDepth), sampleRateReduce_(sampleRateReduce), mix_(mix)
-{}
+{
+    params_.set(0, bitDepth);
+    params_.set(1, static_cast<float>(sampleRateReduce));
+    params_.set(2, mix);
+    params_.set(3, 0.0f);
+    prepare(NN_DSP_DEFAULT_SAMPLE_RATE, NN_DSP_DEFAULT_BLOCK_FRAMES);
+}
+
+void DSPBlockBitcrusher::prepare(float /*sampleRate*/, size_t maxBlockFrames) {
+    oversampler_.prepare(maxBlockFrames);
+    updateParams(0);
+}
+
+size_t DSPBlockBitcrusher::getLatencySamples() const {
+    return latencySamples_.load(std::memory_order_relaxed);
+}
+
+void DSPBlockBitcrusher::updateParams(size_t rampFrames) {
+    if (!params_.consume()) return;
+    // The factor and the reported latency change together at the block boundary
+    quality_ = std::clamp(static_cast<int>(params_.get(3)), 0, 3);
+    oversampler_.setFactor(1 << quality_);
+    latencySamples_.store(NoteNagaOversampler::latencyForFactor(1 << quality_), std::memory_order_relaxed);
+
+    // Bit depth and rate are stepped by nature, only the mix ramps (at the oversampled rate)
+    bitDepth_ = params_.get(0);
+    sampleRateReduce_ = std::max(1, static_cast<int>(params_.get(1)));
+    mix_.setTarget(params_.get(2), rampFrames * oversampler_.getFactor());
+}
 
 void DSPBlockBitcrusher::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
+    updateParams(PARAM_RAMP_FRAMES);
 
-    float levels = std::pow(2.0f, bitDepth_);
-    for (size_t i = 0; i < numFrames; ++i) {
-        if (step_ == 0) {
-            // Quantize
-            lastL_ = std::round(left[i] * levels) / levels;
-            lastR_ = std::round(right[i] * levels) / levels;
-        }
-        left[i]  = left[i]  * (1.0f - mix_) + lastL_ * mix_;
-        right[i] = right[i] * (1.0f - mix_) + lastR_ * mix_;
+    const float levels = std::pow(2.0f, bitDepth_);
+    const bool smoothing = mix_.isSmoothing();
+    float mix = mix_.getCurrent();
+    // Hold each sample for the same time at any oversampling factor
+    const int hold = sampleRateReduce_ * oversampler_.getFactor();
+    oversampler_.process(left, right, numFrames, [&](float* l, float* r, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            if (smoothing) mix = mix_.next();
+            if (step_ == 0) {
+                // Quantize
+                lastL_ = std::round(l[i] * levels) / levels;
+                lastR_ = std::round(r[i] * levels) / levels;
+            }
+            l[i] = l[i] * (1.0f - mix) + lastL_ * mix;
+            r[i] = r[i] * (1.0f - mix) + lastR_ * mix;
 
-        step_ = (step_ + 1) % std::max(1, sampleRateReduce_);
-    }
+            step_ = (step_ + 1) % hold;
+        }
+    });
 }
 
 std::vector<DSPParamDescriptor> DSPBlockBitcrusher::getParamDescriptors() {
     return {
         { "Bit Depth", DSPParamType::Float, DSControlType::Dial, 4.0f, 16.0f, 8.0f },
         { "Rate Reduce", DSPParamType::Int, DSControlType::Dial, 1.0f, 32.0f, 8.0f },
-        { "Mix", DSPParamType::Float, DSControlType::DialCentered, 0.0f, 1.0f, 1.0f }
+        { "Mix", DSPParamType::Float, DSControlType::DialCentered, 0.0f, 1.0f, 1.0f },
+        { "Quality", DSPParamType::Int, DSControlType::Dial, 0.0f, 3.0f, 0.0f, {"Off", "2x", "4x", "8x"} }
     };
 }
 
 float DSPBlockBitcrusher::getParamValue(size_t idx) const {
-    switch (idx) {
-        case 0: return bitDepth_;
-        case 1: return static_cast<float>(sampleRateReduce_);
-        case 2: return mix_;
-        default: return 0.0f;
-    }
+    return params_.get(idx);
 }
 
 void DSPBlockBitcrusher::setParamValue(size_t idx, float value) {
-    switch (idx) {
-        case 0: bitDepth_ = value; break;
-        case 1: sampleRateReduce_ = std::max(1, static_cast<int>(value)); break;
-        case 2: mix_ = value; break;
-    }
-}
\ No newline at end of file
+    if (idx == 1) value = static_cast<float>(std::max(1, static_cast<int>(value)));
+    if (idx == 3) value = static_cast<float>(std::clamp(static_cast<int>(value), 0, 3));
+    params_.set(idx, value);
+}
@@ -2,15 +2,56 @@
 
 #include <cmath>
 
+// Length of the makeup gain ramp after a parameter change
+static constexpr size_t PARAM_RAMP_FRAMES = 512;
+
+DSPBlockCompressor::DSPBlockCompressor(float threshold, float ratio, float attack, float release, float makeup) {
+    params_.set(0, threshold);
+    params_.set(1, ratio);
+    params_.set(2, attack);
+    params_.set(3, release);
+    params_.set(4, makeup);
+    updateParams();
+    makeup_.reset(dB_to_linear(makeup_db_));
+}
+
+void DSPBlockCompressor::updateParams() {
+    uint64_t changed = params_.consume();
+    if (!changed) return;
+
+    threshold_db_ = params_.get(0);
+    ratio_ = params_.get(1);
+    attack_ms_ = params_.get(2);
+    release_ms_ = params_.get(3);
+    makeup_db_ = params_.get(4);
+
+    // Coefficients are computed once per block, only when something changed
+    updateCoefficients();
+    makeup_.setTarget(dB_to_linear(makeup_db_), PARAM_RAMP_FRAMES);
+}
+
+void DSPBlockCompressor::updateCoefficients() {
+    attackCoeff_ = expf(-1.0f / (attack_ms_ * 0.001f * sampleRate_));
+    releaseCoeff_ = expf(-1.0f / (release_ms_ * 0.001f * sampleRate_));
+}
+
+void DSPBlockCompressor::prepare(float sampleRate, size_t /*maxBlockFrames*/) {
+    sampleRate_ = sampleRate;
+    updateCoefficients();
+}
+
 void DSPBlockCompressor::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
-    float makeup = dB_to_linear(makeup_db_);
-    float attack_coeff = expf(-1.0f / (attack_ms_ * 0.001f * 44100.0f));
-    float release_coeff = expf(-1.0f / (release_ms_ * 0.001f * 44100.0f));
+    updateParams();
+
+    // Detector keys off the sidechain when the engine routes one (ducking)
+    const float *key_left = getSidechainLeft() ? getSidechainLeft() : left;
+    const float *key_right = getSidechainRight() ? getSidechainRight() : right;
 
     for (size_t i = 0; i < numFrames; ++i) {
-        float rms = sqrtf(0.5f * (left[i]*left[i] + right[i]*right[i]) + 1e-12f);
-        float input_db = 20.0f * log10(rms + 1e-20f);
+        // 10 log10 of the mean square = 20 log10 of the RMS
+        float mean_square = 0.5f * (key_left[i]*key_left[i] + key_right[i]*key_right[i]) + 1e-12f;
+        float input_db = 0.5f * nn_fast_linear_to_db(mean_square);
 
         float gain_db = 0.0f;
         if (input_db > threshold_db_) {
@@ -21,10 +62,11 @@ void DSPBlockCompressor::process(float* left, float* right, size_t numFrames) {
 
         // Envelope follower (attack/release)
         if (gain < gainSmooth_)
-            gainSmooth_ = gainSmooth_ * attack_coeff + gain * (1.0f - attack_coeff);
+            gainSmooth_ = gainSmooth_ * attackCoeff_ + gain * (1.0f - attackCoeff_);
         else
-            gainSmooth_ = gainSmooth_ * release_coeff + gain * (1.0f - release_coeff);
+            gainSmooth_ = gainSmooth_ * releaseCoeff_ + gain * (1.0f - releaseCoeff_);
 
+        float makeup = makeup_.next();
         left[i] *= gainSmooth_ * makeup;
         right[i] *= gainSmooth_ * makeup;
     }
@@ -40,21 +82,8 @@ std::vector<DSPParamDescriptor> DSPBlockCompressor::getParamDescriptors() {
     };
 }
 float DSPBlockCompressor::getParamValue(size_t idx) const {
-    switch (idx) {
-        case 0: return threshold_db_;
-        case 1: return ratio_;
-        case 2: return attack_ms_;
-        case 3: return release_ms_;
-        case 4: return makeup_db_;
-        default: return 0.0f;
-    }
+    return params_.get(idx);
 }
 void DSPBlockCompressor::setParamValue(size_t idx, float value) {
-    switch (idx) {
-        case 0: threshold_db_ = value; break;
-        case 1: ratio_ = value; break;
-        case 2: attack_ms_ = value; break;
-        case 3: release_ms_ = value; break;
-        case 4: makeup_db_ = value; break;
-    }
-}
\ No newline at end of file
+    params_.set(idx, value);
+}
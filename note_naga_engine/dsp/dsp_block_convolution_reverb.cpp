@@ -0,0 +1,375 @@
+#include <note_naga_engine/dsp/dsp_block_convolution_reverb.h>
+
+#include <note_naga_engine/core/dsp_vector_math.h>
+#include <note_naga_engine/io/wav_file.h>
+#include <note_naga_engine/logger.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Minimum length of the impulse response in seconds
+static constexpr float MIN_LENGTH = 0.2f;
+// Gain of the wet signal, IRs are normalized to unit energy
+static constexpr float WET_GAIN = 0.5f;
+// Length of the mix ramp after a change
+static constexpr size_t PARAM_RAMP_FRAMES = 1024;
+// Fade out at the end of a truncated IR
+static constexpr size_t TAIL_FADE_FRAMES = 4096;
+
+DSPBlockConvolutionReverb::DSPBlockConvolutionReverb(float mix, float length, float damping) {
+    params_.set(0, mix);
+    params_.set(1, length);
+    params_.set(2, damping);
+    prepare(NN_DSP_DEFAULT_SAMPLE_RATE, NN_DSP_DEFAULT_BLOCK_FRAMES);
+}
+
+DSPBlockConvolutionReverb::~DSPBlockConvolutionReverb() {
+    // The worker may still be building a kernel from the members below
+    killThread();
+    delete pending_.exchange(nullptr);
+    delete retired_.exchange(nullptr);
+    delete kernel_;
+    delete fadeFrom_;
+    delete retiring_;
+}
+
+void DSPBlockConvolutionReverb::process(float *left, float *right, size_t numFrames) {
+    if (!isActive()) return;
+
+    uint64_t changed = params_.consume();
+    if (NoteNagaDSPParamMailbox::isChanged(changed, 0)) {
+        mixRamp_.setTarget(std::clamp(params_.get(0), 0.0f, 1.0f), PARAM_RAMP_FRAMES);
+    }
+
+    size_t done = 0;
+    while (done < numFrames) {
+        size_t n = std::min(PARTITION_SIZE - inPos_, numFrames - done);
+        float *inL = input_[0].data() + PARTITION_SIZE + inPos_;
+        float *inR = input_[1].data() + PARTITION_SIZE + inPos_;
+        // Input of one partition ago, aligned with the wet output
+        const float *delayedL = input_[0].data() + inPos_;
+        const float *delayedR = input_[1].data() + inPos_;
+        const float *wetL = output_[0].data() + inPos_;
+        const float *wetR = output_[1].data() + inPos_;
+        float *l = left + done;
+        float *r = right + done;
+        for (size_t i = 0; i < n; ++i) {
+            inL[i] = l[i];
+            inR[i] = r[i];
+            float mix = mixRamp_.next();
+            float dry = 1.0f - mix;
+            float wet = mix * WET_GAIN;
+            l[i] = delayedL[i] * dry + wetL[i] * wet;
+            r[i] = delayedR[i] * dry + wetR[i] * wet;
+        }
+        inPos_ += n;
+        done += n;
+        if (inPos_ == PARTITION_SIZE) {
+            processPartition();
+            inPos_ = 0;
+        } else if (tailPartitions_ > 1) {
+            // Spread the IR tail so it is done by the expected last block of the partition
+            const size_t finish = std::max<size_t>(1, PARTITION_SIZE - n);
+            accumulateTail(1 + (tailPartitions_ - 1) * std::min(inPos_, finish) / finish);
+        }
+    }
+}
+
+void DSPBlockConvolutionReverb::processPartition() {
+    // Rest of the tail, all of it when one host block covered the whole partition
+    accumulateTail(tailPartitions_);
+
+    const size_t slot = fdlPos_ * NUM_BINS;
+    for (int c = 0; c < 2; ++c) {
+        fft_.forwardReal(input_[c].data(), fdlRe_[c].data() + slot, fdlIm_[c].data() + slot);
+
+        float *out = output_[c].data();
+        if (kernel_) {
+            finishConvolution(*kernel_, 0, c, out);
+        } else {
+            std::fill(out, out + PARTITION_SIZE, 0.0f);
+        }
+        if (fadeFrom_) {
+            // Crossfade from the old IR over this partition
+            finishConvolution(*fadeFrom_, 1, c, fadeBuf_.data());
+            const float step = 1.0f / float(PARTITION_SIZE);
+            for (size_t i = 0; i < PARTITION_SIZE; ++i) {
+                out[i] = fadeBuf_[i] + (out[i] - fadeBuf_[i]) * (float(i + 1) * step);
+            }
+        }
+
+        // Keep the current partition as the first half of the next FFT window
+        std::memcpy(input_[c].data(), input_[c].data() + PARTITION_SIZE, PARTITION_SIZE * sizeof(float));
+    }
+
+    if (++fdlPos_ >= maxPartitions_) fdlPos_ = 0;
+    beginPartition();
+}
+
+void DSPBlockConvolutionReverb::beginPartition() {
+    // Hand the faded out kernel back to the GUI side, then take a new one
+    if (fadeFrom_) {
+        retiring_ = fadeFrom_;
+        fadeFrom_ = nullptr;
+    }
+    if (retiring_) {
+        Kernel *expected = nullptr;
+        if (retired_.compare_exchange_strong(expected, retiring_, std::memory_order_release)) retiring_ = nullptr;
+    }
+    if (!retiring_) {
+        Kernel *next = pending_.exchange(nullptr, std::memory_order_acquire);
+        if (next) {
+            fadeFrom_ = kernel_;
+            kernel_ = next;
+        }
+    }
+
+    // Kernels are fixed for the whole partition, start their tail sums
+    tailPartitions_ = std::min(std::max(kernel_ ? kernel_->partitions : 0, fadeFrom_ ? fadeFrom_->partitions : 0),
+                               maxPartitions_);
+    tailDone_ = 1;
+    for (int k = 0; k < 2; ++k) {
+        for (int c = 0; c < 2; ++c) {
+            std::fill(tailRe_[k][c].begin(), tailRe_[k][c].end(), 0.0f);
+            std::fill(tailIm_[k][c].begin(), tailIm_[k][c].end(), 0.0f);
+        }
+    }
+}
+
+void DSPBlockConvolutionReverb::accumulateTail(size_t until) {
+    // Partition p of the IR meets the input spectrum from p partitions before the one
+    // being filled, which is already in the delay line
+    const Kernel *kernels[2] = {kernel_, fadeFrom_};
+    for (; tailDone_ < until; ++tailDone_) {
+        const size_t p = tailDone_;
+        const size_t slot = (fdlPos_ + maxPartitions_ - p) % maxPartitions_ * NUM_BINS;
+        for (int k = 0; k < 2; ++k) {
+            if (!kernels[k] || p >= kernels[k]->partitions) continue;
+            for (int c = 0; c < 2; ++c) {
+                nn_vec_complex_mul_add(tailRe_[k][c].data(), tailIm_[k][c].data(), fdlRe_[c].data() + slot,
+                                       fdlIm_[c].data() + slot, kernels[k]->re[c].data() + p * NUM_BINS,
+                                       kernels[k]->im[c].data() + p * NUM_BINS, NUM_BINS);
+            }
+        }
+    }
+}
+
+void DSPBlockConvolutionReverb::finishConvolution(const Kernel &kernel, int slot, int channel, float *out) {
+    float *accRe = tailRe_[slot][channel].data();
+    float *accIm = tailIm_[slot][channel].data();
+
+    // Partition 0 of the IR meets the spectrum of the partition just completed
+    if (kernel.partitions > 0) {
+        const size_t bins = fdlPos_ * NUM_BINS;
+        nn_vec_complex_mul_add(accRe, accIm, fdlRe_[channel].data() + bins, fdlIm_[channel].data() + bins,
+                               kernel.re[channel].data(), kernel.im[channel].data(), NUM_BINS);
+    }
+
+    // Overlap-save: the second half of the window is the valid linear convolution
+    fft_.inverseReal(accRe, accIm, timeBuf_.data());
+    std::memcpy(out, timeBuf_.data() + PARTITION_SIZE, PARTITION_SIZE * sizeof(float));
+}
+
+float DSPBlockConvolutionReverb::getTailSeconds() const {
+    // IR length plus the partition of latency, the kernel is only swapped on this thread
+    size_t partitions = std::max(kernel_ ? kernel_->partitions : 0, fadeFrom_ ? fadeFrom_->partitions : 0);
+    return float((partitions + 1) * PARTITION_SIZE) / sampleRate_;
+}
+
+std::vector<DSPParamDescriptor> DSPBlockConvolutionReverb::getParamDescriptors() {
+    return {{"Mix", DSPParamType::Float, DSControlType::DialCentered, 0.0f, 1.0f, 0.3f},
+            {"Length", DSPParamType::Float, DSControlType::Dial, MIN_LENGTH, MAX_LENGTH, 2.0f},
+            {"Damping", DSPParamType::Float, DSControlType::DialCentered, 0.0f, 1.0f, 0.3f}};
+}
+
+float DSPBlockConvolutionReverb::getParamValue(size_t idx) const {
+    return params_.get(idx);
+}
+
+void DSPBlockConvolutionReverb::setParamValue(size_t idx, float value) {
+    if (idx == 0) {
+        params_.set(idx, value);
+        return;
+    }
+    if (idx > 2 || params_.get(idx) == value) return;
+    params_.set(idx, value);
+    // Length and damping shape the IR, rebuilt off the calling thread
+    requestRebuild();
+}
+
+void DSPBlockConvolutionReverb::requestRebuild() {
+    // One queued rebuild at a time, it reads the latest parameters when it runs
+    if (!rebuildQueued_.exchange(true)) pushToQueue(NN_AsyncTriggerMessage_t{});
+}
+
+void DSPBlockConvolutionReverb::onItem(const NN_AsyncTriggerMessage_t &) {
+    // Changes posted from now on need another rebuild
+    rebuildQueued_.store(false);
+    rebuildKernel();
+}
+
+bool DSPBlockConvolutionReverb::loadImpulseResponse(const std::string &path) {
+    WavFile wav;
+    if (!wav.load(path) || wav.getNumFrames() == 0) {
+        NOTE_NAGA_LOG_ERROR("Failed to load impulse response: " + path);
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(irMutex_);
+        irPath_ = path;
+        irLeft_ = std::move(wav.left);
+        irRight_ = std::move(wav.right);
+        irSampleRate_ = float(wav.sample_rate);
+    }
+    rebuildKernel();
+    NOTE_NAGA_LOG_INFO("Loaded impulse response: " + path);
+    return true;
+}
+
+void DSPBlockConvolutionReverb::useGeneratedRoom() {
+    {
+        std::lock_guard<std::mutex> lock(irMutex_);
+        irPath_.clear();
+        irLeft_.clear();
+        irRight_.clear();
+    }
+    rebuildKernel();
+}
+
+std::string DSPBlockConvolutionReverb::getImpulseResponsePath() const {
+    std::lock_guard<std::mutex> lock(irMutex_);
+    return irPath_;
+}
+
+void DSPBlockConvolutionReverb::prepare(float sampleRate, size_t /*maxBlockFrames*/) {
+    {
+        // The worker builds kernels from these
+        std::lock_guard<std::mutex> lock(irMutex_);
+        sampleRate_ = sampleRate;
+        buildFFT_.setSize(FFT_SIZE);
+        maxPartitions_ = size_t(std::ceil(MAX_LENGTH * sampleRate_ / float(PARTITION_SIZE)));
+    }
+
+    fft_.setSize(FFT_SIZE);
+    for (int c = 0; c < 2; ++c) {
+        input_[c].assign(FFT_SIZE, 0.0f);
+        output_[c].assign(PARTITION_SIZE, 0.0f);
+        fdlRe_[c].assign(maxPartitions_ * NUM_BINS, 0.0f);
+        fdlIm_[c].assign(maxPartitions_ * NUM_BINS, 0.0f);
+        for (int k = 0; k < 2; ++k) {
+            tailRe_[k][c].assign(NUM_BINS, 0.0f);
+            tailIm_[k][c].assign(NUM_BINS, 0.0f);
+        }
+    }
+    timeBuf_.assign(FFT_SIZE, 0.0f);
+    fadeBuf_.assign(PARTITION_SIZE, 0.0f);
+    fdlPos_ = 0;
+    inPos_ = 0;
+
+    // Block is not processed, the current IR can be dropped directly
+    delete kernel_;
+    delete fadeFrom_;
+    delete retiring_;
+    kernel_ = fadeFrom_ = retiring_ = nullptr;
+
+    params_.consume();
+    mixRamp_.reset(std::clamp(params_.get(0), 0.0f, 1.0f));
+    rebuildKernel();
+    beginPartition();
+}
+
+void DSPBlockConvolutionReverb::rebuildKernel() {
+    std::lock_guard<std::mutex> lock(irMutex_);
+
+    const float length = std::clamp(params_.get(1), MIN_LENGTH, MAX_LENGTH);
+    const float damping = std::clamp(params_.get(2), 0.0f, 1.0f);
+    const size_t maxFrames = size_t(length * sampleRate_);
+
+    // IR at the block sample rate, truncated to the length
+    std::vector<float> ir[2];
+    if (irLeft_.empty()) {
+        generateRoom(length, ir[0], ir[1]);
+    } else {
+        const double ratio = double(irSampleRate_) / double(sampleRate_);
+        const size_t srcFrames = irLeft_.size();
+        const size_t frames = std::min(maxFrames, size_t(double(srcFrames) / ratio));
+        const std::vector<float> *src[2] = {&irLeft_, irRight_.size() == srcFrames ? &irRight_ : &irLeft_};
+        for (int c = 0; c < 2; ++c) {
+            ir[c].resize(frames);
+            for (size_t i = 0; i < frames; ++i) {
+                double pos = double(i) * ratio;
+                size_t i0 = size_t(pos);
+                size_t i1 = std::min(i0 + 1, srcFrames - 1);
+                float frac = float(pos - double(i0));
+                ir[c][i] = (*src[c])[i0] + ((*src[c])[i1] - (*src[c])[i0]) * frac;
+            }
+        }
+        // Fade out when the file was cut by the length
+        if (frames == maxFrames) {
+            const size_t fade = std::min(TAIL_FADE_FRAMES, frames);
+            for (int c = 0; c < 2; ++c) {
+                for (size_t i = 0; i < fade; ++i) ir[c][frames - fade + i] *= float(fade - i) / float(fade);
+            }
+        }
+    }
+
+    // Damping: one-pole low-pass that closes along the tail
+    const size_t frames = ir[0].size();
+    double energy = 0.0;
+    for (int c = 0; c < 2; ++c) {
+        float state = 0.0f;
+        for (size_t i = 0; i < frames; ++i) {
+            float a = damping * 0.9f * std::min(1.0f, 2.0f * float(i) / float(frames));
+            state = ir[c][i] * (1.0f - a) + state * a;
+            ir[c][i] = state;
+            energy += double(state) * double(state);
+        }
+    }
+    const float norm = energy > 0.0 ? float(1.0 / std::sqrt(energy * 0.5)) : 0.0f;
+
+    // Spectra of all partitions
+    Kernel *kernel = new Kernel();
+    kernel->partitions = std::min((frames + PARTITION_SIZE - 1) / PARTITION_SIZE, maxPartitions_);
+    std::vector<float> window(FFT_SIZE, 0.0f);
+    for (int c = 0; c < 2; ++c) {
+        kernel->re[c].assign(kernel->partitions * NUM_BINS, 0.0f);
+        kernel->im[c].assign(kernel->partitions * NUM_BINS, 0.0f);
+        for (size_t p = 0; p < kernel->partitions; ++p) {
+            std::fill(window.begin(), window.end(), 0.0f);
+            size_t begin = p * PARTITION_SIZE;
+            size_t count = std::min(PARTITION_SIZE, frames - begin);
+            for (size_t i = 0; i < count; ++i) window[i] = ir[c][begin + i] * norm;
+            buildFFT_.forwardReal(window.data(), kernel->re[c].data() + p * NUM_BINS,
+                                  kernel->im[c].data() + p * NUM_BINS);
+        }
+    }
+    publishKernel(kernel);
+}
+
+void DSPBlockConvolutionReverb::publishKernel(Kernel *kernel) {
+    // Free the kernel the audio thread finished with and a pending one it never took
+    delete retired_.exchange(nullptr, std::memory_order_acquire);
+    delete pending_.exchange(kernel, std::memory_order_acq_rel);
+}
+
+void DSPBlockConvolutionReverb::generateRoom(float length, std::vector<float> &left,
+                                             std::vector<float> &right) const {
+    // Exponentially decaying noise (RT60 = length), decorrelated channels
+    const size_t frames = size_t(length * sampleRate_);
+    const float decay = -6.91f / (length * sampleRate_);
+    const size_t attack = size_t(0.002f * sampleRate_) + 1;
+    left.resize(frames);
+    right.resize(frames);
+    uint32_t seedL = 0x12345678u, seedR = 0x9abcdef1u;
+    auto noise = [](uint32_t &seed) {
+        seed = seed * 1664525u + 1013904223u;
+        return float(int32_t(seed)) / 2147483648.0f;
+    };
+    for (size_t i = 0; i < frames; ++i) {
+        float env = std::exp(decay * float(i));
+        if (i < attack) env *= float(i) / float(attack);
+        left[i] = noise(seedL) * env;
+        right[i] = noise(seedR) * env;
+    }
+}
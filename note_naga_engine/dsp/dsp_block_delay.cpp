@@ -2,37 +2,74 @@
 
 #include <algorithm>
 
+// Length of the feedback / mix ramp after a parameter change
+static constexpr size_t PARAM_RAMP_FRAMES = 512;
+// Length of the read tap glide after a time change, a jump of the tap would click
+static constexpr size_t TIME_RAMP_FRAMES = 2048;
+
 DSPBlockDelay::DSPBlockDelay(float time_ms, float feedback, float mix)
-    : time_ms_(time_ms), feedback_(feedback), mix_(mix)
 {
-    setSampleRate(44100.0f); // default
+    params_.set(0, time_ms);
+    params_.set(1, feedback);
+    params_.set(2, mix);
+    prepare(NN_DSP_DEFAULT_SAMPLE_RATE, NN_DSP_DEFAULT_BLOCK_FRAMES);
+}
+
+float DSPBlockDelay::delayTap() const {
+    // Tap of the sample written delaySamples ago (read(0) is the last written one)
+    return std::clamp(time_ms_ * 0.001f * sampleRate_, 1.0f, (float)(maxDelaySamples_)) - 1.0f;
+}
+
+void DSPBlockDelay::updateParams() {
+    if (!params_.consume()) return;
+    time_ms_ = params_.get(0);
+    feedback_ = params_.get(1);
+    mix_ = params_.get(2);
+    feedbackRamp_.setTarget(feedback_, PARAM_RAMP_FRAMES);
+    mixRamp_.setTarget(mix_, PARAM_RAMP_FRAMES);
+    tapRamp_.setTarget(delayTap(), TIME_RAMP_FRAMES);
 }
 
 void DSPBlockDelay::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
-    const float sampleRate = sampleRate_;
-    size_t delaySamples = static_cast<size_t>(std::clamp(time_ms_ * 0.001f * sampleRate, 1.0f, (float)(maxDelaySamples_)));
+    updateParams();
+
+    // Whole sample tap unless the time is gliding
+    const bool gliding = tapRamp_.isSmoothing();
+    const size_t tap = static_cast<size_t>(tapRamp_.getCurrent());
 
     for (size_t i = 0; i < numFrames; ++i) {
+        float feedback = feedbackRamp_.next();
+        float mix = mixRamp_.next();
+        float delayedL, delayedR;
+        if (gliding) {
+            float glideTap = tapRamp_.next();
+            delayedL = delayL_.readLinear(glideTap);
+            delayedR = delayR_.readLinear(glideTap);
+        } else {
+            delayedL = delayL_.read(tap);
+            delayedR = delayR_.read(tap);
+        }
+
         // Left channel
-        float delayedL = delayBufferL_[delayIdx_];
         float inL = left[i];
-        float outL = inL * (1.0f - mix_) + delayedL * mix_;
-        delayBufferL_[delayIdx_] = inL + delayedL * feedback_;
+        float outL = inL * (1.0f - mix) + delayedL * mix;
+        delayL_.push(inL + delayedL * feedback);
         left[i] = outL;
 
         // Right channel
-        float delayedR = delayBufferR_[delayIdx_];
         float inR = right[i];
-        float outR = inR * (1.0f - mix_) + delayedR * mix_;
-        delayBufferR_[delayIdx_] = inR + delayedR * feedback_;
+        float outR = inR * (1.0f - mix) + delayedR * mix;
+        delayR_.push(inR + delayedR * feedback);
         right[i] = outR;
-
-        // Increment and wrap delay index
-        delayIdx_ = (delayIdx_ + 1) % delaySamples;
     }
 }
 
+float DSPBlockDelay::getTailSeconds() const {
+    float loop = std::clamp(params_.get(0) * 0.001f, 0.0f, float(maxDelaySamples_) / sampleRate_);
+    return feedbackDecaySeconds(loop, params_.get(1));
+}
+
 std::vector<DSPParamDescriptor> DSPBlockDelay::getParamDescriptors() {
     return {
         { "Time", DSPParamType::Float, DSControlType::Dial, 10.0f, 1000.0f, 400.0f },
@@ -42,34 +79,23 @@ std::vector<DSPParamDescriptor> DSPBlockDelay::getParamDescriptors() {
 }
 
 float DSPBlockDelay::getParamValue(size_t idx) const {
-    switch (idx) {
-        case 0: return time_ms_;
-        case 1: return feedback_;
-        case 2: return mix_;
-        default: return 0.0f;
-    }
+    return params_.get(idx);
 }
 
 void DSPBlockDelay::setParamValue(size_t idx, float value) {
-    switch (idx) {
-        case 0: 
-            time_ms_ = value; 
-            resizeDelayBuffers();
-            break;
-        case 1: feedback_ = value; break;
-        case 2: mix_ = value; break;
-    }
+    params_.set(idx, value);
 }
 
-void DSPBlockDelay::setSampleRate(float sr) {
-    sampleRate_ = sr;
-    resizeDelayBuffers();
-}
+void DSPBlockDelay::prepare(float sampleRate, size_t /*maxBlockFrames*/) {
+    sampleRate_ = sampleRate;
+    // Sized for the longest delay, time changes only move the read tap
+    maxDelaySamples_ = static_cast<size_t>(2.0f * sampleRate_);
+    delayL_.setMaxDelay(maxDelaySamples_);
+    delayR_.setMaxDelay(maxDelaySamples_);
 
-void DSPBlockDelay::resizeDelayBuffers() {
-    size_t samples = static_cast<size_t>(std::clamp(time_ms_ * 0.001f * sampleRate_, 1.0f, 2.0f * sampleRate_));
-    maxDelaySamples_ = samples;
-    delayBufferL_.resize(maxDelaySamples_, 0.0f);
-    delayBufferR_.resize(maxDelaySamples_, 0.0f);
-    delayIdx_ = 0;
+    // Start from the posted parameters without ramps, the tap depends on the sample rate
+    updateParams();
+    feedbackRamp_.reset(feedback_);
+    mixRamp_.reset(mix_);
+    tapRamp_.reset(delayTap());
 }
\ No newline at end of file
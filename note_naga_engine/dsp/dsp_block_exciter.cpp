@@ -1,65 +1,96 @@
 #include <note_naga_engine/dsp/dsp_block_exciter.h>
 
+#include <note_naga_engine/core/dsp_fast_math.h>
+
+#include <algorithm>
 #include <cmath>
 
-DSPBlockExciter::DSPBlockExciter(float freq, float drive, float mix)
-    : freq_(freq), drive_(drive), mix_(mix) {}
+// Length of the drive / mix ramps after a parameter change (base rate frames)
+static constexpr size_t PARAM_RAMP_FRAMES = 512;
+
+DSPBlockExciter::DSPBlockExciter(float freq, float drive, float mix) {
+    params_.set(0, freq);
+    params_.set(1, drive);
+    params_.set(2, mix);
+    params_.set(3, 1.0f);
+    prepare(NN_DSP_DEFAULT_SAMPLE_RATE, NN_DSP_DEFAULT_BLOCK_FRAMES);
+}
 
 inline float saturate(float x, float drive) {
     // Soft clipping: tanh drive
-    return std::tanh(x * drive);
+    return nn_fast_tanh(x * drive);
+}
+
+void DSPBlockExciter::prepare(float sampleRate, size_t maxBlockFrames) {
+    sampleRate_ = sampleRate;
+    oversampler_.prepare(maxBlockFrames);
+    updateParams(0);
+}
+
+size_t DSPBlockExciter::getLatencySamples() const {
+    return latencySamples_.load(std::memory_order_relaxed);
+}
+
+void DSPBlockExciter::updateParams(size_t rampFrames) {
+    if (!params_.consume()) return;
+    // The factor and the reported latency change together at the block boundary
+    quality_ = std::clamp(static_cast<int>(params_.get(3)), 0, 3);
+    oversampler_.setFactor(1 << quality_);
+    latencySamples_.store(NoteNagaOversampler::latencyForFactor(1 << quality_), std::memory_order_relaxed);
+
+    // The ramps run at the oversampled rate
+    freq_ = params_.get(0);
+    drive_.setTarget(params_.get(1), rampFrames * oversampler_.getFactor());
+    mix_.setTarget(params_.get(2), rampFrames * oversampler_.getFactor());
 }
 
 void DSPBlockExciter::process(float *left, float *right, size_t numFrames) {
     if (!isActive()) return;
-    float alpha = freq_ / (freq_ + sampleRate_); // HP filter coeff
-
-    for (size_t i = 0; i < numFrames; ++i) {
-        // Simple HP filter for highs
-        hpL_ = alpha * (hpL_ + left[i] - left[i]);
-        hpR_ = alpha * (hpR_ + right[i] - right[i]);
-        float highL = left[i] - hpL_;
-        float highR = right[i] - hpR_;
-
-        // Excite: saturate highs
-        float excL = saturate(highL, drive_);
-        float excR = saturate(highR, drive_);
-
-        // Mix
-        left[i] = left[i] * (1.0f - mix_) + excL * mix_;
-        right[i] = right[i] * (1.0f - mix_) + excR * mix_;
-    }
+    updateParams(PARAM_RAMP_FRAMES);
+
+    // One-pole low-pass coefficient at the oversampled rate
+    const float rate = sampleRate_ * oversampler_.getFactor();
+    const float alpha = 1.0f - std::exp(-2.0f * float(M_PI) * freq_ / rate);
+    const bool smoothing = drive_.isSmoothing() || mix_.isSmoothing();
+    float drive = drive_.getCurrent();
+    float mix = mix_.getCurrent();
+
+    oversampler_.process(left, right, numFrames, [&](float *l, float *r, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            if (smoothing) {
+                drive = drive_.next();
+                mix = mix_.next();
+            }
+
+            // Split off the highs
+            lpL_ += alpha * (l[i] - lpL_);
+            lpR_ += alpha * (r[i] - lpR_);
+            float highL = l[i] - lpL_;
+            float highR = r[i] - lpR_;
+
+            // Excite: saturate highs
+            float excL = saturate(highL, drive);
+            float excR = saturate(highR, drive);
+
+            // Mix
+            l[i] = l[i] * (1.0f - mix) + excL * mix;
+            r[i] = r[i] * (1.0f - mix) + excR * mix;
+        }
+    });
 }
 
 std::vector<DSPParamDescriptor> DSPBlockExciter::getParamDescriptors() {
     return {{"Freq", DSPParamType::Float, DSControlType::Dial, 1000.0f, 12000.0f, 4000.0f},
             {"Drive", DSPParamType::Float, DSControlType::Dial, 1.0f, 10.0f, 4.0f},
-            {"Mix", DSPParamType::Float, DSControlType::DialCentered, 0.0f, 1.0f, 0.6f}};
+            {"Mix", DSPParamType::Float, DSControlType::DialCentered, 0.0f, 1.0f, 0.6f},
+            {"Quality", DSPParamType::Int, DSControlType::Dial, 0.0f, 3.0f, 1.0f, {"Off", "2x", "4x", "8x"}}};
 }
 
 float DSPBlockExciter::getParamValue(size_t idx) const {
-    switch (idx) {
-    case 0:
-        return freq_;
-    case 1:
-        return drive_;
-    case 2:
-        return mix_;
-    default:
-        return 0.0f;
-    }
+    return params_.get(idx);
 }
 
 void DSPBlockExciter::setParamValue(size_t idx, float value) {
-    switch (idx) {
-    case 0:
-        freq_ = value;
-        break;
-    case 1:
-        drive_ = value;
-        break;
-    case 2:
-        mix_ = value;
-        break;
-    }
-}
\ No newline at end of file
+    if (idx == 3) value = static_cast<float>(std::clamp(static_cast<int>(value), 0, 3));
+    params_.set(idx, value);
+}
@@ -3,28 +3,60 @@
 #include <algorithm>
 #include <cmath>
 
+// Length of the mix ramp after a parameter change
+static constexpr size_t PARAM_RAMP_FRAMES = 512;
+
 DSPBlockFilter::DSPBlockFilter(FilterType type, float cutoff, float resonance, float mix)
     : type_(type), cutoff_(cutoff), resonance_(resonance), mix_(mix) {
-    setSampleRate(44100.0f);
-    calcCoeffs();
+    params_.set(0, static_cast<float>(type));
+    params_.set(1, cutoff);
+    params_.set(2, resonance);
+    params_.set(3, mix);
+    params_.consume();
+    mixRamp_.reset(mix);
+    filter_.setStageCount(1);
+    prepare(NN_DSP_DEFAULT_SAMPLE_RATE, NN_DSP_DEFAULT_BLOCK_FRAMES);
+}
+
+void DSPBlockFilter::updateParams() {
+    uint64_t changed = params_.consume();
+    if (!changed) return;
+
+    type_ = static_cast<FilterType>(std::clamp(static_cast<int>(params_.get(0)), 0, 2));
+    cutoff_ = params_.get(1);
+    resonance_ = params_.get(2);
+    mix_ = params_.get(3);
+    mixRamp_.setTarget(mix_, PARAM_RAMP_FRAMES);
+
+    // Coefficients only when type / cutoff / resonance changed
+    if (changed & 0x7) calcCoeffs();
 }
 
 void DSPBlockFilter::process(float *left, float *right, size_t numFrames) {
     if (!isActive()) return;
-    for (size_t i = 0; i < numFrames; ++i) {
-        // Left
-        float inL = left[i];
-        float outL = a0_ * inL + a1_ * z1L_ + a2_ * z2L_ - b1_ * z1L_ - b2_ * z2L_;
-        z2L_ = z1L_;
-        z1L_ = outL;
-        left[i] = inL * (1.0f - mix_) + outL * mix_;
-
-        // Right
-        float inR = right[i];
-        float outR = a0_ * inR + a1_ * z1R_ + a2_ * z2R_ - b1_ * z1R_ - b2_ * z2R_;
-        z2R_ = z1R_;
-        z1R_ = outR;
-        right[i] = inR * (1.0f - mix_) + outR * mix_;
+    updateParams();
+
+    // Fully wet, filter in place
+    if (!mixRamp_.isSmoothing() && mixRamp_.getCurrent() >= 1.0f) {
+        filter_.process(left, right, numFrames);
+        return;
+    }
+
+    // Blocks larger than the prepared size are mixed in chunks
+    const size_t chunkFrames = dryL_.size();
+    for (size_t start = 0; start < numFrames; start += chunkFrames) {
+        const size_t n = std::min(chunkFrames, numFrames - start);
+        float *l = left + start;
+        float *r = right + start;
+        std::copy(l, l + n, dryL_.data());
+        std::copy(r, r + n, dryR_.data());
+        filter_.process(l, r, n);
+
+        for (size_t i = 0; i < n; ++i) {
+            float mix = mixRamp_.next();
+            l[i] = dryL_[i] * (1.0f - mix) + l[i] * mix;
+            r[i] = dryR_[i] * (1.0f - mix) + r[i] * mix;
+        }
     }
 }
 
@@ -42,83 +74,34 @@ std::vector<DSPParamDescriptor> DSPBlockFilter::getParamDescriptors() {
 }
 
 float DSPBlockFilter::getParamValue(size_t idx) const {
-    switch (idx) {
-    case 0:
-        return static_cast<float>(type_);
-    case 1:
-        return cutoff_;
-    case 2:
-        return resonance_;
-    case 3:
-        return mix_;
-    default:
-        return 0.0f;
-    }
+    return params_.get(idx);
 }
 
 void DSPBlockFilter::setParamValue(size_t idx, float value) {
-    switch (idx) {
-    case 0:
-        type_ = static_cast<FilterType>(static_cast<int>(value));
-        calcCoeffs();
-        break;
-    case 1:
-        cutoff_ = value;
-        calcCoeffs();
-        break;
-    case 2:
-        resonance_ = value;
-        calcCoeffs();
-        break;
-    case 3:
-        mix_ = value;
-        break;
-    }
+    params_.set(idx, value);
 }
 
-void DSPBlockFilter::setSampleRate(float sr) {
-    sampleRate_ = sr;
+void DSPBlockFilter::prepare(float sampleRate, size_t maxBlockFrames) {
+    sampleRate_ = sampleRate;
+    dryL_.assign(std::max<size_t>(maxBlockFrames, 1), 0.0f);
+    dryR_.assign(std::max<size_t>(maxBlockFrames, 1), 0.0f);
     calcCoeffs();
 }
 
-// Biquad filter design (TPT, simple RBJ formula)
+// Biquad filter design (RBJ formula), state is kept so cutoff sweeps do not click
 void DSPBlockFilter::calcCoeffs() {
     float freq = std::clamp(cutoff_, 20.0f, sampleRate_ * 0.45f);
     float Q = std::clamp(resonance_, 0.1f, 2.0f);
-    float omega = 2.0f * M_PI * freq / sampleRate_;
-    float sn = std::sin(omega);
-    float cs = std::cos(omega);
-    float alpha = sn / (2.0f * Q);
 
     switch (type_) {
-    case FilterType::Lowpass: {
-        float norm = 1.0f / (1.0f + alpha);
-        a0_ = (1.0f - cs) * 0.5f * norm;
-        a1_ = (1.0f - cs) * norm;
-        a2_ = a0_;
-        b1_ = -2.0f * cs * norm;
-        b2_ = (1.0f - alpha) * norm;
+    case FilterType::Lowpass:
+        filter_.setCoeffs(0, nn_biquad_lowpass(sampleRate_, freq, Q));
         break;
-    }
-    case FilterType::Highpass: {
-        float norm = 1.0f / (1.0f + alpha);
-        a0_ = (1.0f + cs) * 0.5f * norm;
-        a1_ = -(1.0f + cs) * norm;
-        a2_ = a0_;
-        b1_ = -2.0f * cs * norm;
-        b2_ = (1.0f - alpha) * norm;
+    case FilterType::Highpass:
+        filter_.setCoeffs(0, nn_biquad_highpass(sampleRate_, freq, Q));
         break;
-    }
-    case FilterType::Bandpass: {
-        float norm = 1.0f / (1.0f + alpha);
-        a0_ = alpha * norm;
-        a1_ = 0.0f;
-        a2_ = -alpha * norm;
-        b1_ = -2.0f * cs * norm;
-        b2_ = (1.0f - alpha) * norm;
+    case FilterType::Bandpass:
+        filter_.setCoeffs(0, nn_biquad_bandpass(sampleRate_, freq, Q));
         break;
     }
-    }
-    // Clear state after parameter change
-    z1L_ = z2L_ = z1R_ = z2R_ = 0.0f;
-}
\ No newline at end of file
+}
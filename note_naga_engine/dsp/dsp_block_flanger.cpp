@@ -1,57 +1,71 @@
 #include <note_naga_engine/dsp/dsp_block_flanger.h>
 
-#include <cmath>
+#include <algorithm>
+
+// Length of the depth / feedback / mix ramps after a parameter change
+static constexpr size_t PARAM_RAMP_FRAMES = 512;
 
 DSPBlockFlanger::DSPBlockFlanger(float speed, float depth, float feedback, float mix)
-    : speed_(speed), depth_(depth), feedback_(feedback), mix_(mix)
 {
+    params_.set(0, speed);
+    params_.set(1, depth);
+    params_.set(2, feedback);
+    params_.set(3, mix);
+    prepare(NN_DSP_DEFAULT_SAMPLE_RATE, NN_DSP_DEFAULT_BLOCK_FRAMES);
+}
+
+void DSPBlockFlanger::updateParams(size_t rampFrames) {
+    if (!params_.consume()) return;
+    speed_ = params_.get(0);
+    depth_.setTarget(params_.get(1), rampFrames);
+    feedback_.setTarget(params_.get(2), rampFrames);
+    mix_.setTarget(params_.get(3), rampFrames);
+    lfo_.setRate(speed_, sampleRate_);
+}
+
+void DSPBlockFlanger::prepare(float sampleRate, size_t /*maxBlockFrames*/) {
+    sampleRate_ = sampleRate;
     maxDelaySamples_ = static_cast<size_t>(sampleRate_ * 0.008f); // 8 ms max delay
-    delayBufferL_.resize(maxDelaySamples_, 0.0f);
-    delayBufferR_.resize(maxDelaySamples_, 0.0f);
+    delayL_.setMaxDelay(maxDelaySamples_);
+    delayR_.setMaxDelay(maxDelaySamples_);
+    lastL_ = lastR_ = 0.0f;
+
+    // Take pending parameters without ramps, the LFO rate depends on the sample rate
+    updateParams(0);
+    lfo_.setRate(speed_, sampleRate_);
 }
 
 void DSPBlockFlanger::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
+    updateParams(PARAM_RAMP_FRAMES);
 
+    const float samplesPerMs = sampleRate_ / 1000.0f;
+    const float maxDelay = float(maxDelaySamples_ - 2);
     for (size_t i = 0; i < numFrames; ++i) {
-        // LFO phase
-        float lfo = std::sin(lfoPhase_);
-        lfoPhase_ += 2.0f * M_PI * speed_ / sampleRate_;
-        if (lfoPhase_ > 2.0f * M_PI) lfoPhase_ -= 2.0f * M_PI;
-
         // Modulated delay (0.5 .. 0.5+depth ms)
-        float delayMs = 0.5f + lfo * depth_;
-        float delaySamples = delayMs * sampleRate_ / 1000.0f;
-
-        // Clamp delaySamples
-        if (delaySamples < 0.0f) delaySamples = 0.0f;
-        if (delaySamples > (float)(maxDelaySamples_ - 2)) delaySamples = (float)(maxDelaySamples_ - 2);
-
-        // Write input to delay buffer (with feedback)
-        float inL = left[i] + feedback_ * delayBufferL_[delayIdx_];
-        float inR = right[i] + feedback_ * delayBufferR_[delayIdx_];
-        delayBufferL_[delayIdx_] = inL;
-        delayBufferR_[delayIdx_] = inR;
+        float delayMs = 0.5f + lfo_.next() * depth_.next();
+        float delaySamples = std::clamp(delayMs * samplesPerMs, 0.0f, maxDelay);
 
-        // Read delayed sample with linear interpolation
-        float readPos = (float)delayIdx_ - delaySamples;
-        if (readPos < 0.0f) readPos += (float)maxDelaySamples_;
-
-        size_t idx0 = static_cast<size_t>(readPos) % maxDelaySamples_;
-        size_t idx1 = (idx0 + 1) % maxDelaySamples_;
-        float frac = readPos - std::floor(readPos);
-
-        float flangedL = delayBufferL_[idx0] * (1.0f - frac) + delayBufferL_[idx1] * frac;
-        float flangedR = delayBufferR_[idx0] * (1.0f - frac) + delayBufferR_[idx1] * frac;
+        // Write input with feedback of the modulated tap, the comb resonances follow the sweep
+        float feedback = feedback_.next();
+        delayL_.push(left[i] + feedback * lastL_);
+        delayR_.push(right[i] + feedback * lastR_);
+        float flangedL = delayL_.readLinear(delaySamples);
+        float flangedR = delayR_.readLinear(delaySamples);
+        lastL_ = flangedL;
+        lastR_ = flangedR;
 
         // Mix
-        left[i]  = left[i]  * (1.0f - mix_) + flangedL * mix_;
-        right[i] = right[i] * (1.0f - mix_) + flangedR * mix_;
-
-        delayIdx_ = (delayIdx_ + 1) % maxDelaySamples_;
+        float mix = mix_.next();
+        left[i]  = left[i]  * (1.0f - mix) + flangedL * mix;
+        right[i] = right[i] * (1.0f - mix) + flangedR * mix;
     }
 }
 
+float DSPBlockFlanger::getTailSeconds() const {
+    return feedbackDecaySeconds(float(maxDelaySamples_) / sampleRate_, params_.get(2));
+}
+
 std::vector<DSPParamDescriptor> DSPBlockFlanger::getParamDescriptors() {
     return {
         { "Speed", DSPParamType::Float, DSControlType::Dial, 0.05f, 2.0f, 0.3f },
@@ -62,20 +76,9 @@ std::vector<DSPParamDescriptor> DSPBlockFlanger::getParamDescriptors() {
 }
 
 float DSPBlockFlanger::getParamValue(size_t idx) const {
-    switch (idx) {
-        case 0: return speed_;
-        case 1: return depth_;
-        case 2: return feedback_;
-        case 3: return mix_;
-        default: return 0.0f;
-    }
+    return params_.get(idx);
 }
 
 void DSPBlockFlanger::setParamValue(size_t idx, float value) {
-    switch (idx) {
-        case 0: speed_ = value; break;
-        case 1: depth_ = value; break;
-        case 2: feedback_ = value; break;
-        case 3: mix_ = value; break;
-    }
-}
\ No newline at end of file
+    params_.set(idx, value);
+}
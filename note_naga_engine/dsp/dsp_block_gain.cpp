@@ -1,10 +1,35 @@
 #include <note_naga_engine/dsp/dsp_block_gain.h>
 
+#include <note_naga_engine/core/dsp_vector_math.h>
+
+#include <cmath>
+
+// Length of the gain ramp after a parameter change
+static constexpr size_t PARAM_RAMP_FRAMES = 512;
+
+DSPBlockGain::DSPBlockGain(float gain) {
+    params_.set(0, gain);
+    updateParams(0);
+}
+
+void DSPBlockGain::updateParams(size_t rampFrames) {
+    if (!params_.consume()) return;
+    gain_.setTarget(powf(10.0f, params_.get(0)), rampFrames);
+}
+
 void DSPBlockGain::process(float *left, float *right, size_t numFrames) {
     if (!isActive()) return;
-    if (gain_ == 0.0f) return; // No change needed
-    float appliedGain = powf(10.0f, gain_);
+    updateParams(PARAM_RAMP_FRAMES);
+
+    if (!gain_.isSmoothing()) {
+        float appliedGain = gain_.getCurrent();
+        if (appliedGain == 1.0f) return; // No change needed
+        nn_vec_scale(left, appliedGain, numFrames);
+        nn_vec_scale(right, appliedGain, numFrames);
+        return;
+    }
     for (size_t i = 0; i < numFrames; ++i) {
+        float appliedGain = gain_.next();
         left[i] *= appliedGain;
         right[i] *= appliedGain;
     }
@@ -17,10 +42,9 @@ std::vector<DSPParamDescriptor> DSPBlockGain::getParamDescriptors() {
 }
 
 float DSPBlockGain::getParamValue(size_t idx) const {
-    if (idx == 0) return gain_;
-    return 0.0f;
+    return params_.get(idx);
 }
 
 void DSPBlockGain::setParamValue(size_t idx, float value) {
-    if (idx == 0) gain_ = value;
-}
\ No newline at end of file
+    params_.set(idx, value);
+}
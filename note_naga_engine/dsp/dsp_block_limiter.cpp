@@ -1,12 +1,212 @@
 #include <note_naga_engine/dsp/dsp_block_limiter.h>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 
+namespace {
+
+constexpr size_t TP_PHASES = 4;
+
+double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+// Polyphase 4x interpolator (Kaiser windowed sinc cut at the base Nyquist), phase k of
+// input n estimates the signal at n - TAPS / 2 + (k + 1) / 4, so the four phases cover
+// the interval after the previous sample up to and including sample n - TAPS / 2 + 1.
+// Taps are reversed for a forward dot product over the history (oldest sample first).
+// Every phase is normalized to unity DC gain.
+template <size_t TAPS>
+const std::array<std::array<float, TAPS>, TP_PHASES> &true_peak_phases() {
+    static const std::array<std::array<float, TAPS>, TP_PHASES> phases = []() {
+        constexpr size_t N = TAPS * TP_PHASES - 1; // odd length, centered on a sample
+        const double center = double(N - 1) / 2.0;
+        const double beta = 6.0;
+        std::array<std::array<float, TAPS>, TP_PHASES> p{};
+        for (size_t k = 0; k < TP_PHASES; ++k) {
+            double sum = 0.0;
+            std::array<double, TAPS> h{};
+            for (size_t m = 0; m < TAPS; ++m) {
+                const size_t j = k + TP_PHASES * m;
+                if (j >= N) continue;
+                const double t = (double(j) - center) / double(TP_PHASES);
+                const double sinc = t == 0.0 ? 1.0 : std::sin(M_PI * t) / (M_PI * t);
+                const double r = (double(j) - center) / (center + 1.0);
+                h[m] = sinc * bessel_i0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / bessel_i0(beta);
+                sum += h[m];
+            }
+            for (size_t m = 0; m < TAPS; ++m) p[k][TAPS - 1 - m] = float(h[m] / sum);
+        }
+        return p;
+    }();
+    return phases;
+}
+
+} // namespace
+
+DSPBlockLimiter::DSPBlockLimiter(float threshold, float release, float makeup) {
+    params_.set(0, threshold);
+    params_.set(1, release);
+    params_.set(2, makeup);
+    params_.set(3, 0.0f);
+    params_.set(4, 2.0f);
+    prepare(NN_DSP_DEFAULT_SAMPLE_RATE, NN_DSP_DEFAULT_BLOCK_FRAMES);
+}
+
+void DSPBlockLimiter::prepare(float sampleRate, size_t /*maxBlockFrames*/) {
+    sampleRate_ = sampleRate;
+
+    // Everything the true peak mode needs for the longest lookahead
+    maxLookaheadFrames_ = lookaheadFrames(MAX_LOOKAHEAD_MS);
+    delayL_.setMaxDelay(maxLookaheadFrames_ + TRUE_PEAK_DELAY);
+    delayR_.setMaxDelay(maxLookaheadFrames_ + TRUE_PEAK_DELAY);
+    historyL_.assign(2 * TRUE_PEAK_TAPS, 0.0f);
+    historyR_.assign(2 * TRUE_PEAK_TAPS, 0.0f);
+    peakHold_.setMaxWindow(maxLookaheadFrames_ + 1);
+    peakRing_.assign(maxLookaheadFrames_ + 1, 0.0f);
+    gainRing_.assign(maxLookaheadFrames_ + 1, 1.0f);
+
+    // Buffers were reallocated, start the lookahead from silence
+    coeffMode_ = -1;
+    updateParams(true);
+}
+
+size_t DSPBlockLimiter::lookaheadFrames(float ms) const {
+    const float frames = std::round(std::clamp(ms, 0.0f, MAX_LOOKAHEAD_MS) * 0.001f * sampleRate_);
+    return std::max<size_t>(1, static_cast<size_t>(frames));
+}
+
+size_t DSPBlockLimiter::getLatencySamples() const {
+    return latencySamples_.load(std::memory_order_relaxed);
+}
+
+void DSPBlockLimiter::updateParams(bool force) {
+    const uint64_t changed = params_.consume();
+    if (!changed && !force) return;
+
+    // pow / exp only when a parameter changed
+    threshold_ = dB_to_linear(params_.get(0));
+    releaseCoeff_ = expf(-1.0f / (params_.get(1) * 0.001f * sampleRate_));
+    makeup_ = dB_to_linear(params_.get(2));
+
+    const int mode = std::clamp(static_cast<int>(params_.get(3)), 0, 1);
+    const size_t frames = lookaheadFrames(params_.get(4));
+    if (mode != coeffMode_) {
+        // The delay line is only fed in true peak mode, its content is stale
+        coeffMode_ = mode;
+        lookaheadFrames_ = frames;
+        resetLookahead();
+    } else if (frames != lookaheadFrames_) {
+        resizeLookahead(frames);
+    }
+    latencySamples_.store(coeffMode_ == 1 ? lookaheadFrames_ + TRUE_PEAK_DELAY : 0, std::memory_order_relaxed);
+}
+
+void DSPBlockLimiter::resetLookahead() {
+    delayL_.clear();
+    delayR_.clear();
+    std::fill(historyL_.begin(), historyL_.end(), 0.0f);
+    std::fill(historyR_.begin(), historyR_.end(), 0.0f);
+    historyPos_ = 0;
+    peakHold_.setWindow(lookaheadFrames_ + 1);
+    std::fill(peakRing_.begin(), peakRing_.end(), 0.0f);
+    std::fill(gainRing_.begin(), gainRing_.end(), 1.0f);
+    ringPos_ = 0;
+    gainWindowSum_ = double(lookaheadFrames_ + 1);
+    gainSmooth_ = 1.0f;
+}
+
+void DSPBlockLimiter::resizeLookahead(size_t frames) {
+    // The delay line keeps the longest lookahead, only its tap moves. The rings hold the
+    // peaks and gains of the longest window, so both windows are refilled exactly.
+    lookaheadFrames_ = frames;
+    const size_t window = frames + 1;
+    const size_t capacity = peakRing_.size();
+    peakHold_.setWindow(window);
+    for (size_t k = window; k > 0; --k) peakHold_.push(peakRing_[(ringPos_ + capacity - k) % capacity]);
+    rebuildGainSum();
+}
+
+void DSPBlockLimiter::rebuildGainSum() {
+    const size_t window = lookaheadFrames_ + 1;
+    const size_t capacity = gainRing_.size();
+    gainWindowSum_ = 0.0;
+    for (size_t k = 1; k <= window; ++k) gainWindowSum_ += double(gainRing_[(ringPos_ + capacity - k) % capacity]);
+}
+
+float DSPBlockLimiter::truePeak(const float *history) const {
+    // history: TRUE_PEAK_TAPS samples, oldest first
+    const auto &phases = true_peak_phases<TRUE_PEAK_TAPS>();
+    float peak = 0.0f;
+    for (size_t k = 0; k < TP_PHASES; ++k) {
+        float sum = 0.0f;
+        for (size_t m = 0; m < TRUE_PEAK_TAPS; ++m) sum += phases[k][m] * history[m];
+        peak = std::max(peak, std::fabs(sum));
+    }
+    return peak;
+}
+
+void DSPBlockLimiter::processLookahead(float* left, float* right, size_t numFrames) {
+    const float threshold = threshold_;
+    const float makeup = makeup_;
+    const float release_coeff = releaseCoeff_;
+    const size_t window = lookaheadFrames_ + 1;
+    const size_t capacity = gainRing_.size();
+    const size_t delay = lookaheadFrames_ + TRUE_PEAK_DELAY;
+    const float inv_window = 1.0f / float(window);
+
+    for (size_t i = 0; i < numFrames; ++i) {
+        // True peak of the newest input, lagging TRUE_PEAK_DELAY samples
+        historyPos_ = historyPos_ + 1 < TRUE_PEAK_TAPS ? historyPos_ + 1 : 0;
+        historyL_[historyPos_] = historyL_[historyPos_ + TRUE_PEAK_TAPS] = left[i];
+        historyR_[historyPos_] = historyR_[historyPos_ + TRUE_PEAK_TAPS] = right[i];
+        const float peak = std::max(truePeak(&historyL_[historyPos_ + 1]), truePeak(&historyR_[historyPos_ + 1]));
+
+        // Gain needed by the loudest peak of the window, averaged over the window: every
+        // averaged value is at most the gain the peak leaving the delay line needs
+        const float held = peakHold_.push(peak);
+        const float required = threshold / std::max(held, threshold);
+        // The gain leaving the window was written window samples ago
+        const size_t leaving = ringPos_ >= window ? ringPos_ - window : ringPos_ + capacity - window;
+        gainWindowSum_ += double(required) - double(gainRing_[leaving]);
+        gainRing_[ringPos_] = required;
+        peakRing_[ringPos_] = peak;
+        if (++ringPos_ == capacity) {
+            ringPos_ = 0;
+            // Rebuild the running sum once per ring turn so rounding errors cannot pile up
+            rebuildGainSum();
+        }
+        const float target = std::min(1.0f, float(gainWindowSum_) * inv_window);
+
+        // Instant attack (already ramped by the average), smooth release
+        if (target < gainSmooth_)
+            gainSmooth_ = target;
+        else
+            gainSmooth_ = gainSmooth_ * release_coeff + target * (1.0f - release_coeff);
+
+        delayL_.push(left[i]);
+        delayR_.push(right[i]);
+        left[i] = delayL_.read(delay) * gainSmooth_ * makeup;
+        right[i] = delayR_.read(delay) * gainSmooth_ * makeup;
+    }
+}
+
 void DSPBlockLimiter::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
-    float threshold = dB_to_linear(threshold_db_);
-    float makeup = dB_to_linear(makeup_db_);
-    float release_coeff = expf(-1.0f / (release_ms_ * 0.001f * 44100.0f));
+    updateParams();
+    if (coeffMode_ == 1) {
+        processLookahead(left, right, numFrames);
+        return;
+    }
+    const float threshold = threshold_;
+    const float makeup = makeup_;
+    const float release_coeff = releaseCoeff_;
 
     for (size_t i = 0; i < numFrames; ++i) {
         float peak = std::max(std::fabs(left[i]), std::fabs(right[i]));
@@ -29,23 +229,20 @@ std::vector<DSPParamDescriptor> DSPBlockLimiter::getParamDescriptors() {
     return {
         { "Threshold", DSPParamType::Float, DSControlType::SliderVertical, -40.0f, 0.0f, -5.0f },
         { "Release",   DSPParamType::Float, DSControlType::DialCentered, 5.0f, 200.0f, 50.0f },
-        { "Makeup",    DSPParamType::Float, DSControlType::DialCentered, -12.0f, 12.0f, 0.0f }
+        { "Makeup",    DSPParamType::Float, DSControlType::DialCentered, -12.0f, 12.0f, 0.0f },
+        { "Mode",      DSPParamType::Int, DSControlType::Dial, 0.0f, 1.0f, 0.0f, {"Reactive", "True Peak"} },
+        { "Lookahead", DSPParamType::Float, DSControlType::Dial, 0.5f, MAX_LOOKAHEAD_MS, 2.0f }
     };
 }
 
 float DSPBlockLimiter::getParamValue(size_t idx) const {
-    switch (idx) {
-        case 0: return threshold_db_;
-        case 1: return release_ms_;
-        case 2: return makeup_db_;
-        default: return 0.0f;
-    }
+    return params_.get(idx);
 }
 
 void DSPBlockLimiter::setParamValue(size_t idx, float value) {
     switch (idx) {
-        case 0: threshold_db_ = value; break;
-        case 1: release_ms_ = value; break;
-        case 2: makeup_db_ = value; break;
+        case 3: value = static_cast<float>(std::clamp(static_cast<int>(value), 0, 1)); break;
+        case 4: value = std::clamp(value, 0.5f, MAX_LOOKAHEAD_MS); break;
     }
-}
\ No newline at end of file
+    params_.set(idx, value);
+}
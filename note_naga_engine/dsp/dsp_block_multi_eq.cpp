@@ -1,87 +1,56 @@
 #include <note_naga_engine/dsp/dsp_block_multi_eq.h>
 
-DSPBlockMultiSimpleEQ::DSPBlockMultiSimpleEQ(const std::vector<float>& freqs, float q) {
+// Length of the gain ramp after a parameter change
+static constexpr size_t GAIN_RAMP_FRAMES = 2048;
+
+DSPBlockMultiSimpleEQ::DSPBlockMultiSimpleEQ(const std::vector<float>& freqs, float q)
+    : params_(freqs.size()) {
     for (float f : freqs) {
         Band b;
         b.freq = f;
         b.gain = 0.0f;
         b.q = q;
+        b.gainRamp.reset(0.0f);
         bands_.push_back(b);
     }
+    params_.consume();
+    cascade_.setStageCount(bands_.size());
     for (size_t i = 0; i < bands_.size(); ++i)
         recalcCoeffs(int(i));
 }
 
-void DSPBlockMultiSimpleEQ::setSampleRate(float sr) {
-    sampleRate_ = sr;
+void DSPBlockMultiSimpleEQ::updateParams(size_t numFrames) {
+    uint64_t changed = params_.consume();
+    for (size_t i = 0; i < bands_.size(); ++i) {
+        Band &band = bands_[i];
+        if (NoteNagaDSPParamMailbox::isChanged(changed, i)) {
+            band.gainRamp.setTarget(params_.get(i), GAIN_RAMP_FRAMES);
+        }
+        if (!band.gainRamp.isSmoothing()) continue;
+
+        // Ramp the gain at block rate, one coefficient update per block
+        band.gain = band.gainRamp.skip(numFrames);
+        recalcCoeffs(int(i));
+    }
+}
+
+void DSPBlockMultiSimpleEQ::prepare(float sampleRate, size_t /*maxBlockFrames*/) {
+    sampleRate_ = sampleRate;
     for (size_t i = 0; i < bands_.size(); ++i)
         recalcCoeffs(int(i));
 }
 
 void DSPBlockMultiSimpleEQ::recalcCoeffs(int bandIdx) {
-    auto& band = bands_[bandIdx];
-    float A = std::pow(10.0f, band.gain / 40.0f);
-    float omega = 2.0f * float(M_PI) * band.freq / sampleRate_;
-    float sn = std::sin(omega);
-    float cs = std::cos(omega);
-    float alpha = sn / (2.0f * band.q);
-
-    float b0 = 1 + alpha*A;
-    float b1 = -2*cs;
-    float b2 = 1 - alpha*A;
-    float a0 = 1 + alpha/A;
-    float a1 = -2*cs;
-    float a2 = 1 - alpha/A;
-
-    // Normalize!
-    band.b0 = b0 / a0;
-    band.b1 = b1 / a0;
-    band.b2 = b2 / a0;
-    band.a1 = a1 / a0;
-    band.a2 = a2 / a0;
-    band.a0 = 1.0f;
-
-    // clear state to avoid clicks at param change
-    band.x1l = band.x2l = band.y1l = band.y2l = 0.0f;
-    band.x1r = band.x2r = band.y1r = band.y2r = 0.0f;
+    const Band &band = bands_[bandIdx];
+    cascade_.setCoeffs(size_t(bandIdx), nn_biquad_peak(sampleRate_, band.freq, band.gain, band.q));
 }
 
 void DSPBlockMultiSimpleEQ::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
+    updateParams(numFrames);
 
-    for (size_t i = 0; i < numFrames; ++i) {
-        float inL = left[i];
-        float inR = right[i];
-
-        // Process all bands in series (cascaded)
-        float outL = inL;
-        float outR = inR;
-
-        for (auto& band : bands_) {
-            // Left
-            float x0l = outL;
-            float y0l = band.b0*x0l + band.b1*band.x1l + band.b2*band.x2l
-                        - band.a1*band.y1l - band.a2*band.y2l;
-            outL = y0l;
-            band.x2l = band.x1l;
-            band.x1l = x0l;
-            band.y2l = band.y1l;
-            band.y1l = y0l;
-
-            // Right
-            float x0r = outR;
-            float y0r = band.b0*x0r + band.b1*band.x1r + band.b2*band.x2r
-                        - band.a1*band.y1r - band.a2*band.y2r;
-            outR = y0r;
-            band.x2r = band.x1r;
-            band.x1r = x0r;
-            band.y2r = band.y1r;
-            band.y1r = y0r;
-        }
-
-        left[i] = outL;
-        right[i] = outR;
-    }
+    // Process all bands in series (cascaded)
+    cascade_.process(left, right, numFrames);
 }
 
 std::vector<DSPParamDescriptor> DSPBlockMultiSimpleEQ::getParamDescriptors() {
@@ -92,20 +61,15 @@ std::vector<DSPParamDescriptor> DSPBlockMultiSimpleEQ::getParamDescriptors() {
             snprintf(name, sizeof(name), "%.0f kHz", bands_[i].freq / 1000.0f);
         else
             snprintf(name, sizeof(name), "%.0f Hz", bands_[i].freq);
-        descs.push_back({ name, DSPParamType::Float, DSControlType::SliderVertical, -10.0f, 10.0f, bands_[i].gain });
+        descs.push_back({ name, DSPParamType::Float, DSControlType::SliderVertical, -10.0f, 10.0f, 0.0f });
     }
     return descs;
 }
 
 float DSPBlockMultiSimpleEQ::getParamValue(size_t idx) const {
-    if (idx < bands_.size())
-        return bands_[idx].gain;
-    return 0.0f;
+    return params_.get(idx);
 }
 
 void DSPBlockMultiSimpleEQ::setParamValue(size_t idx, float value) {
-    if (idx < bands_.size()) {
-        bands_[idx].gain = value;
-        recalcCoeffs(int(idx));
-    }
+    params_.set(idx, value);
 }
\ No newline at end of file
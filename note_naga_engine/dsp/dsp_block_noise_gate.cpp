@@ -3,18 +3,40 @@
 #include <cmath>
 
 DSPBlockNoiseGate::DSPBlockNoiseGate(float threshold, float attack, float release)
-    : threshold_(threshold), attack_(attack), release_(release)
-{}
+{
+    params_.set(0, threshold);
+    params_.set(1, attack);
+    params_.set(2, release);
+    prepare(NN_DSP_DEFAULT_SAMPLE_RATE, NN_DSP_DEFAULT_BLOCK_FRAMES);
+}
+
+void DSPBlockNoiseGate::prepare(float sampleRate, size_t /*maxBlockFrames*/) {
+    sampleRate_ = sampleRate;
+    // The coefficients depend on the sample rate, recompute even without a change
+    params_.consume();
+    updateCoefficients();
+}
+
+void DSPBlockNoiseGate::updateCoefficients() {
+    // Convert threshold to linear
+    threshLinear_ = std::pow(10.0f, params_.get(0) / 20.0f);
+    attackCoef_ = std::exp(-1.0f / (params_.get(1) * 0.001f * sampleRate_));
+    releaseCoef_ = std::exp(-1.0f / (params_.get(2) * 0.001f * sampleRate_));
+}
 
 void DSPBlockNoiseGate::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
-    // Convert threshold to linear
-    float threshLinear = std::pow(10.0f, threshold_ / 20.0f);
-    float attackCoef = std::exp(-1.0f / (attack_ * 0.001f * sampleRate_));
-    float releaseCoef = std::exp(-1.0f / (release_ * 0.001f * sampleRate_));
+    // pow / exp only when a parameter changed
+    if (params_.consume()) updateCoefficients();
+    const float threshLinear = threshLinear_;
+    const float attackCoef = attackCoef_;
+    const float releaseCoef = releaseCoef_;
+    // Gate opens on the sidechain when the engine routes one (keyed gate)
+    const float *key_left = getSidechainLeft() ? getSidechainLeft() : left;
+    const float *key_right = getSidechainRight() ? getSidechainRight() : right;
 
     for (size_t i = 0; i < numFrames; ++i) {
-        float in = 0.5f * (std::fabs(left[i]) + std::fabs(right[i]));
+        float in = 0.5f * (std::fabs(key_left[i]) + std::fabs(key_right[i]));
         float target = (in > threshLinear) ? 1.0f : 0.0f;
         if (target > gain_)
             gain_ = attackCoef * gain_ + (1.0f - attackCoef) * target;
@@ -35,18 +57,9 @@ std::vector<DSPParamDescriptor> DSPBlockNoiseGate::getParamDescriptors() {
 }
 
 float DSPBlockNoiseGate::getParamValue(size_t idx) const {
-    switch (idx) {
-        case 0: return threshold_;
-        case 1: return attack_;
-        case 2: return release_;
-        default: return 0.0f;
-    }
+    return params_.get(idx);
 }
 
 void DSPBlockNoiseGate::setParamValue(size_t idx, float value) {
-    switch (idx) {
-        case 0: threshold_ = value; break;
-        case 1: attack_ = value; break;
-        case 2: release_ = value; break;
-    }
-}
\ No newline at end of file
+    params_.set(idx, value);
+}
@@ -1,20 +1,41 @@
 #include <note_naga_engine/dsp/dsp_block_pan.h>
 
+#include <note_naga_engine/core/dsp_vector_math.h>
+
 #include <cmath>
 
+// Length of the gain ramps after a parameter change
+static constexpr size_t PARAM_RAMP_FRAMES = 512;
+
+DSPBlockPan::DSPBlockPan(float pan) {
+    params_.set(0, pan);
+    updateParams(0);
+}
+
+void DSPBlockPan::updateParams(size_t rampFrames) {
+    if (!params_.consume()) return;
+    float pan = params_.get(0);
+    leftGain_.setTarget(std::cos(0.25f * M_PI * (pan + 1.0f)), rampFrames);
+    rightGain_.setTarget(std::sin(0.25f * M_PI * (pan + 1.0f)), rampFrames);
+}
+
 void DSPBlockPan::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
-    float leftGain = std::cos(0.25f * M_PI * (pan_ + 1.0f));
-    float rightGain = std::sin(0.25f * M_PI * (pan_ + 1.0f));
+    updateParams(PARAM_RAMP_FRAMES);
+
+    if (!leftGain_.isSmoothing() && !rightGain_.isSmoothing()) {
+        nn_vec_scale(left, leftGain_.getCurrent(), numFrames);
+        nn_vec_scale(right, rightGain_.getCurrent(), numFrames);
+        return;
+    }
     for (size_t i = 0; i < numFrames; ++i) {
-        float l = left[i], r = right[i];
-        left[i] = l * leftGain;
-        right[i] = r * rightGain;
+        left[i] *= leftGain_.next();
+        right[i] *= rightGain_.next();
     }
 }
 
 std::vector<DSPParamDescriptor> DSPBlockPan::getParamDescriptors() {
     return { DSPParamDescriptor{ "Pan", DSPParamType::Float, DSControlType::DialCentered, -1.0f, 1.0f, 0.0f } };
 }
-float DSPBlockPan::getParamValue(size_t idx) const { return idx == 0 ? pan_ : 0.0f; }
-void DSPBlockPan::setParamValue(size_t idx, float value) { if (idx == 0) pan_ = value; }
\ No newline at end of file
+float DSPBlockPan::getParamValue(size_t idx) const { return params_.get(idx); }
+void DSPBlockPan::setParamValue(size_t idx, float value) { params_.set(idx, value); }
@@ -1,27 +1,54 @@
 #include <note_naga_engine/dsp/dsp_block_phaser.h>
 
+#include <note_naga_engine/core/dsp_fast_math.h>
+
 #include <cmath>
 
+// Length of the depth / feedback / mix ramps after a parameter change
+static constexpr size_t PARAM_RAMP_FRAMES = 512;
+
 DSPBlockPhaser::DSPBlockPhaser(float speed, float depth, float feedback, float mix)
-    : speed_(speed), depth_(depth), feedback_(feedback), mix_(mix)
-{}
+{
+    params_.set(0, speed);
+    params_.set(1, depth);
+    params_.set(2, feedback);
+    params_.set(3, mix);
+    updateParams(0);
+}
+
+void DSPBlockPhaser::updateParams(size_t rampFrames) {
+    if (!params_.consume()) return;
+    speed_ = params_.get(0);
+    depth_.setTarget(params_.get(1), rampFrames);
+    feedback_.setTarget(params_.get(2), rampFrames);
+    mix_.setTarget(params_.get(3), rampFrames);
+    lfo_.setRate(speed_, sampleRate_);
+}
+
+void DSPBlockPhaser::prepare(float sampleRate, size_t /*maxBlockFrames*/) {
+    sampleRate_ = sampleRate;
+
+    // Take pending parameters without ramps, the LFO rate depends on the sample rate
+    updateParams(0);
+    lfo_.setRate(speed_, sampleRate_);
+}
 
 void DSPBlockPhaser::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
+    updateParams(PARAM_RAMP_FRAMES);
 
     for (size_t i = 0; i < numFrames; ++i) {
         // LFO: sweep center freq between ~400Hz .. 1600Hz
-        float lfo = std::sin(2.0f * M_PI * lfoPhase_);
-        lfoPhase_ += speed_ / sampleRate_;
-        if (lfoPhase_ > 1.0f) lfoPhase_ -= 1.0f;
+        float lfo = lfo_.next();
 
         float minF = 400.0f, maxF = 1600.0f;
-        float centerF = minF + (maxF - minF) * (depth_ * (lfo + 1.0f) * 0.5f);
+        float centerF = minF + (maxF - minF) * (depth_.next() * (lfo + 1.0f) * 0.5f);
         float omega = 2.0f * M_PI * centerF / sampleRate_;
-        float a = (1.0f - std::sin(omega)) / std::cos(omega);
+        float a = (1.0f - nn_fast_sin(omega)) / nn_fast_cos(omega);
 
         // Left channel
-        float xL = left[i] + prevOutL_ * feedback_;
+        float feedback = feedback_.next();
+        float xL = left[i] + prevOutL_ * feedback;
         for (int st = 0; st < stages_; ++st) {
             float yL = -a * xL + zL_[st];
             zL_[st] = xL + a * yL;
@@ -30,7 +57,7 @@ void DSPBlockPhaser::process(float* left, float* right, size_t numFrames) {
         prevOutL_ = xL;
 
         // Right channel
-        float xR = right[i] + prevOutR_ * feedback_;
+        float xR = right[i] + prevOutR_ * feedback;
         for (int st = 0; st < stages_; ++st) {
             float yR = -a * xR + zR_[st];
             zR_[st] = xR + a * yR;
@@ -39,11 +66,17 @@ void DSPBlockPhaser::process(float* left, float* right, size_t numFrames) {
         prevOutR_ = xR;
 
         // Mix
-        left[i]  = left[i]  * (1.0f - mix_) + xL * mix_;
-        right[i] = right[i] * (1.0f - mix_) + xR * mix_;
+        float mix = mix_.next();
+        left[i]  = left[i]  * (1.0f - mix) + xL * mix;
+        right[i] = right[i] * (1.0f - mix) + xR * mix;
     }
 }
 
+float DSPBlockPhaser::getTailSeconds() const {
+    // Allpass stages ring for a few ms, the output feedback loop is one sample long
+    return 0.01f + feedbackDecaySeconds(1.0f / sampleRate_, params_.get(2));
+}
+
 std::vector<DSPParamDescriptor> DSPBlockPhaser::getParamDescriptors() {
     return {
         { "Speed", DSPParamType::Float, DSControlType::Dial, 0.1f, 3.0f, 0.6f },
@@ -54,20 +87,9 @@ std::vector<DSPParamDescriptor> DSPBlockPhaser::getParamDescriptors() {
 }
 
 float DSPBlockPhaser::getParamValue(size_t idx) const {
-    switch (idx) {
-        case 0: return speed_;
-        case 1: return depth_;
-        case 2: return feedback_;
-        case 3: return mix_;
-        default: return 0.0f;
-    }
+    return params_.get(idx);
 }
 
 void DSPBlockPhaser::setParamValue(size_t idx, float value) {
-    switch (idx) {
-        case 0: speed_ = value; break;
-        case 1: depth_ = value; break;
-        case 2: feedback_ = value; break;
-        case 3: mix_ = value; break;
-    }
-}
\ No newline at end of file
+    params_.set(idx, value);
+}
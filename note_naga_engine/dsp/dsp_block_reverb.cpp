@@ -2,12 +2,23 @@
 
 #include <algorithm>
 
+// Comb filter lengths (in samples at room size 1.0, prime numbers for less resonance)
+static const size_t COMB_LENS_L[4] = {1116, 1188, 1277, 1356};
+static const size_t COMB_LENS_R[4] = {1139, 1211, 1300, 1387};
+static const size_t ALLPASS_LENS[2] = {225, 556};
+// Maximum predelay in ms (range of the Predelay parameter)
+static constexpr float MAX_PREDELAY_MS = 100.0f;
+// Length of parameter ramps after a change
+static constexpr size_t PARAM_RAMP_FRAMES = 1024;
+// Length of the comb length / feedback glide after a room size change
+static constexpr size_t ROOM_RAMP_FRAMES = 4096;
+
 // Comb filter implementation
-float DSPBlockReverb::CombFilter::process(float inp) {
-    float y = buf[idx];
+float DSPBlockReverb::CombFilter::process(float inp, float feedback) {
+    // Output of the sample written len samples ago, interpolated while the length glides
+    float y = len.isSmoothing() ? line.readLinear(len.next() - 1.0f) : line.read(size_t(len.getCurrent()) - 1);
     filter_store = y * damp2 + filter_store * damp1;
-    buf[idx] = inp + filter_store * feedback;
-    if (++idx >= buf.size()) idx = 0;
+    line.push(inp + filter_store * feedback);
     return y;
 }
 
@@ -20,29 +31,39 @@ float DSPBlockReverb::AllpassFilter::process(float inp) {
     return y;
 }
 
-DSPBlockReverb::DSPBlockReverb(float roomsize, float damping, float wet, float predelay)
-    : roomsize_(roomsize), damping_(damping), wet_(wet), predelay_(predelay) {
-    setSampleRate(44100.0f);
-    updateFilters();
+DSPBlockReverb::DSPBlockReverb(float roomsize, float damping, float wet, float predelay) {
+    params_.set(0, roomsize);
+    params_.set(1, damping);
+    params_.set(2, wet);
+    params_.set(3, predelay);
+    prepare(NN_DSP_DEFAULT_SAMPLE_RATE, NN_DSP_DEFAULT_BLOCK_FRAMES);
 }
 
 void DSPBlockReverb::process(float *left, float *right, size_t numFrames) {
     if (!isActive()) return;
+    updateParams();
 
+    const size_t predelayBufLen = predelayBufL_.size();
     for (size_t i = 0; i < numFrames; ++i) {
-        // predelay
+        // predelay (fractional read, so predelay changes are glide instead of jump)
         predelayBufL_[predelayIdx_] = left[i];
         predelayBufR_[predelayIdx_] = right[i];
-        float inL = predelayBufL_[(predelayIdx_ + 1) % predelayLen_];
-        float inR = predelayBufR_[(predelayIdx_ + 1) % predelayLen_];
-        if (++predelayIdx_ >= predelayLen_) predelayIdx_ = 0;
+        float delay = predelayRamp_.next();
+        size_t delayInt = size_t(delay);
+        float frac = delay - float(delayInt);
+        size_t r0 = predelayIdx_ >= delayInt ? predelayIdx_ - delayInt : predelayIdx_ + predelayBufLen - delayInt;
+        size_t r1 = r0 == 0 ? predelayBufLen - 1 : r0 - 1;
+        float inL = predelayBufL_[r0] + (predelayBufL_[r1] - predelayBufL_[r0]) * frac;
+        float inR = predelayBufR_[r0] + (predelayBufR_[r1] - predelayBufR_[r0]) * frac;
+        if (++predelayIdx_ >= predelayBufLen) predelayIdx_ = 0;
 
         // Process combs (parallel, sum)
+        float feedback = feedbackRamp_.next();
         float outL = 0.0f, outR = 0.0f;
         for (size_t c = 0; c < combL_.size(); ++c)
-            outL += combL_[c].process(inL);
+            outL += combL_[c].process(inL, feedback);
         for (size_t c = 0; c < combR_.size(); ++c)
-            outR += combR_[c].process(inR);
+            outR += combR_[c].process(inR, feedback);
 
         // Process allpass (serial)
         for (size_t a = 0; a < allpassL_.size(); ++a)
@@ -51,11 +72,38 @@ void DSPBlockReverb::process(float *left, float *right, size_t numFrames) {
             outR = allpassR_[a].process(outR);
 
         // Mix dry/wet
-        left[i] = left[i] * (1.0f - wet_) + outL * wet_ * 0.3f;
-        right[i] = right[i] * (1.0f - wet_) + outR * wet_ * 0.3f;
+        float wet = wetRamp_.next();
+        left[i] = left[i] * (1.0f - wet) + outL * wet * 0.3f;
+        right[i] = right[i] * (1.0f - wet) + outR * wet * 0.3f;
     }
 }
 
+void DSPBlockReverb::updateParams() {
+    uint64_t changed = params_.consume();
+    if (!changed) return;
+
+    roomsize_ = std::clamp(params_.get(0), 0.1f, 1.0f);
+    damping_ = std::clamp(params_.get(1), 0.0f, 1.0f);
+    wet_ = std::clamp(params_.get(2), 0.0f, 1.0f);
+    predelay_ = std::clamp(params_.get(3), 0.0f, MAX_PREDELAY_MS);
+
+    wetRamp_.setTarget(wet_, PARAM_RAMP_FRAMES);
+    predelayRamp_.setTarget(predelay_ * 0.001f * sampleRate_, PARAM_RAMP_FRAMES);
+    if (NoteNagaDSPParamMailbox::isChanged(changed, 0) || NoteNagaDSPParamMailbox::isChanged(changed, 1)) {
+        updateFilters();
+    }
+}
+
+float DSPBlockReverb::getTailSeconds() const {
+    // Longest comb loop decays slowest, the allpass diffusion adds its own short tail
+    float roomsize = std::clamp(params_.get(0), 0.1f, 1.0f);
+    float predelay = std::clamp(params_.get(3), 0.0f, MAX_PREDELAY_MS);
+    float combLoop = float(COMB_LENS_R[3]) * roomsize / 44100.0f;
+    float allpassLoop = float(ALLPASS_LENS[1]) / 44100.0f;
+    return predelay * 0.001f + feedbackDecaySeconds(combLoop, 0.7f + roomsize * 0.25f) +
+           feedbackDecaySeconds(allpassLoop, 0.5f);
+}
+
 std::vector<DSPParamDescriptor> DSPBlockReverb::getParamDescriptors() {
     return {{"Room Size", DSPParamType::Float, DSControlType::DialCentered, 0.1f, 1.0f, 0.7f},
             {"Damping", DSPParamType::Float, DSControlType::DialCentered, 0.0f, 1.0f, 0.5f},
@@ -64,84 +112,71 @@ std::vector<DSPParamDescriptor> DSPBlockReverb::getParamDescriptors() {
 }
 
 float DSPBlockReverb::getParamValue(size_t idx) const {
-    switch (idx) {
-    case 0:
-        return roomsize_;
-    case 1:
-        return damping_;
-    case 2:
-        return wet_;
-    case 3:
-        return predelay_;
-    default:
-        return 0.0f;
-    }
+    return params_.get(idx);
 }
 
 void DSPBlockReverb::setParamValue(size_t idx, float value) {
-    switch (idx) {
-    case 0:
-        roomsize_ = value;
-        updateFilters();
-        break;
-    case 1:
-        damping_ = value;
-        updateFilters();
-        break;
-    case 2:
-        wet_ = value;
-        break;
-    case 3:
-        predelay_ = value;
-        updateFilters();
-        break;
-    }
+    params_.set(idx, value);
 }
 
-void DSPBlockReverb::setSampleRate(float sr) {
-    sampleRate_ = sr;
-    updateFilters();
+void DSPBlockReverb::prepare(float sampleRate, size_t /*maxBlockFrames*/) {
+    sampleRate_ = sampleRate;
+    allocateBuffers();
+
+    // Apply all parameters again for the new buffers
+    params_.set(0, params_.get(0));
+    updateParams();
+    wetRamp_.reset(wet_);
+    predelayRamp_.reset(predelay_ * 0.001f * sampleRate_);
+    feedbackRamp_.reset(feedbackRamp_.getTarget());
+    for (int i = 0; i < 4; ++i) {
+        combL_[i].len.reset(combL_[i].len.getTarget());
+        combR_[i].len.reset(combR_[i].len.getTarget());
+    }
 }
 
-void DSPBlockReverb::updateFilters() {
-    // Comb filter lengths (in samples, prime numbers for less resonance)
-    static const size_t combLensL[4] = {1116, 1188, 1277, 1356};
-    static const size_t combLensR[4] = {1139, 1211, 1300, 1387};
-    static const size_t allpassLens[2] = {225, 556};
-
-    // Calculate predelay length
-    predelayLen_ = std::clamp<size_t>(predelay_ * 0.001f * sampleRate_, 1, sampleRate_);
-    predelayBufL_.resize(predelayLen_, 0.0f);
-    predelayBufR_.resize(predelayLen_, 0.0f);
+void DSPBlockReverb::allocateBuffers() {
+    // Predelay buffer for the maximum predelay plus interpolation headroom
+    size_t predelayBufLen = size_t(MAX_PREDELAY_MS * 0.001f * sampleRate_) + 2;
+    predelayBufL_.assign(predelayBufLen, 0.0f);
+    predelayBufR_.assign(predelayBufLen, 0.0f);
     predelayIdx_ = 0;
 
-    // Comb filters
+    // Comb filters, sized for the largest room (lengths scaled to the sample rate)
+    float srScale = sampleRate_ / 44100.0f;
     combL_.resize(4);
     combR_.resize(4);
     for (int i = 0; i < 4; ++i) {
-        size_t lenL = static_cast<size_t>(combLensL[i] * roomsize_);
-        size_t lenR = static_cast<size_t>(combLensR[i] * roomsize_);
-        combL_[i].resize(std::max<size_t>(lenL, 1));
-        combR_[i].resize(std::max<size_t>(lenR, 1));
-        // Feedback and damping
-        combL_[i].feedback = 0.7f + roomsize_ * 0.25f;
-        combR_[i].feedback = 0.7f + roomsize_ * 0.25f;
-        combL_[i].damp = damping_;
-        combR_[i].damp = damping_;
-        combL_[i].damp1 = damping_;
-        combR_[i].damp1 = damping_;
-        combL_[i].damp2 = 1.0f - damping_;
-        combR_[i].damp2 = 1.0f - damping_;
+        combL_[i].allocate(std::max<size_t>(size_t(COMB_LENS_L[i] * srScale), 1));
+        combR_[i].allocate(std::max<size_t>(size_t(COMB_LENS_R[i] * srScale), 1));
     }
 
     // Allpass filters
     allpassL_.resize(2);
     allpassR_.resize(2);
     for (int i = 0; i < 2; ++i) {
-        size_t len = allpassLens[i];
-        allpassL_[i].resize(len);
-        allpassR_[i].resize(len);
+        size_t len = std::max<size_t>(size_t(ALLPASS_LENS[i] * srScale), 1);
+        allpassL_[i].allocate(len);
+        allpassR_[i].allocate(len);
         allpassL_[i].feedback = 0.5f;
         allpassR_[i].feedback = 0.5f;
     }
-}
\ No newline at end of file
+}
+
+void DSPBlockReverb::updateFilters() {
+    // Only lengths within the preallocated buffers and coefficients change here, the
+    // lengths and the feedback glide to the new room size
+    float srScale = sampleRate_ / 44100.0f;
+    feedbackRamp_.setTarget(0.7f + roomsize_ * 0.25f, ROOM_RAMP_FRAMES);
+    for (int i = 0; i < 4; ++i) {
+        size_t lenL = std::clamp<size_t>(size_t(COMB_LENS_L[i] * srScale * roomsize_), 1, combL_[i].maxLen);
+        size_t lenR = std::clamp<size_t>(size_t(COMB_LENS_R[i] * srScale * roomsize_), 1, combR_[i].maxLen);
+        combL_[i].len.setTarget(float(lenL), ROOM_RAMP_FRAMES);
+        combR_[i].len.setTarget(float(lenR), ROOM_RAMP_FRAMES);
+        // Damping
+        combL_[i].damp1 = damping_;
+        combR_[i].damp1 = damping_;
+        combL_[i].damp2 = 1.0f - damping_;
+        combR_[i].damp2 = 1.0f - damping_;
+    }
+}
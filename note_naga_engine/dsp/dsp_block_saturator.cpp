@@ -1,44 +1,81 @@
 #include <note_naga_engine/dsp/dsp_block_saturator.h>
 
+#include <note_naga_engine/core/dsp_fast_math.h>
+
+#include <algorithm>
 #include <cmath>
 
+// Length of the drive / mix ramps after a parameter change (base rate frames)
+static constexpr size_t PARAM_RAMP_FRAMES = 512;
+
 DSPBlockSaturator::DSPBlockSaturator(float drive, float mix)
-    : drive_(drive), mix_(mix)
-{}
+{
+    params_.set(0, drive);
+    params_.set(1, mix);
+    params_.set(2, 1.0f);
+    prepare(NN_DSP_DEFAULT_SAMPLE_RATE, NN_DSP_DEFAULT_BLOCK_FRAMES);
+}
 
 inline float saturate(float x, float drive) {
     // Soft clipping: tanh drive
-    return std::tanh(x * drive);
+    return nn_fast_tanh(x * drive);
+}
+
+void DSPBlockSaturator::prepare(float /*sampleRate*/, size_t maxBlockFrames) {
+    oversampler_.prepare(maxBlockFrames);
+    updateParams(0);
+}
+
+size_t DSPBlockSaturator::getLatencySamples() const {
+    return latencySamples_.load(std::memory_order_relaxed);
+}
+
+void DSPBlockSaturator::updateParams(size_t rampFrames) {
+    if (!params_.consume()) return;
+    // The factor and the reported latency change together at the block boundary
+    quality_ = std::clamp(static_cast<int>(params_.get(2)), 0, 3);
+    oversampler_.setFactor(1 << quality_);
+    latencySamples_.store(NoteNagaOversampler::latencyForFactor(1 << quality_), std::memory_order_relaxed);
+
+    // The ramps run at the oversampled rate
+    drive_.setTarget(params_.get(0), rampFrames * oversampler_.getFactor());
+    mix_.setTarget(params_.get(1), rampFrames * oversampler_.getFactor());
 }
 
 void DSPBlockSaturator::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
-    for (size_t i = 0; i < numFrames; ++i) {
-        float satL = saturate(left[i], drive_);
-        float satR = saturate(right[i], drive_);
-        left[i]  = left[i]  * (1.0f - mix_) + satL * mix_;
-        right[i] = right[i] * (1.0f - mix_) + satR * mix_;
-    }
+    updateParams(PARAM_RAMP_FRAMES);
+
+    const bool smoothing = drive_.isSmoothing() || mix_.isSmoothing();
+    float drive = drive_.getCurrent();
+    float mix = mix_.getCurrent();
+    oversampler_.process(left, right, numFrames, [&](float* l, float* r, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            if (smoothing) {
+                drive = drive_.next();
+                mix = mix_.next();
+            }
+            float satL = saturate(l[i], drive);
+            float satR = saturate(r[i], drive);
+            l[i] = l[i] * (1.0f - mix) + satL * mix;
+            r[i] = r[i] * (1.0f - mix) + satR * mix;
+        }
+    });
 }
 
 std::vector<DSPParamDescriptor> DSPBlockSaturator::getParamDescriptors() {
     return {
         { "Drive", DSPParamType::Float, DSControlType::Dial, 1.0f, 10.0f, 2.0f },
-        { "Mix",   DSPParamType::Float, DSControlType::DialCentered, 0.0f, 1.0f, 0.7f }
+        { "Mix",   DSPParamType::Float, DSControlType::DialCentered, 0.0f, 1.0f, 0.7f },
+        { "Quality", DSPParamType::Int, DSControlType::Dial, 0.0f, 3.0f, 1.0f, {"Off", "2x", "4x", "8x"} }
     };
 }
 
 float DSPBlockSaturator::getParamValue(size_t idx) const {
-    switch (idx) {
-        case 0: return drive_;
-        case 1: return mix_;
-        default: return 0.0f;
-    }
+    return params_.get(idx);
 }
 
 void DSPBlockSaturator::setParamValue(size_t idx, float value) {
-    switch (idx) {
-        case 0: drive_ = value; break;
-        case 1: mix_ = value; break;
-    }
-}
\ No newline at end of file
+    if (idx == 2) value = static_cast<float>(std::clamp(static_cast<int>(value), 0, 3));
+    params_.set(idx, value);
+}
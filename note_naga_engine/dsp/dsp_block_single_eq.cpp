@@ -3,68 +3,36 @@
 DSPBlockSingleEQ::DSPBlockSingleEQ(float freq, float gain, float q)
     : freq_(freq), gain_(gain), q_(q)
 {
+    params_.set(0, freq);
+    params_.set(1, gain);
+    params_.set(2, q);
+    params_.consume();
+    filter_.setStageCount(1);
     recalcCoeffs();
 }
 
-void DSPBlockSingleEQ::setSampleRate(float sr) {
-    sampleRate_ = sr;
+void DSPBlockSingleEQ::prepare(float sampleRate, size_t /*maxBlockFrames*/) {
+    sampleRate_ = sampleRate;
     recalcCoeffs();
 }
 
 void DSPBlockSingleEQ::recalcCoeffs() {
-    // RBJ peak EQ
-    float A = powf(10.0f, gain_ / 40.0f);
-    float omega = 2.0f * float(M_PI) * freq_ / sampleRate_;
-    float sn = sinf(omega);
-    float cs = cosf(omega);
-    float alpha = sn / (2.0f * q_);
-
-    float b0 = 1 + alpha*A;
-    float b1 = -2*cs;
-    float b2 = 1 - alpha*A;
-    float a0 = 1 + alpha/A;
-    float a1 = -2*cs;
-    float a2 = 1 - alpha/A;
-
-    // Normalize!
-    b0_ = b0 / a0;
-    b1_ = b1 / a0;
-    b2_ = b2 / a0;
-    a1_ = a1 / a0;
-    a2_ = a2 / a0;
-    a0_ = 1.0f; // always 1
-
-    // clear state to avoid clicks at param change
-    x1l_ = x2l_ = y1l_ = y2l_ = 0.0f;
-    x1r_ = x2r_ = y1r_ = y2r_ = 0.0f;
+    // RBJ peak EQ, filter state is kept to avoid clicks at param change
+    filter_.setCoeffs(0, nn_biquad_peak(sampleRate_, freq_, gain_, q_));
 }
 
 void DSPBlockSingleEQ::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
 
-    // coefficients should only be recalculated when param changes
-    // -> recalcCoeffs() volat jen v setParamValue!
-    // recalcCoeffs();
-
-    for (size_t i = 0; i < numFrames; ++i) {
-        // Left
-        float x0l = left[i];
-        float y0l = b0_*x0l + b1_*x1l_ + b2_*x2l_ - a1_*y1l_ - a2_*y2l_;
-        left[i] = y0l;
-        x2l_ = x1l_;
-        x1l_ = x0l;
-        y2l_ = y1l_;
-        y1l_ = y0l;
-
-        // Right
-        float x0r = right[i];
-        float y0r = b0_*x0r + b1_*x1r_ + b2_*x2r_ - a1_*y1r_ - a2_*y2r_;
-        right[i] = y0r;
-        x2r_ = x1r_;
-        x1r_ = x0r;
-        y2r_ = y1r_;
-        y1r_ = y0r;
+    // coefficients are only recalculated when a param changes
+    if (params_.consume()) {
+        freq_ = params_.get(0);
+        gain_ = params_.get(1);
+        q_ = params_.get(2);
+        recalcCoeffs();
     }
+
+    filter_.process(left, right, numFrames);
 }
 
 std::vector<DSPParamDescriptor> DSPBlockSingleEQ::getParamDescriptors() {
@@ -76,15 +44,9 @@ std::vector<DSPParamDescriptor> DSPBlockSingleEQ::getParamDescriptors() {
 }
 
 float DSPBlockSingleEQ::getParamValue(size_t idx) const {
-    if (idx == 0) return freq_;
-    if (idx == 1) return gain_;
-    if (idx == 2) return q_;
-    return 0.0f;
+    return params_.get(idx);
 }
 
 void DSPBlockSingleEQ::setParamValue(size_t idx, float value) {
-    if (idx == 0) freq_ = value;
-    if (idx == 1) gain_ = value;
-    if (idx == 2) q_ = value;
-    recalcCoeffs();
-}
\ No newline at end of file
+    params_.set(idx, value);
+}
@@ -1,24 +1,39 @@
 #include <note_naga_engine/dsp/dsp_block_stereo_imager.h>
 
+#include <note_naga_engine/core/dsp_vector_math.h>
+
+// Length of the width ramp after a parameter change
+static constexpr size_t PARAM_RAMP_FRAMES = 512;
+
 DSPBlockStereoImager::DSPBlockStereoImager(float width)
-    : width_(width)
-{}
+{
+    params_.set(0, width);
+    params_.consume();
+    width_.reset(width);
+}
 
 void DSPBlockStereoImager::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
+    if (params_.consume()) width_.setTarget(params_.get(0), PARAM_RAMP_FRAMES);
 
-    float sideGain = 1.0f + width_; // -1 (mono), 1 (max wide)
     float midGain = 1.0f;
-
+    if (!width_.isSmoothing()) {
+        float sideGain = 1.0f + width_.getCurrent(); // -1 (mono), 1 (max wide)
+
+        // left = mid + side, right = mid - side, written as one stereo matrix
+        float direct = 0.5f * (midGain + sideGain);
+        float cross = 0.5f * (midGain - sideGain);
+        nn_vec_stereo_matrix(left, right, direct, cross, cross, direct, numFrames);
+        return;
+    }
     for (size_t i = 0; i < numFrames; ++i) {
-        float mid = 0.5f * (left[i] + right[i]);
-        float side = 0.5f * (left[i] - right[i]);
-
-        side *= sideGain;
-        mid *= midGain;
-
-        left[i]  = mid + side;
-        right[i] = mid - side;
+        float sideGain = 1.0f + width_.next();
+        float direct = 0.5f * (midGain + sideGain);
+        float cross = 0.5f * (midGain - sideGain);
+        float l = left[i];
+        float r = right[i];
+        left[i] = l * direct + r * cross;
+        right[i] = l * cross + r * direct;
     }
 }
 
@@ -29,10 +44,9 @@ std::vector<DSPParamDescriptor> DSPBlockStereoImager::getParamDescriptors() {
 }
 
 float DSPBlockStereoImager::getParamValue(size_t idx) const {
-    if (idx == 0) return width_;
-    return 0.0f;
+    return params_.get(idx);
 }
 
 void DSPBlockStereoImager::setParamValue(size_t idx, float value) {
-    if (idx == 0) width_ = value;
-}
\ No newline at end of file
+    params_.set(idx, value);
+}
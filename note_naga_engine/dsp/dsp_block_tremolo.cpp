@@ -1,21 +1,34 @@
 #include <note_naga_engine/dsp/dsp_block_tremolo.h>
 
-#include <cmath>
+// Length of the depth / mix ramps after a parameter change
+static constexpr size_t PARAM_RAMP_FRAMES = 512;
 
-DSPBlockTremolo::DSPBlockTremolo(float speed, float depth, float mix)
-    : speed_(speed), depth_(depth), mix_(mix) {}
+DSPBlockTremolo::DSPBlockTremolo(float speed, float depth, float mix) {
+    params_.set(0, speed);
+    params_.set(1, depth);
+    params_.set(2, mix);
+    updateParams(0);
+}
+
+void DSPBlockTremolo::updateParams(size_t rampFrames) {
+    if (!params_.consume()) return;
+    speed_ = params_.get(0);
+    depth_.setTarget(params_.get(1), rampFrames);
+    mix_.setTarget(params_.get(2), rampFrames);
+    lfo_.setRate(speed_, sampleRate_);
+}
 
 void DSPBlockTremolo::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
-    float phaseInc = 2.0f * M_PI * speed_ / sampleRate_;
+    updateParams(PARAM_RAMP_FRAMES);
     for (size_t i = 0; i < numFrames; ++i) {
-        float lfo = (1.0f + std::sin(phase_)) * 0.5f; // 0..1
-        float gain = 1.0f - depth_ + lfo * depth_;
-        float dryGain = 1.0f - mix_;
-        left[i]  = left[i] * dryGain + left[i] * gain * mix_;
-        right[i] = right[i] * dryGain + right[i] * gain * mix_;
-        phase_ += phaseInc;
-        if (phase_ > 2.0f * M_PI) phase_ -= 2.0f * M_PI;
+        float lfo = (1.0f + lfo_.next()) * 0.5f; // 0..1
+        float depth = depth_.next();
+        float mix = mix_.next();
+        float gain = 1.0f - depth + lfo * depth;
+        float dryGain = 1.0f - mix;
+        left[i]  = left[i] * dryGain + left[i] * gain * mix;
+        right[i] = right[i] * dryGain + right[i] * gain * mix;
     }
 }
 
@@ -28,22 +41,17 @@ std::vector<DSPParamDescriptor> DSPBlockTremolo::getParamDescriptors() {
 }
 
 float DSPBlockTremolo::getParamValue(size_t idx) const {
-    switch (idx) {
-        case 0: return speed_;
-        case 1: return depth_;
-        case 2: return mix_;
-        default: return 0.0f;
-    }
+    return params_.get(idx);
 }
 
 void DSPBlockTremolo::setParamValue(size_t idx, float value) {
-    switch (idx) {
-        case 0: speed_ = value; break;
-        case 1: depth_ = value; break;
-        case 2: mix_ = value; break;
-    }
+    params_.set(idx, value);
 }
 
-void DSPBlockTremolo::setSampleRate(float sr) {
-    sampleRate_ = sr;
+void DSPBlockTremolo::prepare(float sampleRate, size_t /*maxBlockFrames*/) {
+    sampleRate_ = sampleRate;
+
+    // Take pending parameters without ramps, the LFO rate depends on the sample rate
+    updateParams(0);
+    lfo_.setRate(speed_, sampleRate_);
 }
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+
+#include <cstddef>
+
+/**
+ * @brief Normalized biquad coefficients (a0 = 1).
+ */
+struct NOTE_NAGA_ENGINE_API NN_BiquadCoeffs_t {
+    float b0 = 1.0f;
+    float b1 = 0.0f;
+    float b2 = 0.0f;
+    float a1 = 0.0f;
+    float a2 = 0.0f;
+};
+
+/**
+ * @brief State of one biquad (direct form I, which stays quiet when coefficients
+ * change while the filter runs).
+ */
+struct NOTE_NAGA_ENGINE_API NN_BiquadState_t {
+    float x1 = 0.0f;
+    float x2 = 0.0f;
+    float y1 = 0.0f;
+    float y2 = 0.0f;
+
+    /**
+     * @brief Filter one sample
+     */
+    inline float process(const NN_BiquadCoeffs_t &c, float x) {
+        float y = (c.b0 * x + (c.b1 * x1 + c.b2 * x2)) - (c.a1 * y1 + c.a2 * y2);
+        x2 = x1;
+        x1 = x;
+        y2 = y1;
+        y1 = y;
+        return y;
+    }
+};
+
+/**
+ * @brief RBJ cookbook peaking EQ
+ */
+NOTE_NAGA_ENGINE_API NN_BiquadCoeffs_t nn_biquad_peak(float sample_rate, float freq, float gain_db, float q);
+
+/**
+ * @brief RBJ cookbook low-pass filter
+ */
+NOTE_NAGA_ENGINE_API NN_BiquadCoeffs_t nn_biquad_lowpass(float sample_rate, float freq, float q);
+
+/**
+ * @brief RBJ cookbook high-pass filter
+ */
+NOTE_NAGA_ENGINE_API NN_BiquadCoeffs_t nn_biquad_highpass(float sample_rate, float freq, float q);
+
+/**
+ * @brief RBJ cookbook band-pass filter (constant 0 dB peak gain)
+ */
+NOTE_NAGA_ENGINE_API NN_BiquadCoeffs_t nn_biquad_bandpass(float sample_rate, float freq, float q);
+
+/**
+ * @brief Stereo cascade of serial biquad stages.
+ *
+ * Stages are processed in groups of 4 SIMD lanes (SSE2 / NEON, scalar fallback) as
+ * one pipeline: stage k runs on sample t - k, so all stages advance in one step
+ * while the output stays sample accurate (no added latency). Up to three groups and
+ * both channels run as independent dependency chains in the same loop. Coefficients
+ * are only changed by setCoeffs(), processing never computes pow / sin / cos and
+ * never allocates.
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaBiquadCascade {
+public:
+    /// Maximum number of stages
+    static constexpr size_t MAX_STAGES = 32;
+
+    NoteNagaBiquadCascade();
+
+    /**
+     * @brief Set the number of stages, new stages start as pass-through
+     */
+    void setStageCount(size_t num_stages);
+
+    /**
+     * @brief Get the number of stages
+     */
+    size_t getStageCount() const { return num_stages_; }
+
+    /**
+     * @brief Set coefficients of one stage, filter state is kept (no clicks)
+     */
+    void setCoeffs(size_t stage, const NN_BiquadCoeffs_t &coeffs);
+
+    /**
+     * @brief Clear filter state of all stages
+     */
+    void reset();
+
+    /**
+     * @brief Filter a stereo block in place through all stages
+     */
+    void process(float *left, float *right, size_t num_frames);
+
+private:
+    static constexpr size_t LANES = 4;
+
+    size_t num_stages_ = 0;
+
+    // Coefficients, structure of arrays (lane = stage)
+    alignas(16) float b0_[MAX_STAGES];
+    alignas(16) float b1_[MAX_STAGES];
+    alignas(16) float b2_[MAX_STAGES];
+    alignas(16) float a1_[MAX_STAGES];
+    alignas(16) float a2_[MAX_STAGES];
+
+    // State per channel
+    alignas(16) float x1_[2][MAX_STAGES];
+    alignas(16) float x2_[2][MAX_STAGES];
+    alignas(16) float y1_[2][MAX_STAGES];
+    alignas(16) float y2_[2][MAX_STAGES];
+
+    template <size_t G>
+    void processGroups(float *left, float *right, size_t num_frames, size_t first_stage);
+};
@@ -1,10 +1,19 @@
 #pragma once
 
 #include <note_naga_engine/note_naga_api.h>
+#include <note_naga_engine/core/dsp_load_meter.h>
 
+#include <cmath>
 #include <string>
 #include <vector>
 
+/// Peak level below which the DSP engine treats a buffer as silence (-100 dBFS)
+static constexpr float NN_DSP_SILENCE_LEVEL = 1e-5f;
+/// Sample rate blocks are prepared for until the DSP engine prepares them
+static constexpr float NN_DSP_DEFAULT_SAMPLE_RATE = 44100.0f;
+/// Largest block blocks are prepared for until the DSP engine prepares them
+static constexpr size_t NN_DSP_DEFAULT_BLOCK_FRAMES = 512;
+
 /**
  * @brief Parameter types for DSP blocks.
  */
@@ -36,6 +45,14 @@ struct NOTE_NAGA_ENGINE_API DSPParamDescriptor {
     std::vector<std::string> options;
 };
 
+/**
+ * @brief Sleep state of a DSP block, owned by the thread that renders the block.
+ */
+struct NOTE_NAGA_ENGINE_API NN_DSPSleepState_t {
+    size_t silent_frames = 0; ///< Frames of silent input since the last sound
+    bool sleeping = false;    ///< The block is skipped until its input is not silent
+};
+
 /**
  * @brief Base class for DSP blocks in the Note Naga engine.
  * This class defines the interface for processing audio data,
@@ -46,6 +63,15 @@ class NOTE_NAGA_ENGINE_API NoteNagaDSPBlockBase {
 public:
     virtual ~NoteNagaDSPBlockBase() {}
 
+    /**
+     * @brief Prepare the block for rendering: allocate buffers and precompute everything
+     * that depends on the sample rate. Called by the DSP engine when the block is added and
+     * when the output format changes, never while the block is processed.
+     * @param sampleRate Sample rate in Hz.
+     * @param maxBlockFrames Largest numFrames that will be passed to process().
+     */
+    virtual void prepare(float /*sampleRate*/, size_t /*maxBlockFrames*/) {}
+
     /**
      * @brief Process audio data (in-place, mono and stereo).
      */
@@ -81,6 +107,74 @@ public:
      */
     virtual std::string getBlockName() const = 0;
 
+    /**
+     * @brief Get the time the output needs to decay below NN_DSP_SILENCE_LEVEL after the
+     * input became silent (reverb / delay tails). The DSP engine skips the block when its
+     * input was silent for longer than this. Blocks without memory of past input keep the
+     * default 0, blocks that never decay return INFINITY. Called from the render thread.
+     */
+    virtual float getTailSeconds() const { return 0.0f; }
+
+    /**
+     * @brief Get the delay the block adds to the signal in samples (lookahead, oversampling
+     * filters) with the current parameters, so the DSP engine can compensate it. Blocks
+     * without latency keep the default 0. Called from any thread.
+     */
+    virtual size_t getLatencySamples() const { return 0; }
+
+    /**
+     * @brief Check if the block can take its detector signal from a sidechain input
+     * (ducking compressors, keyed gates). Blocks that cannot keep the default false.
+     */
+    virtual bool supportsSidechain() const { return false; }
+
+    /**
+     * @brief Set the sidechain input of the next process() call. The DSP engine points it
+     * to the output buffers of the keying synth for one call and resets it to nullptr
+     * afterwards, so the buffers hold exactly numFrames samples. Without a sidechain the
+     * block keys off its own input.
+     * @param left Left sidechain samples (nullptr = no sidechain).
+     * @param right Right sidechain samples (nullptr = no sidechain).
+     */
+    void setSidechainInput(const float *left, const float *right) {
+        sidechain_left_ = left;
+        sidechain_right_ = right;
+    }
+
+    /**
+     * @brief CPU load of process() measured by the DSP engine (see NoteNagaDSPEngine::setProfilingEnabled).
+     */
+    NoteNagaDSPLoadMeter &getLoadMeter() { return load_meter_; }
+    const NoteNagaDSPLoadMeter &getLoadMeter() const { return load_meter_; }
+
+    /**
+     * @brief Sleep state used by the DSP engine to skip silent blocks (render thread only).
+     */
+    NN_DSPSleepState_t &getSleepState() { return sleep_state_; }
+
+protected:
+    /**
+     * @brief Time a feedback loop needs to decay below NN_DSP_SILENCE_LEVEL.
+     * @param loop_seconds Length of one pass through the loop in seconds.
+     * @param feedback Gain of one pass, INFINITY is returned for gains of 1 and more.
+     */
+    static float feedbackDecaySeconds(float loop_seconds, float feedback) {
+        feedback = std::fabs(feedback);
+        if (feedback >= 0.9999f) return INFINITY;
+        if (feedback <= NN_DSP_SILENCE_LEVEL) return loop_seconds;
+        return loop_seconds * (1.0f + std::log(NN_DSP_SILENCE_LEVEL) / std::log(feedback));
+    }
+
+    /**
+     * @brief Sidechain input of the current process() call, nullptr without sidechain.
+     */
+    const float *getSidechainLeft() const { return sidechain_left_; }
+    const float *getSidechainRight() const { return sidechain_right_; }
+
 private:
     bool active_ = true;
+    const float *sidechain_left_ = nullptr;
+    const float *sidechain_right_ = nullptr;
+    NoteNagaDSPLoadMeter load_meter_;
+    NN_DSPSleepState_t sleep_state_;
 };
\ No newline at end of file
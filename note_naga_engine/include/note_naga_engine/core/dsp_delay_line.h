@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Circular delay line with a power of two length, so wrapping is a bit mask
+ * instead of a modulo or a branch per sample.
+ *
+ * Samples are written with push(), read(d) returns the sample pushed d pushes ago
+ * (read(0) is the newest one). setMaxDelay() allocates, everything else is real-time safe.
+ * Fractional reads:
+ * - readLinear(): 2 taps, cheap, slightly low-passes moving taps (chorus, flanger)
+ * - readCubic(): 4-point Hermite, flat response, delay must be at least 1 sample
+ * - readAllpass(): first order allpass, flat magnitude for a fixed delay, keeps one state
+ *   value per tap (fine tuning of feedback loops)
+ *
+ * @example How to use:
+ *
+ * line.setMaxDelay(size_t(0.025f * sampleRate)); // prepare()
+ *
+ * line.push(input);                               // process(), per sample
+ * float wet = line.readLinear(delaySamples);
+ */
+template <typename T = float> class NoteNagaDelayLine {
+public:
+    /**
+     * @brief Allocate the line for delays up to maxDelay samples (plus the extra taps of
+     * the interpolating reads) and clear it
+     */
+    void setMaxDelay(size_t maxDelay) {
+        size_t size = 4;
+        while (size < maxDelay + 4) size <<= 1;
+        buffer_.assign(size, T(0));
+        mask_ = size - 1;
+        pos_ = 0;
+    }
+
+    /**
+     * @brief Get the largest delay that can be read with all read functions
+     */
+    size_t getMaxDelay() const { return buffer_.empty() ? 0 : buffer_.size() - 4; }
+
+    /**
+     * @brief Clear the content of the line
+     */
+    void clear() { std::fill(buffer_.begin(), buffer_.end(), T(0)); }
+
+    /**
+     * @brief Write the next sample
+     */
+    inline void push(T x) {
+        pos_ = (pos_ + 1) & mask_;
+        buffer_[pos_] = x;
+    }
+
+    /**
+     * @brief Read the sample pushed delay pushes ago
+     */
+    inline T read(size_t delay) const { return buffer_[(pos_ - delay) & mask_]; }
+
+    /**
+     * @brief Read a fractional delay with linear interpolation
+     */
+    inline T readLinear(float delay) const {
+        const size_t i = static_cast<size_t>(delay);
+        const float frac = delay - static_cast<float>(i);
+        const T a = read(i);
+        const T b = read(i + 1);
+        return a + (b - a) * frac;
+    }
+
+    /**
+     * @brief Read a fractional delay with 4-point Hermite interpolation (delay >= 1)
+     */
+    inline T readCubic(float delay) const {
+        const size_t i = static_cast<size_t>(delay);
+        const float frac = delay - static_cast<float>(i);
+        const T xm1 = read(i - 1);
+        const T x0 = read(i);
+        const T x1 = read(i + 1);
+        const T x2 = read(i + 2);
+        const T c1 = T(0.5) * (x1 - xm1);
+        const T c2 = xm1 - T(2.5) * x0 + T(2) * x1 - T(0.5) * x2;
+        const T c3 = T(0.5) * (x2 - xm1) + T(1.5) * (x0 - x1);
+        return ((c3 * frac + c2) * frac + c1) * frac + x0;
+    }
+
+    /**
+     * @brief Read a fractional delay through a first order allpass interpolator
+     * @param state Previous output of this tap, owned by the caller (zero initially)
+     */
+    inline T readAllpass(float delay, T &state) const {
+        size_t i = static_cast<size_t>(delay);
+        float frac = delay - static_cast<float>(i);
+        // Fraction in [0.1, 1.1) keeps the pole (-a) away from the unit circle
+        if (frac < 0.1f && i > 0) {
+            --i;
+            frac += 1.0f;
+        }
+        const T a = T((1.0f - frac) / (1.0f + frac));
+        state = a * (read(i) - state) + read(i + 1);
+        return state;
+    }
+
+private:
+    std::vector<T> buffer_;
+    size_t mask_ = 0;
+    size_t pos_ = 0;
+};
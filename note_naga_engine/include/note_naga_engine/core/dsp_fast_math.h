@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Fast approximations of the libm functions used in the hot loops of DSP blocks.
+ *
+ * All functions are branchless inline code without table lookups, so plain loops calling
+ * them are vectorized by the compiler. The maximum errors against double precision libm,
+ * measured over the given input range (bench/fast_math_check.cpp checks these bounds):
+ *
+ * | function                        | input            | max error                         |
+ * |---------------------------------|------------------|-----------------------------------|
+ * | nn_fast_exp2(x)                 | -126 .. 126      | 2.5e-7 relative                   |
+ * | nn_fast_exp(x)                  | -10 .. 10        | 6.9e-7 relative (4e-6 at +-87)    |
+ * | nn_fast_log2(x)                 | 0 < x < 1        | 4.0e-6 absolute, 2.6e-7 relative  |
+ * | nn_fast_log2(x)                 | x >= 1           | 2.7e-7 relative                   |
+ * | nn_fast_sin_turns(t), cos_turns | -1 .. 1 turns    | 4.1e-7 absolute                   |
+ * | nn_fast_sin(x), nn_fast_cos(x)  | -pi .. pi        | 3.6e-7 absolute (1e-7 * |x| above)|
+ * | nn_fast_tanh(x)                 | any              | 1.5e-7 absolute                   |
+ * | nn_fast_db_to_linear(db)        | -120 .. 120 dB   | 9.4e-7 relative                   |
+ * | nn_fast_linear_to_db(x)         | 0 < x < 1        | 6.3e-5 dB absolute, 2.7e-7 rel.   |
+ * | nn_fast_linear_to_db(x)         | x >= 1           | 3.0e-7 relative                   |
+ *
+ * The absolute error of the logarithms grows with the magnitude of the result (float
+ * rounding of log2(1e-38) = -126 alone is 3.8e-6), near x = 1 it is far below 1e-7.
+ * Outside these ranges the error grows with the rounding of the float argument (a phase of
+ * 100 turns has only 7.6e-6 turns of resolution), inputs outside the domain are clamped and
+ * the results stay finite. Errors of this size are below the 24-bit noise floor, but the
+ * functions are not bit exact with libm, so filter coefficients close to 1 (one-pole
+ * smoothing, exp(-1 / (time * rate))) must keep using libm.
+ */
+
+namespace nn_fast_math_detail {
+
+inline float bits_to_float(uint32_t bits) {
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+inline uint32_t float_to_bits(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+// Round to nearest integer for |x| < 2^22: adding 1.5 * 2^23 leaves the integer in the low
+// mantissa bits. Avoids float to int conversions, which keep GCC from vectorizing the loop.
+inline int round_int(float x) {
+    return static_cast<int>(float_to_bits(x + 12582912.0f) - 0x4b400000u);
+}
+
+// cond ? a : b as a bit mask. GCC does not if-convert float selects whose result feeds
+// further float math (they could trap), which would keep the loop from being vectorized.
+inline float select(bool cond, float a, float b) {
+    const uint32_t mask = 0u - static_cast<uint32_t>(cond);
+    return bits_to_float((float_to_bits(a) & mask) | (float_to_bits(b) & ~mask));
+}
+
+inline float clamp(float x, float lo, float hi) {
+    x = select(x < lo, lo, x);
+    return select(x > hi, hi, x);
+}
+
+} // namespace nn_fast_math_detail
+
+/**
+ * @brief 2^x: exponent from the integer part, degree 6 Taylor polynomial for the
+ * fractional part reduced to [-0.5, 0.5]
+ */
+inline float nn_fast_exp2(float x) {
+    using namespace nn_fast_math_detail;
+    x = clamp(x, -126.0f, 126.0f);
+    const int i = round_int(x);
+    const float f = x - static_cast<float>(i);
+    // ln(2)^k / k!
+    float p = 1.5403530393e-4f;
+    p = p * f + 1.3333558146e-3f;
+    p = p * f + 9.6181291076e-3f;
+    p = p * f + 5.5504108665e-2f;
+    p = p * f + 2.4022650696e-1f;
+    p = p * f + 6.9314718056e-1f;
+    p = p * f + 1.0f;
+    return p * bits_to_float(static_cast<uint32_t>(i + 127) << 23);
+}
+
+/**
+ * @brief e^x
+ */
+inline float nn_fast_exp(float x) { return nn_fast_exp2(x * 1.4426950409f); }
+
+/**
+ * @brief log2(x) for x > 0: exponent from the float bits, atanh series for the mantissa
+ * reduced to [sqrt(1/2), sqrt(2))
+ */
+inline float nn_fast_log2(float x) {
+    using namespace nn_fast_math_detail;
+    x = select(x > 1.17549435e-38f, x, 1.17549435e-38f);
+    // Move the mantissa to [sqrt(1/2), sqrt(2)) by taking sqrt(1/2) off the bits first
+    const uint32_t bits = float_to_bits(x) - 0x3f3504f3u;
+    const int e = static_cast<int>(bits >> 23) - (static_cast<int>(bits >> 31) << 9);
+    const float m = bits_to_float((bits & 0x007fffffu) + 0x3f3504f3u);
+    // ln(m) = 2 * atanh(y), y = (m - 1) / (m + 1), |y| < 0.1716
+    const float y = (m - 1.0f) / (m + 1.0f);
+    const float y2 = y * y;
+    float p = 1.0f / 9.0f;
+    p = p * y2 + 1.0f / 7.0f;
+    p = p * y2 + 1.0f / 5.0f;
+    p = p * y2 + 1.0f / 3.0f;
+    p = p * y2 + 1.0f;
+    // 2 / ln(2)
+    return static_cast<float>(e) + 2.8853900818f * y * p;
+}
+
+/**
+ * @brief sin(2 pi t): t is the phase in turns, so LFO phases in [0, 1) need no scaling
+ * and the range reduction is exact. Degree 11 Taylor polynomial on [-1/4, 1/4] turns.
+ */
+inline float nn_fast_sin_turns(float t) {
+    using namespace nn_fast_math_detail;
+    // Reduce to [-0.5, 0.5], then mirror into [-0.25, 0.25] (sin(pi - x) = sin(x))
+    t = clamp(t, -1e4f, 1e4f);
+    t -= static_cast<float>(round_int(t));
+    const float half = select(t < 0.0f, -0.5f, 0.5f);
+    t = select(std::fabs(t) > 0.25f, half - t, t);
+
+    const float x = t * 6.2831853072f;
+    const float x2 = x * x;
+    // (-1)^k / (2k + 1)!
+    float p = -2.5052108385e-8f;
+    p = p * x2 + 2.7557319224e-6f;
+    p = p * x2 - 1.9841269841e-4f;
+    p = p * x2 + 8.3333333333e-3f;
+    p = p * x2 - 1.6666666667e-1f;
+    p = p * x2 + 1.0f;
+    return x * p;
+}
+
+/**
+ * @brief cos(2 pi t), t is the phase in turns
+ */
+inline float nn_fast_cos_turns(float t) { return nn_fast_sin_turns(t + 0.25f); }
+
+/**
+ * @brief sin(x), x in radians
+ */
+inline float nn_fast_sin(float x) { return nn_fast_sin_turns(x * 0.15915494309f); }
+
+/**
+ * @brief cos(x), x in radians
+ */
+inline float nn_fast_cos(float x) { return nn_fast_sin_turns(x * 0.15915494309f + 0.25f); }
+
+/**
+ * @brief tanh(x) = (e^2x - 1) / (e^2x + 1), saturates to +-1 above |x| = 9
+ */
+inline float nn_fast_tanh(float x) {
+    using namespace nn_fast_math_detail;
+    x = clamp(x, -9.0f, 9.0f);
+    // 2 / ln(2)
+    const float e = nn_fast_exp2(x * 2.8853900818f);
+    return (e - 1.0f) / (e + 1.0f);
+}
+
+/**
+ * @brief Convert decibels to a linear gain (10^(db / 20))
+ */
+inline float nn_fast_db_to_linear(float db) {
+    // log2(10) / 20
+    return nn_fast_exp2(db * 0.16609640474f);
+}
+
+/**
+ * @brief Convert a linear gain to decibels (20 log10(x)), x > 0
+ */
+inline float nn_fast_linear_to_db(float x) {
+    // 20 log10(2)
+    return nn_fast_log2(x) * 6.0205999133f;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** Analysis window applied by NoteNagaFFT::forwardRealWindowed() */
+enum class NOTE_NAGA_ENGINE_API NN_FFTWindow_t {
+    Rectangular, ///< No window
+    Hann         ///< Periodic Hann window
+};
+
+/**
+ * @brief Preallocated FFT of real signals (FFT plan).
+ *
+ * setSize() builds the bit reversal, twiddle and window tables and the work buffers once,
+ * the transforms then never allocate and never call sin / cos, so they can be used on the
+ * audio thread. A real transform of N points runs as an in-place complex radix-2 FFT of
+ * N / 2 points with the even / odd samples packed into real / imaginary parts. The work
+ * buffer is split (separate real and imaginary arrays) and the twiddles of every stage are
+ * stored contiguously, so the butterflies of the larger stages run as nn_vec_fft_butterfly().
+ * Spectra are stored split (separate real and imaginary arrays of N / 2 + 1 bins).
+ *
+ * @example How to use:
+ *
+ * NoteNagaFFT fft(1024);
+ * fft.setWindow(NN_FFTWindow_t::Hann);
+ *
+ * fft.magnitudes(frame.data(), mag.data()); // mag has fft.getNumBins() values
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaFFT {
+public:
+    NoteNagaFFT() = default;
+
+    /**
+     * @brief Create a transform of the given size
+     * @param size Number of real samples (power of two, at least 4)
+     * @param window Window applied by forwardRealWindowed() and magnitudes()
+     */
+    explicit NoteNagaFFT(size_t size, NN_FFTWindow_t window = NN_FFTWindow_t::Rectangular) {
+        window_type_ = window;
+        setSize(size);
+    }
+
+    /**
+     * @brief Set the transform size and build all tables (allocates)
+     * @param size Number of real samples (power of two, at least 4)
+     */
+    void setSize(size_t size);
+
+    /**
+     * @brief Get the number of real samples of one transform
+     */
+    size_t getSize() const { return size_; }
+
+    /**
+     * @brief Get the number of bins of a spectrum (size / 2 + 1)
+     */
+    size_t getNumBins() const { return size_ / 2 + 1; }
+
+    /**
+     * @brief Set the analysis window and build its table (allocates)
+     */
+    void setWindow(NN_FFTWindow_t window);
+
+    /**
+     * @brief Get the analysis window
+     */
+    NN_FFTWindow_t getWindow() const { return window_type_; }
+
+    /**
+     * @brief Forward transform without scaling
+     * @param in getSize() real samples
+     * @param re Output, getNumBins() real parts
+     * @param im Output, getNumBins() imaginary parts
+     */
+    void forwardReal(const float *in, float *re, float *im);
+
+    /**
+     * @brief Forward transform of the input multiplied by the analysis window, the input
+     * is not modified
+     * @param in getSize() real samples
+     * @param re Output, getNumBins() real parts
+     * @param im Output, getNumBins() imaginary parts
+     */
+    void forwardRealWindowed(const float *in, float *re, float *im);
+
+    /**
+     * @brief Magnitudes of the windowed forward transform (not scaled)
+     * @param in getSize() real samples
+     * @param mag Output, getNumBins() magnitudes
+     */
+    void magnitudes(const float *in, float *mag);
+
+    /**
+     * @brief Inverse transform scaled by 1 / N, so inverseReal(forwardReal(x)) == x
+     * @param re getNumBins() real parts
+     * @param im getNumBins() imaginary parts
+     * @param out Output, getSize() real samples
+     */
+    void inverseReal(const float *re, const float *im, float *out);
+
+private:
+    size_t size_ = 0;
+    NN_FFTWindow_t window_type_ = NN_FFTWindow_t::Rectangular;
+
+    // exp(-2 pi i k / N) for k < N / 2, used to split / merge the packed spectrum
+    std::vector<std::complex<float>> twiddles_;
+    // Twiddles exp(-2 pi i j / len) of the half size FFT, j < len / 2 of every stage
+    // stored from offset len / 2 - 1, imaginary parts conjugated for the inverse
+    std::vector<float> stage_re_;
+    std::vector<float> stage_im_;
+    std::vector<float> stage_im_inv_;
+    // Bit reversal permutation of the half size FFT
+    std::vector<uint32_t> bitrev_;
+    // Window table (empty for the rectangular window)
+    std::vector<float> window_;
+    // Work buffer of the half size FFT (split)
+    std::vector<float> work_re_;
+    std::vector<float> work_im_;
+    // Spectrum of magnitudes()
+    std::vector<float> spectrum_re_;
+    std::vector<float> spectrum_im_;
+
+    void transform(bool inverse);
+    void splitSpectrum(float *re, float *im) const;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+
+#include <cstddef>
+
+/**
+ * @brief Sine LFO for modulation blocks (chorus, flanger, phaser, tremolo).
+ *
+ * The oscillator reads a shared sine wavetable only once every CONTROL_FRAMES samples and
+ * ramps linearly between these points, so a sample costs one add. At 44.1 kHz the ramp
+ * deviates from a true sine by less than 1e-4 up to 5 Hz and 1e-3 at 20 Hz (the error grows
+ * with the square of the rate). Output is in [-1, 1].
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaLFO {
+public:
+    /// Samples between two wavetable reads
+    static constexpr size_t CONTROL_FRAMES = 32;
+
+    /**
+     * @brief Set the LFO rate, takes effect at the next control point
+     * @param hz Rate in Hz.
+     * @param sampleRate Sample rate in Hz.
+     */
+    void setRate(float hz, float sampleRate) { increment_ = hz / sampleRate; }
+
+    /**
+     * @brief Restart the LFO at the given phase
+     * @param turns Phase in turns (0 .. 1, 0.25 = positive peak).
+     */
+    void reset(float turns = 0.0f) {
+        phase_ = turns - float(int(turns));
+        countdown_ = 0;
+    }
+
+    /**
+     * @brief Get the next LFO sample
+     */
+    inline float next() {
+        if (countdown_ == 0) startSegment();
+        --countdown_;
+        const float value = value_;
+        value_ += slope_;
+        return value;
+    }
+
+private:
+    float phase_ = 0.0f;     // phase of the next control point, turns
+    float increment_ = 0.0f; // turns per sample
+    float value_ = 0.0f;
+    float slope_ = 0.0f;
+    size_t countdown_ = 0;
+
+    void startSegment();
+};
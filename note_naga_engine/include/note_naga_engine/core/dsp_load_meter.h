@@ -0,0 +1,62 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief CPU load of a DSP block or synthesizer, relative to the real-time budget of the
+ * rendered audio (1.0 = processing takes as long as playing the audio).
+ */
+struct NOTE_NAGA_ENGINE_API NN_DSPLoad_t {
+    float average = 0.0f; ///< Exponential moving average of the load
+    float peak = 0.0f;    ///< Maximum load of the last ~128 rendered blocks
+};
+
+/**
+ * @brief Lock-free rolling load statistics. Written by the one thread that renders the
+ * measured unit, read by any thread (GUI) without blocking.
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaDSPLoadMeter {
+public:
+    /// Number of rendered blocks in one peak window
+    static constexpr uint32_t PEAK_WINDOW_BLOCKS = 64;
+    /// Smoothing of the average per rendered block
+    static constexpr float AVERAGE_COEF = 0.05f;
+
+    /**
+     * @brief Add the load of one rendered block (render thread only)
+     */
+    void record(float load) {
+        average_ += (load - average_) * AVERAGE_COEF;
+        window_peak_ = std::max(window_peak_, load);
+        if (++window_count_ >= PEAK_WINDOW_BLOCKS) {
+            last_window_peak_ = window_peak_;
+            window_peak_ = 0.0f;
+            window_count_ = 0;
+        }
+        published_average_.store(average_, std::memory_order_relaxed);
+        published_peak_.store(std::max(last_window_peak_, window_peak_), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the current statistics (any thread)
+     */
+    NN_DSPLoad_t get() const {
+        return {published_average_.load(std::memory_order_relaxed),
+                published_peak_.load(std::memory_order_relaxed)};
+    }
+
+private:
+    // Render thread state
+    float average_ = 0.0f;
+    float window_peak_ = 0.0f;
+    float last_window_peak_ = 0.0f;
+    uint32_t window_count_ = 0;
+
+    // Published values
+    std::atomic<float> published_average_{0.0f};
+    std::atomic<float> published_peak_{0.0f};
+};
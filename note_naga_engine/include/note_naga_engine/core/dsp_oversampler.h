@@ -0,0 +1,104 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Stereo 2x / 4x / 8x oversampler for nonlinear DSP blocks (saturation, clipping,
+ * quantization), so their harmonics above Nyquist are filtered instead of aliased.
+ *
+ * Every factor of two is one stage of linear phase half-band FIR filters in polyphase form:
+ * half of the taps are zero and the center tap only passes the signal through, so a stage
+ * computes one short symmetric FIR per input sample in each direction. The filters run tap
+ * by tap over whole blocks with the nn_vec_* vector math layer. The first stage has the
+ * steepest filter, the later stages only need to reject what the first one passed.
+ *
+ * prepare() allocates all buffers for the largest factor, setFactor() and process() never
+ * allocate and can be called from the audio thread. The round trip (up and down) delays
+ * the signal by getLatencyFrames() samples; blocks should mix their dry signal inside the
+ * oversampled callback so dry and wet stay aligned.
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaOversampler {
+public:
+    /// Largest supported oversampling factor
+    static constexpr int MAX_FACTOR = 8;
+
+    /**
+     * @brief Allocate the buffers for blocks of up to maxBlockFrames samples (allocates).
+     */
+    void prepare(size_t maxBlockFrames);
+
+    /**
+     * @brief Set the oversampling factor (1, 2, 4 or 8, other values are rounded down).
+     * Clears the filter state when the factor changes.
+     */
+    void setFactor(int factor);
+
+    /**
+     * @brief Get the oversampling factor
+     */
+    int getFactor() const { return factor_; }
+
+    /**
+     * @brief Get the delay of the up / down round trip in samples of the base rate
+     */
+    size_t getLatencyFrames() const;
+
+    /**
+     * @brief Get the round trip delay of the given factor (1, 2, 4, 8) in samples of the
+     * base rate, lets blocks report their latency before the factor is applied
+     */
+    static size_t latencyForFactor(int factor);
+
+    /**
+     * @brief Clear the filter state
+     */
+    void reset();
+
+    /**
+     * @brief Process a stereo block at the oversampled rate (in place).
+     * @param fn Called as fn(left, right, frames) with the upsampled signal, which it
+     * processes in place. Blocks longer than the prepared size are split into several calls.
+     */
+    template <typename Fn> void process(float *left, float *right, size_t numFrames, Fn &&fn) {
+        if (factor_ == 1 || maxFrames_ == 0) {
+            fn(left, right, numFrames);
+            return;
+        }
+        for (size_t done = 0; done < numFrames;) {
+            const size_t n = std::min(numFrames - done, maxFrames_);
+            upsample(left + done, right + done, n);
+            fn(buffers_[numStages_ - 1][0].data(), buffers_[numStages_ - 1][1].data(), n * size_t(factor_));
+            downsample(left + done, right + done, n);
+            done += n;
+        }
+    }
+
+private:
+    // One half-band filter pair (2x up, 2x down) of one channel
+    struct Stage {
+        size_t half = 0;          // K: nonzero taps on each side of the center tap
+        std::vector<float> taps;  // 2K symmetric nonzero taps, sum 0.5
+        std::vector<float> upHist, interp, downEven, downOdd;
+
+        void setup(size_t halfTaps, size_t maxInputFrames);
+        void clear();
+        void upsample(const float *in, float *out, size_t n);   // n -> 2n samples
+        void downsample(const float *in, float *out, size_t n); // 2n -> n samples
+    };
+
+    static constexpr int MAX_STAGES = 3;
+
+    int factor_ = 1;
+    int numStages_ = 0;
+    size_t maxFrames_ = 0;
+    Stage stages_[MAX_STAGES][2];
+    // Output of every upsampling stage, [stage][channel]
+    std::vector<float> buffers_[MAX_STAGES][2];
+
+    void upsample(const float *left, const float *right, size_t numFrames);
+    void downsample(float *left, float *right, size_t numFrames);
+};
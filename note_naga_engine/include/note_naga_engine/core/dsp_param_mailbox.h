@@ -0,0 +1,154 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Lock-free parameter mailbox of a DSP block.
+ *
+ * The GUI thread writes parameter values with set(), the audio thread takes all
+ * changes at the start of a block with consume() and applies them to its own copy
+ * of the parameters. Values are single atomics and changes are flagged in one bit
+ * mask, so neither side ever blocks and no update is lost. At most 64 parameters.
+ *
+ * @example How to use:
+ *
+ * // GUI thread
+ * mailbox_.set(idx, value);
+ *
+ * // audio thread, block start
+ * uint64_t changed = mailbox_.consume();
+ * if (NoteNagaDSPParamMailbox::isChanged(changed, 0)) gain_ = mailbox_.get(0);
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaDSPParamMailbox {
+public:
+    /// Maximum number of parameters in one mailbox
+    static constexpr size_t MAX_PARAMS = 64;
+
+    /**
+     * @brief Create a mailbox, all parameters start at zero and are marked changed
+     * @param count Number of parameters
+     */
+    explicit NoteNagaDSPParamMailbox(size_t count)
+        : count_(std::min(count, MAX_PARAMS)), values_(new std::atomic<float>[std::min(count, MAX_PARAMS)]) {
+        for (size_t i = 0; i < count_; ++i) values_[i].store(0.0f, std::memory_order_relaxed);
+        changed_.store(count_ == MAX_PARAMS ? ~uint64_t(0) : (uint64_t(1) << count_) - 1,
+                       std::memory_order_relaxed);
+    }
+
+    NoteNagaDSPParamMailbox(const NoteNagaDSPParamMailbox &) = delete;
+    NoteNagaDSPParamMailbox &operator=(const NoteNagaDSPParamMailbox &) = delete;
+
+    /**
+     * @brief Post a new value of a parameter (any thread)
+     */
+    void set(size_t idx, float value) {
+        if (idx >= count_) return;
+        values_[idx].store(value, std::memory_order_relaxed);
+        changed_.fetch_or(uint64_t(1) << idx, std::memory_order_release);
+    }
+
+    /**
+     * @brief Get the last posted value of a parameter (any thread)
+     */
+    float get(size_t idx) const {
+        return idx < count_ ? values_[idx].load(std::memory_order_relaxed) : 0.0f;
+    }
+
+    /**
+     * @brief Take all pending changes (audio thread, once per block)
+     * @return Bit mask of parameters changed since the last call
+     */
+    uint64_t consume() {
+        if (changed_.load(std::memory_order_relaxed) == 0) return 0;
+        return changed_.exchange(0, std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Check if a parameter is flagged in a mask returned by consume()
+     */
+    static bool isChanged(uint64_t mask, size_t idx) { return (mask >> idx) & 1u; }
+
+    /**
+     * @brief Get the number of parameters
+     */
+    size_t size() const { return count_; }
+
+private:
+    size_t count_;
+    std::unique_ptr<std::atomic<float>[]> values_;
+    std::atomic<uint64_t> changed_{0};
+};
+
+/**
+ * @brief Linear per-sample ramp used by the audio thread to move a parameter to its
+ * new value without clicks. Not thread-safe, owned by the audio thread.
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaSmoothedValue {
+public:
+    /**
+     * @brief Jump to a value without ramp
+     */
+    void reset(float value) {
+        current_ = target_ = value;
+        step_ = 0.0f;
+        remaining_ = 0;
+    }
+
+    /**
+     * @brief Start a ramp from the current value to a new target
+     * @param value Target value
+     * @param ramp_frames Length of the ramp in samples
+     */
+    void setTarget(float value, size_t ramp_frames) {
+        if (value == target_) return;
+        target_ = value;
+        if (ramp_frames == 0) {
+            reset(value);
+            return;
+        }
+        step_ = (target_ - current_) / float(ramp_frames);
+        remaining_ = ramp_frames;
+    }
+
+    /**
+     * @brief Advance by one sample and return the new value
+     */
+    float next() {
+        if (remaining_ == 0) return current_;
+        if (--remaining_ == 0) {
+            current_ = target_;
+        } else {
+            current_ += step_;
+        }
+        return current_;
+    }
+
+    /**
+     * @brief Advance by a number of samples (block-rate parameters)
+     */
+    float skip(size_t frames) {
+        if (frames >= remaining_) {
+            reset(target_);
+        } else {
+            current_ += step_ * float(frames);
+            remaining_ -= frames;
+        }
+        return current_;
+    }
+
+    float getCurrent() const { return current_; }
+    float getTarget() const { return target_; }
+    bool isSmoothing() const { return remaining_ > 0; }
+
+private:
+    float current_ = 0.0f;
+    float target_ = 0.0f;
+    float step_ = 0.0f;
+    size_t remaining_ = 0;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Maximum of the last N pushed values in O(1) amortized time per value, whatever
+ * the window length (peak hold of lookahead limiters and level meters).
+ *
+ * Keeps a monotonic deque: values that can never become the maximum again (older and not
+ * larger than a newer value) are dropped when the newer one is pushed, so the front is
+ * always the maximum of the window. The deque lives in a preallocated ring, setMaxWindow()
+ * allocates, everything else is real-time safe.
+ *
+ * @example How to use:
+ *
+ * peak.setMaxWindow(maxLookahead + 1);  // prepare()
+ * peak.setWindow(lookahead + 1);
+ *
+ * float held = peak.push(std::fabs(x)); // process(), per sample
+ */
+class NoteNagaSlidingMax {
+public:
+    /**
+     * @brief Allocate the deque for windows up to maxWindow values and clear it
+     */
+    void setMaxWindow(size_t maxWindow) {
+        size_t size = 2;
+        while (size < maxWindow + 1) size <<= 1;
+        values_.assign(size, 0.0f);
+        stamps_.assign(size, 0);
+        mask_ = size - 1;
+        maxWindow_ = maxWindow;
+        window_ = window_ ? std::min(window_, maxWindow) : maxWindow;
+        clear();
+    }
+
+    /**
+     * @brief Set the window length (1 .. max window) and clear the window
+     */
+    void setWindow(size_t window) {
+        window_ = std::max<size_t>(1, std::min(window, maxWindow_));
+        clear();
+    }
+
+    /**
+     * @brief Get the window length
+     */
+    size_t getWindow() const { return window_; }
+
+    /**
+     * @brief Forget all pushed values
+     */
+    void clear() {
+        head_ = 0;
+        count_ = 0;
+        time_ = 0;
+    }
+
+    /**
+     * @brief Push the next value
+     * @return Maximum of the last getWindow() values (including this one)
+     */
+    inline float push(float value) {
+        // Drop values that cannot be the maximum any more
+        while (count_ > 0 && values_[(head_ + count_ - 1) & mask_] <= value) --count_;
+        const size_t back = (head_ + count_) & mask_;
+        values_[back] = value;
+        stamps_[back] = time_;
+        ++count_;
+
+        // Drop the front when it left the window
+        if (stamps_[head_] + window_ <= time_) {
+            head_ = (head_ + 1) & mask_;
+            --count_;
+        }
+        ++time_;
+        return values_[head_];
+    }
+
+private:
+    std::vector<float> values_;
+    std::vector<size_t> stamps_; // push index of each value
+    size_t mask_ = 0;
+    size_t maxWindow_ = 0;
+    size_t window_ = 0;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    size_t time_ = 0;
+};
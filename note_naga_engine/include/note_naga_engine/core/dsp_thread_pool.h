@@ -0,0 +1,86 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Real-time safe worker pool used by the DSP engine to process independent
+ * jobs (synth branches, shards, ...) in parallel.
+ *
+ * Dispatching a job set never locks and never allocates. Jobs are claimed through a
+ * single atomic counter tagged with a generation number, so stale workers can never
+ * pick up a job of a newer job set. The calling thread always takes part in the work,
+ * which means a job set completes even when no worker thread wakes up in time.
+ *
+ * @example How to use:
+ *
+ * static void renderJob(void *ctx, size_t idx) { ... }
+ *
+ * NoteNagaDSPThreadPool pool;
+ * pool.run(&renderJob, this, num_jobs); // blocks until all jobs are done
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaDSPThreadPool {
+public:
+    /**
+     * @brief Job function type. Receives user context and index of the job.
+     */
+    typedef void (*JobFunc)(void *context, size_t job_index);
+
+    /**
+     * @brief Construct a new worker pool.
+     *
+     * @param num_workers Number of worker threads. Zero means "hardware concurrency - 1".
+     */
+    explicit NoteNagaDSPThreadPool(size_t num_workers = 0);
+    ~NoteNagaDSPThreadPool();
+
+    // Not copyable/movable
+    NoteNagaDSPThreadPool(const NoteNagaDSPThreadPool &) = delete;
+    NoteNagaDSPThreadPool &operator=(const NoteNagaDSPThreadPool &) = delete;
+
+    /**
+     * @brief Run a set of jobs and wait until all of them are finished.
+     * Must be called from a single thread at a time (typically the audio thread).
+     *
+     * @param func Job function.
+     * @param context User context passed to the job function.
+     * @param num_jobs Number of jobs, job indices are 0 .. num_jobs - 1.
+     */
+    void run(JobFunc func, void *context, size_t num_jobs);
+
+    /**
+     * @brief Get number of worker threads (without the calling thread).
+     */
+    size_t getWorkerCount() const { return workers_.size(); }
+
+private:
+    struct JobSlot {
+        std::atomic<JobFunc> func{nullptr};
+        std::atomic<void *> context{nullptr};
+        std::atomic<uint32_t> num_jobs{0};
+    };
+
+    // Two slots indexed by generation parity, so a slot is never rewritten while
+    // a worker of the previous generation may still read it
+    JobSlot slots_[2];
+
+    // (generation << 32) | index of next unclaimed job
+    std::atomic<uint64_t> state_{0};
+    std::atomic<uint32_t> remaining_{0};
+    uint32_t generation_ = 0; // written only by the dispatching thread
+
+    std::vector<std::thread> workers_;
+    std::atomic<bool> stop_{false};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+
+    void workerLoop();
+    void processJobs(uint32_t generation);
+};
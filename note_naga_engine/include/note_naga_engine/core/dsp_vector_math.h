@@ -0,0 +1,70 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+
+#include <cstddef>
+
+/**
+ * @brief Small vector math layer for the hot loops of the DSP engine and simple blocks.
+ *
+ * Every function has SSE2, AVX2 and NEON implementations and a scalar fallback. The
+ * fastest variant supported by the CPU is selected once at runtime, so the library
+ * does not need to be compiled with AVX2 enabled. Buffers do not need any alignment.
+ */
+
+/**
+ * @brief dst[i] += src[i]
+ */
+NOTE_NAGA_ENGINE_API void nn_vec_add(float *dst, const float *src, size_t n);
+
+/**
+ * @brief dst[i] *= gain
+ */
+NOTE_NAGA_ENGINE_API void nn_vec_scale(float *dst, float gain, size_t n);
+
+/**
+ * @brief dst[i] += src[i] * gain
+ */
+NOTE_NAGA_ENGINE_API void nn_vec_mul_add(float *dst, const float *src, float gain, size_t n);
+
+/**
+ * @brief Interleave two channels: out[2i] = left[i], out[2i + 1] = right[i]
+ */
+NOTE_NAGA_ENGINE_API void nn_vec_interleave(float *out, const float *left, const float *right, size_t n);
+
+/**
+ * @brief Apply a 2x2 stereo matrix in place (pan, mid/side width, ...):
+ * left' = left * ll + right * rl, right' = left * lr + right * rr
+ */
+NOTE_NAGA_ENGINE_API void nn_vec_stereo_matrix(float *left, float *right, float ll, float rl, float lr,
+                                               float rr, size_t n);
+
+/**
+ * @brief Get the maximum absolute sample value (peak)
+ */
+NOTE_NAGA_ENGINE_API float nn_vec_abs_max(const float *src, size_t n);
+
+/**
+ * @brief Get the sum of squared samples (energy, RMS)
+ */
+NOTE_NAGA_ENGINE_API float nn_vec_sum_squares(const float *src, size_t n);
+
+/**
+ * @brief Complex multiply-accumulate of split spectra (convolution in the frequency domain):
+ * acc[i] += a[i] * b[i]
+ */
+NOTE_NAGA_ENGINE_API void nn_vec_complex_mul_add(float *acc_re, float *acc_im, const float *a_re,
+                                                 const float *a_im, const float *b_re, const float *b_im,
+                                                 size_t n);
+
+/**
+ * @brief Radix-2 FFT butterflies of split complex arrays: v = b[i] * w[i],
+ * b[i] = a[i] - v, a[i] = a[i] + v (pass conjugated twiddles for the inverse)
+ */
+NOTE_NAGA_ENGINE_API void nn_vec_fft_butterfly(float *a_re, float *a_im, float *b_re, float *b_im,
+                                               const float *w_re, const float *w_im, size_t n);
+
+/**
+ * @brief Get the name of the instruction set selected at runtime ("avx2", "sse2", "neon" or "scalar")
+ */
+NOTE_NAGA_ENGINE_API const char *nn_vec_get_isa();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <note_naga_engine/core/async_queue_component.h>
 #include <note_naga_engine/core/types.h>
 #include <string>
@@ -147,7 +148,98 @@ Q_SIGNALS:
 // Interface for Soft Synthesizers
 /*******************************************************************************************************/
 
+/**
+ * @brief Policy used to pick the voice that is reused when the voice limit is reached.
+ * Voices in release stage are always stolen first.
+ */
+enum class NOTE_NAGA_ENGINE_API NN_VoiceStealPolicy_t {
+  Oldest,  ///< Steal the voice that was started first
+  Quietest ///< Steal the voice with the lowest current level
+};
+
+/**
+ * @brief Voice usage statistics of a soft synthesizer.
+ */
+struct NOTE_NAGA_ENGINE_API NN_SynthVoiceStats_t {
+  size_t active_voices = 0;   ///< Currently playing voices
+  size_t max_voices = 0;      ///< Currently applied voice limit (0 = unknown)
+  uint64_t stolen_voices = 0; ///< Voices cut to make room for new notes or a lower limit
+  uint64_t dropped_notes = 0; ///< Notes that were not played because of the voice limit
+};
+
 class NOTE_NAGA_ENGINE_API INoteNagaSoftSynth {
 public:
+  /**
+   * @brief Renders the whole synth output (all MIDI channels mixed) into stereo buffers.
+   * @param left Left channel buffer.
+   * @param right Right channel buffer.
+   * @param num_frames Number of frames to render.
+   */
   virtual void renderAudio(float *left, float *right, size_t num_frames) = 0;
+
+  /**
+   * @brief Gets the number of separate stereo outputs the synth can render.
+   * Output N carries MIDI channel N. Synths without multi-output support return 1.
+   * @return Number of stereo outputs.
+   */
+  virtual size_t getAudioOutputCount() const { return 1; }
+
+  /**
+   * @brief Renders every output into its own stereo buffer pair. Buffers are
+   * cleared by the caller. The default implementation renders the whole mix into
+   * output 0.
+   * @param left Array of left channel buffers (one per output).
+   * @param right Array of right channel buffers (one per output).
+   * @param num_outputs Number of buffer pairs, should match getAudioOutputCount().
+   * @param num_frames Number of frames to render.
+   */
+  virtual void renderAudioOutputs(float **left, float **right, size_t num_outputs,
+                                  size_t num_frames) {
+    if (num_outputs > 0)
+      renderAudio(left[0], right[0], num_frames);
+  }
+
+  /**
+   * @brief Gets the number of independent parts the synth can pre-render in parallel
+   * (see renderPart). Zero means the synth renders everything in renderAudio.
+   * @return Number of parts.
+   */
+  virtual size_t getRenderPartCount() const { return 0; }
+
+  /**
+   * @brief Pre-renders one part of the next block into buffers of the synth. The DSP
+   * engine calls it on its worker pool for all parts of a block in parallel, before
+   * renderAudio / renderAudioOutputs of the same block, which then only mix the parts.
+   * Parts not pre-rendered are rendered by renderAudio itself.
+   * @param part Index of the part (0 .. getRenderPartCount() - 1).
+   * @param num_frames Number of frames of the block.
+   */
+  virtual void renderPart(size_t part, size_t num_frames) {}
+
+  /**
+   * @brief Limits the number of simultaneously playing voices. Called by the DSP
+   * engine (also from the audio thread between blocks, so it must not block).
+   * @param max_voices Maximum number of voices (at least 1).
+   */
+  virtual void setVoiceLimit(size_t max_voices) {}
+
+  /**
+   * @brief Sets the policy used to pick a voice to steal when the limit is reached.
+   * Synths with their own stealing algorithm may ignore it.
+   * @param policy Steal policy.
+   */
+  virtual void setVoiceStealPolicy(NN_VoiceStealPolicy_t policy) {}
+
+  /**
+   * @brief Sets the output sample rate. Called by the DSP engine when the output
+   * format changes, never while the synth is rendered.
+   * @param sample_rate Sample rate in Hz.
+   */
+  virtual void setSampleRate(int sample_rate) {}
+
+  /**
+   * @brief Gets voice usage statistics (safe to call from any thread).
+   * @return Voice statistics.
+   */
+  virtual NN_SynthVoiceStats_t getVoiceStats() const { return {}; }
 };
\ No newline at end of file
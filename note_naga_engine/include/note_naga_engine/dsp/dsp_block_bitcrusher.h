@@ -3,6 +3,9 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_oversampler.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
+#include <atomic>
 #include <vector>
 #include <string>
 
@@ -10,24 +13,37 @@
  * @brief DSP Block for a bitcrusher effect.
  *
  * This block implements a simple bitcrusher (bit depth + sample rate reduction).
+ * The Quality parameter oversamples the quantizer; the folded images of the sample
+ * rate reduction are part of the effect and stay either way.
  */
 class NOTE_NAGA_ENGINE_API DSPBlockBitcrusher : public NoteNagaDSPBlockBase {
 public:
     DSPBlockBitcrusher(float bitDepth, int sampleRateReduce, float mix);
 
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
     void process(float* left, float* right, size_t numFrames) override;
 
     std::vector<DSPParamDescriptor> getParamDescriptors() override;
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Bitcrusher"; }
+    size_t getLatencySamples() const override;
 
 private:
+    // Parameters posted by the GUI thread
+    NoteNagaDSPParamMailbox params_{4};
+
+    // Parameters used by the audio thread
     float bitDepth_ = 8.0f;         // 4 ... 16
     int sampleRateReduce_ = 8;      // 1 ... 32
-    float mix_ = 1.0f;              // 0 ... 1
+    NoteNagaSmoothedValue mix_;     // 0 ... 1
+    int quality_ = 0;               // oversampling factor 2^quality_, switched at a block boundary
+    std::atomic<size_t> latencySamples_{0};
 
     // Internal state
     float lastL_ = 0.0f, lastR_ = 0.0f;
     int step_ = 0;
+    NoteNagaOversampler oversampler_;
+
+    void updateParams(size_t rampFrames);
 };
\ No newline at end of file
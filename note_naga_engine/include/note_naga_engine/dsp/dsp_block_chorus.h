@@ -3,6 +3,9 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_delay_line.h>
+#include <note_naga_engine/core/dsp_lfo.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
 #include <vector>
 #include <string>
 
@@ -15,24 +18,29 @@ class NOTE_NAGA_ENGINE_API DSPBlockChorus : public NoteNagaDSPBlockBase {
 public:
     DSPBlockChorus(float speed = 1.2f, float depth = 8.0f, float mix = 0.5f);
 
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
     void process(float* left, float* right, size_t numFrames) override;
 
     std::vector<DSPParamDescriptor> getParamDescriptors() override;
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Chorus"; }
+    float getTailSeconds() const override;
 
 private:
-    float speed_;   // Hz, 0.2 ... 5.0
-    float depth_;   // ms, 4 ... 16
-    float mix_;     // 0 ... 1
+    // Parameters posted by the GUI thread
+    NoteNagaDSPParamMailbox params_{3};
+
+    // Parameters used by the audio thread
+    float speed_ = 1.2f;  // Hz, 0.2 ... 5.0
+    NoteNagaSmoothedValue depth_; // ms, 4 ... 16
+    NoteNagaSmoothedValue mix_;   // 0 ... 1
 
     // Internal state
-    float lfoPhase_ = 0.0f;
-    float sampleRate_ = 44100.0f; // Should be set from engine!
-    std::vector<float> delayBufferL_, delayBufferR_;
-    size_t delayIdx_ = 0;
+    float sampleRate_ = NN_DSP_DEFAULT_SAMPLE_RATE;
     size_t maxDelaySamples_ = 0;
+    NoteNagaLFO lfo_;
+    NoteNagaDelayLine<> delayL_, delayR_;
 
-    void prepareDelayBuffer(size_t numFrames);
+    void updateParams(size_t rampFrames);
 };
\ No newline at end of file
@@ -3,12 +3,16 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_fast_math.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
 #include <cmath>
 
 /**
  * @brief DSP Block for a compressor effect.
  *
  * This block implements a basic compressor with adjustable parameters.
+ * Parameter changes are taken from a lock-free mailbox at block start. The level
+ * detector follows the sidechain input when one is routed (see NoteNagaDSPEngine::setBlockSidechain).
  */
 class NOTE_NAGA_ENGINE_API DSPBlockCompressor : public NoteNagaDSPBlockBase {
 public:
@@ -21,18 +25,22 @@ public:
      * @param release The release time in milliseconds.
      * @param makeup The makeup gain in dB.
      */
-    DSPBlockCompressor(float threshold, float ratio, float attack, float release, float makeup)
-        : threshold_db_(threshold), ratio_(ratio), attack_ms_(attack), release_ms_(release), makeup_db_(makeup) {}
+    DSPBlockCompressor(float threshold, float ratio, float attack, float release, float makeup);
 
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
     void process(float* left, float* right, size_t numFrames) override;
 
     std::vector<DSPParamDescriptor> getParamDescriptors() override;
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Compressor"; }
+    bool supportsSidechain() const override { return true; }
 
 private:
-    // Parameters
+    // Parameters posted by the GUI thread
+    NoteNagaDSPParamMailbox params_{5};
+
+    // Parameters used by the audio thread
     float threshold_db_ = -18.0f;
     float ratio_ = 4.0f;
     float attack_ms_ = 10.0f;
@@ -40,8 +48,15 @@ private:
     float makeup_db_ = 0.0f;
 
     // Internal state
+    float sampleRate_ = NN_DSP_DEFAULT_SAMPLE_RATE;
     float gainSmooth_ = 1.0f;
+    float attackCoeff_ = 0.0f;
+    float releaseCoeff_ = 0.0f;
+    NoteNagaSmoothedValue makeup_;
+
+    void updateParams();
+    void updateCoefficients();
 
     // Helper
-    inline float dB_to_linear(float db) const { return powf(10.0f, db / 20.0f); }
+    inline float dB_to_linear(float db) const { return nn_fast_db_to_linear(db); }
 };
\ No newline at end of file
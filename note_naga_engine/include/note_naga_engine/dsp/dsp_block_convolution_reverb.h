@@ -0,0 +1,137 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+
+#include <note_naga_engine/core/async_queue_component.h>
+#include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_fft.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief DSP Block for a convolution reverb (uniformly partitioned FFT convolution, stereo).
+ *
+ * The impulse response is split into partitions of PARTITION_SIZE samples whose spectra
+ * are computed when the IR changes. The audio thread transforms every full partition of
+ * input once, keeps the input spectra in a frequency domain delay line and multiplies
+ * them with the IR spectra (overlap-save), so the cost per sample only grows with the IR
+ * length, which is bounded by the Length parameter. The wet signal is one partition late
+ * (about 6 ms at 44.1 kHz), the dry signal is delayed by the same partition to stay
+ * aligned with it and the block reports it as getLatencySamples().
+ *
+ * IR partitions 1.. only meet input spectra that are already in the delay line, so their
+ * products are accumulated over the host blocks while the next partition of input fills.
+ * The block that completes a partition only adds partition 0 and runs the transforms,
+ * host blocks smaller than a partition do not see the whole cost at once.
+ *
+ * Without a loaded file the block uses a generated room (decaying stereo noise). Length
+ * and Damping changes rebuild the IR on a worker thread of the block (pending requests
+ * are coalesced, so dragging a dial rebuilds only for the latest value), files are built
+ * on the calling thread. IRs are handed to the audio thread through an atomic pointer,
+ * the old and new IR are crossfaded over one partition.
+ */
+class NOTE_NAGA_ENGINE_API DSPBlockConvolutionReverb : public NoteNagaDSPBlockBase,
+                                                       public AsyncQueueComponent<NN_AsyncTriggerMessage_t, 16> {
+public:
+    /// Number of samples in one partition (and latency of the wet signal)
+    static constexpr size_t PARTITION_SIZE = 256;
+    /// Maximum length of the impulse response in seconds
+    static constexpr float MAX_LENGTH = 4.0f;
+
+    DSPBlockConvolutionReverb(float mix, float length, float damping);
+    ~DSPBlockConvolutionReverb() override;
+
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
+    void process(float *left, float *right, size_t numFrames) override;
+
+    std::vector<DSPParamDescriptor> getParamDescriptors() override;
+    float getParamValue(size_t idx) const override;
+    void setParamValue(size_t idx, float value) override;
+    std::string getBlockName() const override { return "Convolution Reverb"; }
+    float getTailSeconds() const override;
+    size_t getLatencySamples() const override { return PARTITION_SIZE; }
+
+    /**
+     * @brief Load the impulse response from a WAV file (mono or stereo, any sample rate).
+     * Must not be called from the audio thread.
+     * @param path Path to the WAV file.
+     * @return True if the file was loaded.
+     */
+    bool loadImpulseResponse(const std::string &path);
+
+    /**
+     * @brief Drop the loaded file and use the generated room again.
+     */
+    void useGeneratedRoom();
+
+    /**
+     * @brief Get the path of the loaded impulse response (empty for the generated room).
+     */
+    std::string getImpulseResponsePath() const;
+
+protected:
+    /**
+     * @brief Rebuild the IR for the latest Length and Damping (worker thread)
+     */
+    void onItem(const NN_AsyncTriggerMessage_t &) override;
+
+private:
+    static constexpr size_t FFT_SIZE = 2 * PARTITION_SIZE;
+    static constexpr size_t NUM_BINS = PARTITION_SIZE + 1;
+
+    // Spectra of all IR partitions, [partition * NUM_BINS + bin] per channel
+    struct Kernel {
+        size_t partitions = 0;
+        std::vector<float> re[2];
+        std::vector<float> im[2];
+    };
+
+    // Parameters posted by the GUI thread
+    NoteNagaDSPParamMailbox params_{3};
+    NoteNagaSmoothedValue mixRamp_;
+
+    // IR source and kernel building (GUI side and worker, never locked by the audio thread)
+    mutable std::mutex irMutex_;
+    std::atomic<bool> rebuildQueued_{false};
+    std::string irPath_;
+    std::vector<float> irLeft_, irRight_;
+    float irSampleRate_ = 44100.0f;
+    float sampleRate_ = NN_DSP_DEFAULT_SAMPLE_RATE;
+    NoteNagaFFT buildFFT_;
+
+    // Kernel hand-over: pending_ is written by the GUI side and taken by the audio thread,
+    // retired_ is written by the audio thread and freed by the GUI side
+    std::atomic<Kernel *> pending_{nullptr};
+    std::atomic<Kernel *> retired_{nullptr};
+    Kernel *kernel_ = nullptr;
+    Kernel *fadeFrom_ = nullptr;
+    Kernel *retiring_ = nullptr; // waits for retired_ to be free
+
+    // Audio thread state
+    NoteNagaFFT fft_;
+    size_t maxPartitions_ = 0;
+    size_t fdlPos_ = 0;
+    size_t inPos_ = 0;
+    std::vector<float> input_[2];  // last two partitions of input (FFT_SIZE), the first is the delayed dry
+    std::vector<float> output_[2]; // wet output of the last partition (PARTITION_SIZE)
+    std::vector<float> fdlRe_[2];  // input spectra, maxPartitions_ * NUM_BINS
+    std::vector<float> fdlIm_[2];
+    std::vector<float> tailRe_[2][2];  // [kernel_, fadeFrom_][channel] sums of IR partitions 1..
+    std::vector<float> tailIm_[2][2];
+    size_t tailDone_ = 1;              // next IR partition to accumulate
+    size_t tailPartitions_ = 0;        // IR partitions of the longer kernel
+    std::vector<float> timeBuf_, fadeBuf_;
+
+    void processPartition();
+    void beginPartition();
+    void accumulateTail(size_t until);
+    void finishConvolution(const Kernel &kernel, int slot, int channel, float *out);
+
+    void rebuildKernel();
+    void requestRebuild();
+    void publishKernel(Kernel *kernel);
+    void generateRoom(float length, std::vector<float> &left, std::vector<float> &right) const;
+};
@@ -3,6 +3,8 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_delay_line.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
 #include <vector>
 #include <string>
 
@@ -21,28 +23,33 @@ public:
      */
     DSPBlockDelay(float time_ms, float feedback, float mix);
 
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
     void process(float* left, float* right, size_t numFrames) override;
 
     std::vector<DSPParamDescriptor> getParamDescriptors() override;
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Delay"; }
-
-    // Call when changing sample rate
-    void setSampleRate(float sr);
+    float getTailSeconds() const override;
 
 private:
-    // Parameters
+    // Parameters posted by the GUI thread
+    NoteNagaDSPParamMailbox params_{3};
+
+    // Parameters used by the audio thread
     float time_ms_ = 400.0f;
     float feedback_ = 0.25f;
     float mix_ = 0.5f;
 
     // Internal state
-    float sampleRate_ = 44100.0f;
-    size_t delayIdx_ = 0;
-    size_t maxDelaySamples_ = 44100; // 1 second max
+    float sampleRate_ = NN_DSP_DEFAULT_SAMPLE_RATE;
+    size_t maxDelaySamples_ = 88200; // 2 seconds max
+    NoteNagaSmoothedValue feedbackRamp_;
+    NoteNagaSmoothedValue mixRamp_;
+    NoteNagaSmoothedValue tapRamp_; // read tap in samples, glides (tape style) on a time change
 
-    std::vector<float> delayBufferL_, delayBufferR_;
+    NoteNagaDelayLine<> delayL_, delayR_;
 
-    void resizeDelayBuffers();
+    void updateParams();
+    float delayTap() const;
 };
\ No newline at end of file
@@ -3,31 +3,47 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_oversampler.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
+#include <atomic>
 #include <string>
 #include <vector>
 
 /**
  * @brief DSP Block for an exciter effect.
  *
- * Adds brightness and harmonics to high frequencies.
+ * Adds brightness and harmonics to high frequencies. The high band is split off
+ * and saturated at the oversampled rate (Quality parameter), the harmonics of
+ * high notes would alias far down otherwise.
  */
 class NOTE_NAGA_ENGINE_API DSPBlockExciter : public NoteNagaDSPBlockBase {
 public:
     DSPBlockExciter(float freq = 4000.0f, float drive = 4.0f, float mix = 0.6f);
 
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
     void process(float *left, float *right, size_t numFrames) override;
 
     std::vector<DSPParamDescriptor> getParamDescriptors() override;
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Exciter"; }
+    size_t getLatencySamples() const override;
 
 private:
-    float freq_;  // Hz, 1000...12000
-    float drive_; // 1.0..10.0
-    float mix_;   // 0..1
+    // Parameters posted by the GUI thread
+    NoteNagaDSPParamMailbox params_{4};
 
-    // Internal state for single-pole HP filter
-    float hpL_ = 0.0f, hpR_ = 0.0f;
-    float sampleRate_ = 44100.0f;
+    // Parameters used by the audio thread
+    float freq_ = 4000.0f;        // Hz, 1000...12000
+    NoteNagaSmoothedValue drive_; // 1.0..10.0
+    NoteNagaSmoothedValue mix_;   // 0..1
+    int quality_ = 1; // oversampling factor 2^quality_, switched at a block boundary
+    std::atomic<size_t> latencySamples_{0};
+
+    // Internal state of the single-pole low-pass, high band = input - low-pass
+    float lpL_ = 0.0f, lpR_ = 0.0f;
+    float sampleRate_ = NN_DSP_DEFAULT_SAMPLE_RATE;
+    NoteNagaOversampler oversampler_;
+
+    void updateParams(size_t rampFrames);
 };
\ No newline at end of file
@@ -3,12 +3,14 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_biquad.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
 #include <string>
 #include <vector>
 
 /**
  * @brief DSP Block for multimode filter (lowpass, highpass, bandpass).
- * Implements a simple biquad filter.
+ * Implements a simple biquad filter (one stage of NoteNagaBiquadCascade).
  */
 enum class NOTE_NAGA_ENGINE_API FilterType {
     Lowpass = 0,
@@ -25,6 +27,7 @@ class NOTE_NAGA_ENGINE_API DSPBlockFilter : public NoteNagaDSPBlockBase {
 public:
     DSPBlockFilter(FilterType type, float cutoff, float resonance, float mix);
 
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
     void process(float* left, float* right, size_t numFrames) override;
 
     std::vector<DSPParamDescriptor> getParamDescriptors() override;
@@ -32,21 +35,25 @@ public:
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Filter"; }
 
-    void setSampleRate(float sr);
-
 private:
-    // Parameters
+    // Parameters posted by the GUI thread
+    NoteNagaDSPParamMailbox params_{4};
+
+    // Parameters used by the audio thread
     FilterType type_ = FilterType::Lowpass;
     float cutoff_ = 800.0f;      // Hz
     float resonance_ = 0.7f;     // Q (0.1 ... 2.0)
     float mix_ = 1.0f;           // 0 ... 1
 
-    float sampleRate_ = 44100.0f;
+    float sampleRate_ = NN_DSP_DEFAULT_SAMPLE_RATE;
+
+    // One stage biquad, filter state is kept across coefficient changes
+    NoteNagaBiquadCascade filter_;
+    NoteNagaSmoothedValue mixRamp_;
 
-    // Biquad coefficients and state
-    float a0_, a1_, a2_, b1_, b2_;
-    float z1L_ = 0.0f, z2L_ = 0.0f;
-    float z1R_ = 0.0f, z2R_ = 0.0f;
+    // Dry copy for the mix, preallocated in prepare()
+    std::vector<float> dryL_, dryR_;
 
+    void updateParams();
     void calcCoeffs();
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
 
 /** 
  * @brief DSP Block for a gain effect.
@@ -14,7 +15,7 @@ public:
      *
      * @param gain The gain value in dB.
      */
-    DSPBlockGain(float gain) : gain_(gain) {}
+    DSPBlockGain(float gain);
 
     void process(float* left, float* right, size_t numFrames) override;
 
@@ -24,5 +25,11 @@ public:
     std::string getBlockName() const override { return "Gain"; }
 
 private:
-    float gain_ = 0.0f;
+    // Parameters posted by the GUI thread
+    NoteNagaDSPParamMailbox params_{1};
+
+    // Linear gain used by the audio thread
+    NoteNagaSmoothedValue gain_;
+
+    void updateParams(size_t rampFrames);
 };
\ No newline at end of file
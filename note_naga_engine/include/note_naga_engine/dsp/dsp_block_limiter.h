@@ -3,12 +3,27 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_delay_line.h>
+#include <note_naga_engine/core/dsp_fast_math.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
+#include <note_naga_engine/core/dsp_sliding_max.h>
+#include <atomic>
 #include <cmath>
+#include <vector>
 
 /**
  * @brief DSP Block for a limiter effect.
  *
- * This block implements a basic brickwall limiter.
+ * Two modes:
+ * - Reactive: basic brickwall limiter without latency, the gain follows the sample peaks
+ *   instantly, so fast transients are clipped and inter-sample peaks pass.
+ * - True Peak: the signal is delayed by the lookahead and the gain ramps down over the
+ *   lookahead before a peak arrives. Peaks are detected on a 4x oversampled signal
+ *   (inter-sample peaks), held over the lookahead window with a sliding maximum (O(1)
+ *   per sample) and the gain is smoothed by a moving average of the same length, which
+ *   keeps it below the required gain at the peak. Adds getLatencySamples() of delay.
+ *   Lookahead changes only move the delay tap and the windows within the buffers of
+ *   the longest lookahead, the delayed signal is kept.
  */
 class NOTE_NAGA_ENGINE_API DSPBlockLimiter : public NoteNagaDSPBlockBase {
 public:
@@ -19,25 +34,62 @@ public:
      * @param release The release time in milliseconds.
      * @param makeup The makeup gain in dB.
      */
-    DSPBlockLimiter(float threshold, float release, float makeup)
-        : threshold_db_(threshold), release_ms_(release), makeup_db_(makeup) {}
+    DSPBlockLimiter(float threshold, float release, float makeup);
 
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
     void process(float* left, float* right, size_t numFrames) override;
 
     std::vector<DSPParamDescriptor> getParamDescriptors() override;
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Limiter"; }
+    float getTailSeconds() const override { return float(getLatencySamples()) / sampleRate_; }
+    size_t getLatencySamples() const override;
+
+    /// Longest lookahead in milliseconds
+    static constexpr float MAX_LOOKAHEAD_MS = 10.0f;
 
 private:
-    // Parameters
-    float threshold_db_ = -0.5f;
-    float release_ms_ = 50.0f;
-    float makeup_db_ = 0.0f;
+    // Taps per phase of the 4x true peak interpolator and the lag of its last phase
+    static constexpr size_t TRUE_PEAK_TAPS = 12;
+    static constexpr size_t TRUE_PEAK_DELAY = TRUE_PEAK_TAPS / 2 - 1;
+
+    // Parameters, written by the GUI, applied by the audio thread at block start
+    NoteNagaDSPParamMailbox params_{5}; // threshold dB, release ms, makeup dB, mode, lookahead ms
 
     // Internal state
+    float sampleRate_ = NN_DSP_DEFAULT_SAMPLE_RATE;
     float gainSmooth_ = 1.0f;
 
+    // Coefficients of the applied parameters (audio thread)
+    float threshold_ = 1.0f;
+    float makeup_ = 1.0f;
+    float releaseCoeff_ = 0.0f;
+    int coeffMode_ = -1; // 0 = reactive, 1 = true peak with lookahead
+    std::atomic<size_t> latencySamples_{0};
+
+    // True peak mode
+    size_t maxLookaheadFrames_ = 0;
+    size_t lookaheadFrames_ = 0;
+    NoteNagaDelayLine<float> delayL_;
+    NoteNagaDelayLine<float> delayR_;
+    std::vector<float> historyL_;    // last TRUE_PEAK_TAPS inputs, stored twice for contiguous reads
+    std::vector<float> historyR_;
+    size_t historyPos_ = 0;
+    NoteNagaSlidingMax peakHold_;    // true peak over the lookahead window
+    std::vector<float> peakRing_;    // true peaks of the longest window, refill peakHold_ on resize
+    std::vector<float> gainRing_;    // required gains of the longest window, moving average input
+    size_t ringPos_ = 0;             // next write position of both rings
+    double gainWindowSum_ = 0.0;     // sum of the last lookaheadFrames_ + 1 required gains
+
+    void updateParams(bool force = false);
+    size_t lookaheadFrames(float ms) const;
+    void resetLookahead();
+    void resizeLookahead(size_t frames);
+    void rebuildGainSum();
+    float truePeak(const float *history) const;
+    void processLookahead(float* left, float* right, size_t numFrames);
+
     // Helper
-    inline float dB_to_linear(float db) const { return powf(10.0f, db / 20.0f); }
+    inline float dB_to_linear(float db) const { return nn_fast_db_to_linear(db); }
 };
\ No newline at end of file
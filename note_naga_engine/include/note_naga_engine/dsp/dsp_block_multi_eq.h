@@ -3,16 +3,22 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_biquad.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
 #include <vector>
 #include <string>
 
 /**
  * @brief DSP Block for a multi-band EQ with fixed frequencies and only gain controls.
+ * Gain changes are taken from a lock-free mailbox and ramped at block rate, so the
+ * coefficients of a band are recomputed at most once per block. All bands run as one
+ * SIMD biquad cascade.
  */
 class NOTE_NAGA_ENGINE_API DSPBlockMultiSimpleEQ : public NoteNagaDSPBlockBase {
 public:
     DSPBlockMultiSimpleEQ(const std::vector<float>& freqs, float q = 1.0f);
 
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
     void process(float* left, float* right, size_t numFrames) override;
 
     std::vector<DSPParamDescriptor> getParamDescriptors() override;
@@ -21,23 +27,21 @@ public:
     std::string getBlockName() const override { return "Multi Band EQ"; }
 
     void recalcCoeffs(int band);
-    void setSampleRate(float sr);
 
 private:
     struct Band {
         float freq;
         float gain;
         float q;
-
-        // biquad coefficients (RBJ cookbook)
-        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;
-        float a0 = 1.0f, a1 = 0.0f, a2 = 0.0f;
-
-        // filter state for each channel
-        float x1l = 0, x2l = 0, y1l = 0, y2l = 0;
-        float x1r = 0, x2r = 0, y1r = 0, y2r = 0;
+        NoteNagaSmoothedValue gainRamp;
     };
 
+    // Band gains posted by the GUI thread
+    NoteNagaDSPParamMailbox params_;
+
     std::vector<Band> bands_;
-    float sampleRate_ = 44100.0f;
+    NoteNagaBiquadCascade cascade_; // one stage per band
+    float sampleRate_ = NN_DSP_DEFAULT_SAMPLE_RATE;
+
+    void updateParams(size_t numFrames);
 };
\ No newline at end of file
@@ -3,31 +3,43 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
 #include <vector>
 #include <string>
 
 /**
  * @brief DSP Block for a noise gate effect.
  *
- * Silences audio below threshold, useful for cleaning up noise.
+ * Silences audio below threshold, useful for cleaning up noise. With a sidechain
+ * routed (see NoteNagaDSPEngine::setBlockSidechain) the gate opens on the sidechain level.
  */
 class NOTE_NAGA_ENGINE_API DSPBlockNoiseGate : public NoteNagaDSPBlockBase {
 public:
     DSPBlockNoiseGate(float threshold = -40.0f, float attack = 5.0f, float release = 80.0f);
 
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
     void process(float* left, float* right, size_t numFrames) override;
 
     std::vector<DSPParamDescriptor> getParamDescriptors() override;
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Noise Gate"; }
+    bool supportsSidechain() const override { return true; }
 
 private:
-    float threshold_; // dBFS, -60..0 dB
-    float attack_;    // ms, 1..50 ms
-    float release_;   // ms, 10..500 ms
+    // Parameters posted by the GUI thread: threshold (dBFS, -60..0 dB),
+    // attack (ms, 1..50 ms), release (ms, 10..500 ms)
+    NoteNagaDSPParamMailbox params_{3};
 
     // Internal state
     float gain_ = 0.0f;
-    float sampleRate_ = 44100.0f; // Should be set from engine!
+    float sampleRate_ = NN_DSP_DEFAULT_SAMPLE_RATE;
+
+    // Coefficients used by the audio thread. The gate gain follows them through its
+    // own attack / release smoothing, so a parameter change needs no extra ramp.
+    float threshLinear_ = 0.0f;
+    float attackCoef_ = 0.0f;
+    float releaseCoef_ = 0.0f;
+
+    void updateCoefficients();
 };
\ No newline at end of file
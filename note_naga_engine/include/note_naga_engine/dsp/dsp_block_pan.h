@@ -3,6 +3,7 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
 
 /**
  * @brief DSP Block for a pan effect.
@@ -16,7 +17,7 @@ public:
      *
      * @param pan The pan value, where -1 is full left, 0 is center, and 1 is full right.
      */
-    DSPBlockPan(float pan) : pan_(pan) {}
+    DSPBlockPan(float pan);
 
     void process(float* left, float* right, size_t numFrames) override;
 
@@ -26,5 +27,11 @@ public:
     std::string getBlockName() const override { return "Pan"; }
 
 private:
-    float pan_ = 0.0f; // -1 = Left, 0 = Center, 1 = Right
+    // Parameters posted by the GUI thread (pan: -1 = Left, 0 = Center, 1 = Right)
+    NoteNagaDSPParamMailbox params_{1};
+
+    // Channel gains used by the audio thread
+    NoteNagaSmoothedValue leftGain_, rightGain_;
+
+    void updateParams(size_t rampFrames);
 };
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_lfo.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
 #include <vector>
 #include <string>
 
@@ -15,21 +17,27 @@ class NOTE_NAGA_ENGINE_API DSPBlockPhaser : public NoteNagaDSPBlockBase {
 public:
     DSPBlockPhaser(float speed = 0.6f, float depth = 0.8f, float feedback = 0.4f, float mix = 0.5f);
 
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
     void process(float* left, float* right, size_t numFrames) override;
 
     std::vector<DSPParamDescriptor> getParamDescriptors() override;
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Phaser"; }
+    float getTailSeconds() const override;
 
 private:
-    float speed_;      // Hz, 0.1 .. 3.0
-    float depth_;      // Sweep depth, 0..1
-    float feedback_;   // Feedback amount, 0..0.95
-    float mix_;        // Dry/Wet, 0..1
+    // Parameters posted by the GUI thread
+    NoteNagaDSPParamMailbox params_{4};
 
-    float sampleRate_ = 44100.0f; // Should be set from engine!
-    float lfoPhase_ = 0.0f;
+    // Parameters used by the audio thread
+    float speed_ = 0.6f;             // Hz, 0.1 .. 3.0
+    NoteNagaSmoothedValue depth_;    // Sweep depth, 0..1
+    NoteNagaSmoothedValue feedback_; // Feedback amount, 0..0.95
+    NoteNagaSmoothedValue mix_;      // Dry/Wet, 0..1
+
+    float sampleRate_ = NN_DSP_DEFAULT_SAMPLE_RATE;
+    NoteNagaLFO lfo_;
 
     // Phaser state: 6 all-pass stages per channel
     static constexpr int stages_ = 6;
@@ -37,4 +45,6 @@ private:
     float zR_[stages_] = {0}; // Memory for right all-pass
 
     float prevOutL_ = 0.0f, prevOutR_ = 0.0f; // Last output for feedback
+
+    void updateParams(size_t rampFrames);
 };
\ No newline at end of file
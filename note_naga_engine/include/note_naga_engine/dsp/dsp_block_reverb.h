@@ -3,45 +3,62 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_delay_line.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
 #include <vector>
 #include <string>
+#include <algorithm>
 
 /**
  * @brief DSP Block for a simple algorithmic reverb effect (Schroeder/Moorer, stereo).
+ * All delay buffers are allocated for the largest room and predelay, parameter changes
+ * only move read lengths and coefficients on the audio thread. Comb lengths glide to a
+ * new room size, a jump of the loop length would click.
  */
 class NOTE_NAGA_ENGINE_API DSPBlockReverb : public NoteNagaDSPBlockBase {
 public:
     DSPBlockReverb(float roomsize, float damping, float wet, float predelay);
 
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
     void process(float* left, float* right, size_t numFrames) override;
 
     std::vector<DSPParamDescriptor> getParamDescriptors() override;
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Reverb"; }
-
-    void setSampleRate(float sr);
+    float getTailSeconds() const override;
 
 private:
-    // Parameters
+    // Parameters posted by the GUI thread
+    NoteNagaDSPParamMailbox params_{4};
+
+    // Parameters used by the audio thread
     float roomsize_ = 0.7f;   // 0.0 ... 1.0
     float damping_  = 0.5f;   // 0.0 ... 1.0
     float wet_      = 0.3f;   // 0.0 ... 1.0
     float predelay_ = 40.0f;  // ms
 
     // Internal state
-    float sampleRate_ = 44100.0f;
+    float sampleRate_ = NN_DSP_DEFAULT_SAMPLE_RATE;
+    NoteNagaSmoothedValue wetRamp_;
+    NoteNagaSmoothedValue predelayRamp_; // in samples
+    NoteNagaSmoothedValue feedbackRamp_; // comb feedback, follows the room size
 
     // Comb filters (4 per channel)
     struct CombFilter {
-        std::vector<float> buf;
-        size_t idx = 0;
-        float feedback, damp, damp1, damp2;
+        NoteNagaDelayLine<> line;
+        NoteNagaSmoothedValue len; // loop length in samples
+        float damp1 = 0.0f, damp2 = 0.0f;
         float filter_store = 0.0f;
+        size_t maxLen = 1;
 
-        CombFilter() : feedback(0.0f), damp(0.0f), damp1(0.0f), damp2(0.0f) {}
-        void resize(size_t len) { buf.resize(len, 0.0f); idx = 0; }
-        float process(float inp);
+        void allocate(size_t maxLength) {
+            maxLen = maxLength;
+            line.setMaxDelay(maxLen);
+            len.reset(float(maxLen));
+            filter_store = 0.0f;
+        }
+        float process(float inp, float feedback);
     };
 
     // Allpass filters (2 per channel)
@@ -51,7 +68,7 @@ private:
         float feedback;
 
         AllpassFilter() : feedback(0.5f) {}
-        void resize(size_t len) { buf.resize(len, 0.0f); idx = 0; }
+        void allocate(size_t len) { buf.assign(len, 0.0f); idx = 0; }
         float process(float inp);
     };
 
@@ -59,10 +76,11 @@ private:
     std::vector<CombFilter> combL_, combR_;
     std::vector<AllpassFilter> allpassL_, allpassR_;
 
-    // Predelay buffer
+    // Predelay buffer (sized for the maximum predelay)
     std::vector<float> predelayBufL_, predelayBufR_;
     size_t predelayIdx_ = 0;
-    size_t predelayLen_ = 0;
 
+    void allocateBuffers();
+    void updateParams();
     void updateFilters();
 };
\ No newline at end of file
@@ -3,26 +3,42 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_oversampler.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
+#include <atomic>
 #include <vector>
 #include <string>
 
 /**
  * @brief DSP Block for a saturator effect.
  *
- * Adds analog-style harmonics via soft clipping.
+ * Adds analog-style harmonics via soft clipping. The clipper runs oversampled
+ * (Quality parameter) so the harmonics above Nyquist do not fold back as aliasing.
  */
 class NOTE_NAGA_ENGINE_API DSPBlockSaturator : public NoteNagaDSPBlockBase {
 public:
     DSPBlockSaturator(float drive = 2.0f, float mix = 0.7f);
 
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
     void process(float* left, float* right, size_t numFrames) override;
 
     std::vector<DSPParamDescriptor> getParamDescriptors() override;
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Saturator"; }
+    size_t getLatencySamples() const override;
 
 private:
-    float drive_; // 1.0 .. 10.0
-    float mix_;   // 0 .. 1
+    // Parameters posted by the GUI thread
+    NoteNagaDSPParamMailbox params_{3};
+
+    // Parameters used by the audio thread
+    NoteNagaSmoothedValue drive_; // 1.0 .. 10.0
+    NoteNagaSmoothedValue mix_;   // 0 .. 1
+    int quality_ = 1; // oversampling factor 2^quality_, switched at a block boundary
+    std::atomic<size_t> latencySamples_{0};
+
+    NoteNagaOversampler oversampler_;
+
+    void updateParams(size_t rampFrames);
 };
\ No newline at end of file
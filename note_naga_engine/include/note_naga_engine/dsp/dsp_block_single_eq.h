@@ -3,14 +3,18 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_biquad.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
 
 /**
  * @brief DSP Block for a single band EQ effect (peak filter, biquad).
+ * Coefficients are recomputed at block start, only after a parameter change.
  */
 class NOTE_NAGA_ENGINE_API DSPBlockSingleEQ : public NoteNagaDSPBlockBase {
 public:
     DSPBlockSingleEQ(float freq, float gain, float q);
 
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
     void process(float* left, float* right, size_t numFrames) override;
 
     std::vector<DSPParamDescriptor> getParamDescriptors() override;
@@ -20,20 +24,16 @@ public:
 
     void recalcCoeffs();
 
-    void setSampleRate(float sr);
-
 private:
+    // Parameters posted by the GUI thread
+    NoteNagaDSPParamMailbox params_{3};
+
+    // Parameters used by the audio thread
     float freq_ = 1000.0f;
     float gain_ = 0.0f;
     float q_ = 1.0f;
 
-    // biquad coefficients (RBJ cookbook)
-    float b0_ = 1.0f, b1_ = 0.0f, b2_ = 0.0f;
-    float a0_ = 1.0f, a1_ = 0.0f, a2_ = 0.0f;
-
-    // filter state for each channel
-    float x1l_ = 0, x2l_ = 0, y1l_ = 0, y2l_ = 0;
-    float x1r_ = 0, x2r_ = 0, y1r_ = 0, y2r_ = 0;
+    NoteNagaBiquadCascade filter_;
 
-    float sampleRate_ = 44100.0f;
+    float sampleRate_ = NN_DSP_DEFAULT_SAMPLE_RATE;
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
 #include <vector>
 #include <string>
 
@@ -23,5 +24,9 @@ public:
     std::string getBlockName() const override { return "Stereo Imager"; }
 
 private:
-    float width_; // -1.0 = mono, 0.0 = normal, 1.0 = super wide
+    // Parameters posted by the GUI thread (width: -1.0 = mono, 0.0 = normal, 1.0 = super wide)
+    NoteNagaDSPParamMailbox params_{1};
+
+    // Width used by the audio thread
+    NoteNagaSmoothedValue width_;
 };
\ No newline at end of file
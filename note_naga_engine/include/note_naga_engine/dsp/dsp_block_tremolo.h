@@ -3,6 +3,8 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_lfo.h>
+#include <note_naga_engine/core/dsp_param_mailbox.h>
 #include <string>
 
 /**
@@ -12,6 +14,7 @@ class NOTE_NAGA_ENGINE_API DSPBlockTremolo : public NoteNagaDSPBlockBase {
 public:
     DSPBlockTremolo(float speed, float depth, float mix);
 
+    void prepare(float sampleRate, size_t maxBlockFrames) override;
     void process(float *left, float *right, size_t numFrames) override;
 
     std::vector<DSPParamDescriptor> getParamDescriptors() override;
@@ -19,12 +22,16 @@ public:
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Tremolo"; }
 
-    void setSampleRate(float sr);
-
 private:
-    float speed_ = 5.0f; // Hz
-    float depth_ = 0.8f; // 0 ... 1
-    float mix_ = 1.0f;   // 0 ... 1
-    float sampleRate_ = 44100.0f;
-    float phase_ = 0.0f;
+    // Parameters posted by the GUI thread
+    NoteNagaDSPParamMailbox params_{3};
+
+    // Parameters used by the audio thread
+    float speed_ = 5.0f;          // Hz
+    NoteNagaSmoothedValue depth_; // 0 ... 1
+    NoteNagaSmoothedValue mix_;   // 0 ... 1
+    float sampleRate_ = NN_DSP_DEFAULT_SAMPLE_RATE;
+    NoteNagaLFO lfo_;
+
+    void updateParams(size_t rampFrames);
 };
\ No newline at end of file
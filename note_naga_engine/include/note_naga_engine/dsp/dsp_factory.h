@@ -1,6 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -10,6 +14,7 @@
 #include <note_naga_engine/dsp/dsp_block_bitcrusher.h>
 #include <note_naga_engine/dsp/dsp_block_chorus.h>
 #include <note_naga_engine/dsp/dsp_block_compressor.h>
+#include <note_naga_engine/dsp/dsp_block_convolution_reverb.h>
 #include <note_naga_engine/dsp/dsp_block_delay.h>
 #include <note_naga_engine/dsp/dsp_block_exciter.h>
 #include <note_naga_engine/dsp/dsp_block_filter.h>
@@ -141,6 +146,22 @@ NOTE_NAGA_ENGINE_API inline NoteNagaDSPBlockBase *nn_create_reverb_block(float r
     return new DSPBlockReverb(roomsize, damping, wet, predelay);
 }
 
+/**
+ * @brief Factory function to create a convolution reverb audio block.
+ *
+ * This function creates a DSP block that convolves the audio signal with an impulse
+ * response (generated room, or a WAV file loaded with loadImpulseResponse()).
+ *
+ * @param mix Dry/Wet mix (0.0 .. 1.0, default 0.3).
+ * @param length Maximum length of the impulse response in seconds (0.2 .. 4.0, default 2.0).
+ * @param damping Damping of the reverb tail (0.0 .. 1.0, default 0.3).
+ * @return Pointer to the created DSP block.
+ */
+NOTE_NAGA_ENGINE_API inline NoteNagaDSPBlockBase *nn_create_convolution_reverb_block(float mix = 0.3f, float length = 2.0f,
+                                                                float damping = 0.3f) {
+    return new DSPBlockConvolutionReverb(mix, length, damping);
+}
+
 /**
  * @brief Factory function to create a bitcrusher audio block.
  *
@@ -302,6 +323,8 @@ NOTE_NAGA_ENGINE_API inline NoteNagaDSPBlockBase *nn_create_stereo_imager_block(
 struct NOTE_NAGA_ENGINE_API DSPBlockFactoryEntry {
     std::string name;
     std::function<NoteNagaDSPBlockBase *()> create;
+    uint32_t type_id = 0;   // Stable id stored in chain presets, never reused
+    std::string block_name; // getBlockName() of created blocks when it differs from name
 };
 
 /**
@@ -311,25 +334,79 @@ class NOTE_NAGA_ENGINE_API DSPBlockFactory {
 public:
     static const std::vector<DSPBlockFactoryEntry> &allBlocks() {
         static std::vector<DSPBlockFactoryEntry> blocks = {
-            {"Gain", []() { return nn_create_audio_gain_block(); }},
-            {"Pan", []() { return nn_create_audio_pan_block(); }},
-            {"Single EQ", []() { return nn_create_single_band_eq_block(); }},
-            {"Multi Band EQ", []() { return nn_create_multi_band_eq_block(); }},
-            {"Compressor", []() { return nn_create_compressor_block(); }},
-            {"Limiter", []() { return nn_create_limiter_block(); }},
-            {"Delay", []() { return nn_create_delay_block(); }},
-            {"Reverb", []() { return nn_create_reverb_block(); }},
-            {"Bitcrusher", []() { return nn_create_bitcrusher_block(); }},
-            {"Tremolo", []() { return nn_create_tremolo_block(); }},
-            {"Filter", []() { return nn_create_filter_block(); }},
-            {"Chorus", []() { return nn_create_chorus_block(); }},
-            {"Phaser", []() { return nn_create_phaser_block(); }},
-            {"Flanger", []() { return nn_create_flanger_block(); }},
-            {"Noise Gate", []() { return nn_create_noise_gate_block(); }},
-            {"Saturator", []() { return nn_create_saturator_block(); }},
-            {"Exciter", []() { return nn_create_exciter_block(); }},
-            {"Stereo Imager", []() { return nn_create_stereo_imager_block(); }}
+            {"Gain", []() { return nn_create_audio_gain_block(); }, 1},
+            {"Pan", []() { return nn_create_audio_pan_block(); }, 2},
+            {"Single EQ", []() { return nn_create_single_band_eq_block(); }, 3, "Single Band EQ"},
+            {"Multi Band EQ", []() { return nn_create_multi_band_eq_block(); }, 4},
+            {"Compressor", []() { return nn_create_compressor_block(); }, 5},
+            {"Limiter", []() { return nn_create_limiter_block(); }, 6},
+            {"Delay", []() { return nn_create_delay_block(); }, 7},
+            {"Reverb", []() { return nn_create_reverb_block(); }, 8},
+            {"Convolution Reverb", []() { return nn_create_convolution_reverb_block(); }, 9},
+            {"Bitcrusher", []() { return nn_create_bitcrusher_block(); }, 10},
+            {"Tremolo", []() { return nn_create_tremolo_block(); }, 11},
+            {"Filter", []() { return nn_create_filter_block(); }, 12},
+            {"Chorus", []() { return nn_create_chorus_block(); }, 13},
+            {"Phaser", []() { return nn_create_phaser_block(); }, 14},
+            {"Flanger", []() { return nn_create_flanger_block(); }, 15},
+            {"Noise Gate", []() { return nn_create_noise_gate_block(); }, 16},
+            {"Saturator", []() { return nn_create_saturator_block(); }, 17},
+            {"Exciter", []() { return nn_create_exciter_block(); }, 18},
+            {"Stereo Imager", []() { return nn_create_stereo_imager_block(); }, 19}
         };
         return blocks;
     }
+
+    /**
+     * @brief Find the entry with the given type id.
+     * @return Entry or nullptr for an unknown id.
+     */
+    static const DSPBlockFactoryEntry *findById(uint32_t type_id) {
+        for (const auto &entry : allBlocks()) {
+            if (entry.type_id == type_id) return &entry;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Find the entry with the given name.
+     * @return Entry or nullptr for an unknown name.
+     */
+    static const DSPBlockFactoryEntry *findByName(const std::string &name) {
+        for (const auto &entry : allBlocks()) {
+            if (entry.name == name) return &entry;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Get the parameter descriptors of blocks created by an entry. They do not
+     * depend on the block state, so a block is created only on the first call per entry
+     * (some blocks start threads or build tables when they are created).
+     * @return Descriptors, valid for the lifetime of the program.
+     */
+    static const std::vector<DSPParamDescriptor> &paramDescriptors(const DSPBlockFactoryEntry &entry) {
+        static std::mutex mutex;
+        static std::map<uint32_t, std::vector<DSPParamDescriptor>> descriptors;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = descriptors.find(entry.type_id);
+        if (it == descriptors.end()) {
+            std::unique_ptr<NoteNagaDSPBlockBase> block(entry.create());
+            it = descriptors.emplace(entry.type_id, block->getParamDescriptors()).first;
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief Find the entry a block was created by (matched by its block name).
+     * @return Entry or nullptr for blocks not created by the factory.
+     */
+    static const DSPBlockFactoryEntry *findByBlock(const NoteNagaDSPBlockBase *block) {
+        if (!block) return nullptr;
+        const std::string block_name = block->getBlockName();
+        for (const auto &entry : allBlocks()) {
+            if ((entry.block_name.empty() ? entry.name : entry.block_name) == block_name) return &entry;
+        }
+        return nullptr;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+#include <note_naga_engine/core/dsp_block_base.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One block of a DSP chain preset.
+ */
+struct NOTE_NAGA_ENGINE_API DSPChainPresetBlock {
+    uint32_t type_id = 0;      ///< Type id of the factory entry (see DSPBlockFactoryEntry)
+    bool active = true;        ///< Activation state of the block
+    std::vector<float> params; ///< Values of getParamValue() in descriptor order
+};
+
+/**
+ * @brief DSP chain preset: factory type ids and parameter values of the blocks of a
+ * chain (master, synth or aux bus), saved as compact binary or readable text.
+ *
+ * Binary format (little endian): "NNCP", u16 version, u16 name length, name bytes,
+ * u16 block count, then per block u16 type id, u8 flags (bit 0 = active), u8 param
+ * count and the float32 parameter values. Text format is an INI-like listing with one
+ * section per block named after its factory entry and parameters by descriptor name.
+ *
+ * Presets store parameters only, state outside of parameters (e.g. an impulse response
+ * loaded from a file) is not saved. Parameters missing in a preset (saved by an older
+ * version) keep their defaults. Blocks are created with createBlocks() on the calling
+ * thread and can be published with one NoteNagaDSPEngine::setDSPBlocks() call.
+ *
+ * @example How to use:
+ *
+ * DSPChainPreset preset = DSPChainPreset::fromBlocks(dsp_engine->getDSPBlocks());
+ * preset.save("vocal.nnchain");
+ *
+ * if (preset.load("vocal.nnchain")) dsp_engine->setDSPBlocks(preset.createBlocks());
+ */
+class NOTE_NAGA_ENGINE_API DSPChainPreset {
+public:
+    /**
+     * @brief Constructs a new, empty preset.
+     */
+    DSPChainPreset() = default;
+
+    /**
+     * @brief Captures type ids, activation and parameter values of a chain. Blocks not
+     * created by DSPBlockFactory are skipped.
+     * @param blocks Blocks of the chain in processing order.
+     * @return Preset of the chain.
+     */
+    static DSPChainPreset fromBlocks(const std::vector<NoteNagaDSPBlockBase *> &blocks);
+
+    /**
+     * @brief Creates new blocks with the parameters of the preset. Blocks of unknown
+     * type ids are skipped. The caller owns the blocks.
+     * @return Blocks in chain order.
+     */
+    std::vector<NoteNagaDSPBlockBase *> createBlocks() const;
+
+    /**
+     * @brief Saves the preset to a file.
+     * @param filename Path to the file.
+     * @param binary True for the binary format, false for the text format.
+     * @return True if saving was successful, false otherwise.
+     */
+    bool save(const std::string &filename, bool binary = true) const;
+
+    /**
+     * @brief Loads a preset from a file in binary or text format (detected by content).
+     * @param filename Path to the file.
+     * @return True if loading was successful, false otherwise.
+     */
+    bool load(const std::string &filename);
+
+    /**
+     * @brief Serializes the preset to the binary format.
+     */
+    std::vector<uint8_t> toBinary() const;
+
+    /**
+     * @brief Parses a preset in the binary format.
+     * @return True if the data is a valid preset, false otherwise (the preset is cleared).
+     */
+    bool fromBinary(const uint8_t *data, size_t size);
+
+    /**
+     * @brief Serializes the preset to the text format.
+     */
+    std::string toText() const;
+
+    /**
+     * @brief Parses a preset in the text format.
+     * @return True if the text is a valid preset, false otherwise (the preset is cleared).
+     */
+    bool fromText(const std::string &text);
+
+    /**
+     * @brief Clears the name and all blocks.
+     */
+    void clear();
+
+    std::string name;                       ///< Display name of the preset
+    std::vector<DSPChainPresetBlock> blocks; ///< Blocks in chain order
+};
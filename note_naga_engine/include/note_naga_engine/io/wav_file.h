@@ -0,0 +1,44 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Class for loading PCM WAV files into float buffers.
+ * Supports 8/16/24/32-bit integer PCM and 32/64-bit float data (also in
+ * WAVE_FORMAT_EXTENSIBLE container). Mono files are loaded into both channels,
+ * files with more than two channels use the first two.
+ */
+class NOTE_NAGA_ENGINE_API WavFile {
+public:
+    /**
+     * @brief Constructs a new, empty WavFile object.
+     */
+    WavFile() = default;
+
+    /**
+     * @brief Loads a WAV file from disk.
+     * @param filename Path to the WAV file.
+     * @return True if loading was successful, false otherwise.
+     */
+    bool load(const std::string &filename);
+
+    /**
+     * @brief Clears all samples.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of frames (samples per channel).
+     * @return Number of frames.
+     */
+    size_t getNumFrames() const { return left.size(); }
+
+    int sample_rate = 44100;  ///< Sample rate of the file
+    int num_channels = 0;     ///< Number of channels stored in the file
+    std::vector<float> left;  ///< Left channel samples (-1.0 to 1.0)
+    std::vector<float> right; ///< Right channel samples (-1.0 to 1.0)
+};
@@ -21,6 +21,7 @@ public:
 
     /**
      * @brief Starts the audio device (stream). Can be called multiple times.
+     * The DSP engine is prepared for the sample rate and the block size of the stream.
      * @param sampleRate The sample rate to use for the audio stream.
      * @param blockSize The block size (number of frames) for the audio stream.
      * @return True if the stream started successfully, false otherwise.
@@ -35,7 +36,9 @@ public:
 
     /**
      * @brief Mutes the audio output without stopping the stream.
-     * The audio callback will start filling the buffer with zeros.
+     * The audio callback will start filling the buffer with zeros. Returns after a
+     * callback that was already rendering has finished, so the caller may render
+     * the DSP engine itself (offline export) right away.
      */
     void mute();
 
@@ -70,6 +73,7 @@ private:
     unsigned int block_size = 512;
     bool stream_open = false;
     std::atomic<bool> is_muted{false};
+    std::atomic<bool> in_callback{false}; // set while the callback may render the engine
 
     // Callback volaný RtAudio, naplňuje výstupní buffer audio daty.
     static int audioCallback(void* outputBuffer, void*, unsigned int nFrames,
@@ -4,10 +4,16 @@
 #include <note_naga_engine/core/types.h>
 #include <note_naga_engine/core/note_naga_synthesizer.h>
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/dsp_load_meter.h>
+#include <note_naga_engine/core/dsp_thread_pool.h>
 #include <note_naga_engine/module/metronome.h>
 #include <note_naga_engine/module/spectrum_analyzer.h>
 #include <note_naga_engine/core/project_data.h>
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
 #include <vector>
 #include <mutex>
 
@@ -15,6 +21,30 @@
  * @brief NoteNagaDSPEngine is the main DSP engine for the Note Naga project.
  * It manages audio rendering, synthesizers, and the metronome.
  * It provides methods to add/remove synthesizers and render audio blocks.
+ * Each synthesizer together with its DSP chain forms an independent branch. Branches
+ * are rendered in parallel on a worker pool into their own buffers and summed in
+ * synthesizer order, so the output does not depend on thread scheduling. Synths that
+ * split their rendering (see INoteNagaSoftSynth::renderPart) get their parts rendered
+ * as separate jobs of the same pool before their branches.
+ * Aux buses are shared DSP chains (reverb, delay, ...) fed by per-synth send levels,
+ * their outputs are summed into the mix before the master DSP blocks.
+ * DSP blocks whose input has been silent for longer than their tail (see
+ * NoteNagaDSPBlockBase::getTailSeconds) sleep until sound arrives again, so chains of
+ * idle synths cost almost nothing.
+ * Latency of blocks (see NoteNagaDSPBlockBase::getLatencySamples) is compensated:
+ * channel chains of a synth, synth branches and aux bus returns are delayed to the
+ * slowest parallel path before they are summed, so they stay aligned. The resulting
+ * delay of the output is reported by getOutputLatencySamples(), the metronome (mixed
+ * after the master DSP blocks) is delayed by it as well.
+ * Compressors and gates can be keyed by the output of another synth (sidechain, see
+ * setBlockSidechain). Keying synths are rendered in an earlier wave of the parallel
+ * pass, keyed blocks read their buffers directly.
+ *
+ * The audio thread never takes a lock. Every edit (synths, blocks, order, voice
+ * budgets) builds a new immutable render graph which the audio thread picks up with
+ * one atomic load per block. The old graph is freed by the editing thread after the
+ * block that may still use it is finished, so a removed block can be deleted as soon
+ * as the remove call returns.
  */
 class NOTE_NAGA_ENGINE_API NoteNagaDSPEngine {
 public:
@@ -25,7 +55,7 @@ public:
      * @param spectrum_analyzer Pointer to the spectrum analyzer module.
      */
     NoteNagaDSPEngine(NoteNagaMetronome* metronome = nullptr, NoteNagaSpectrumAnalyzer* spectrum_analyzer = nullptr);
-    ~NoteNagaDSPEngine() = default;
+    ~NoteNagaDSPEngine();
 
     /**
      * @brief Render audio output.
@@ -102,7 +132,17 @@ public:
      * 
      * @return std::vector<NoteNagaDSPBlockBase*> List of DSP blocks.
      */
-    std::vector<NoteNagaDSPBlockBase*> getDSPBlocks() const { return dsp_blocks_; }
+    std::vector<NoteNagaDSPBlockBase*> getDSPBlocks() const;
+
+    /**
+     * @brief Replace the whole master chain at once (e.g. when a preset is loaded). New
+     * blocks are prepared on the calling thread and the chain is published in one render
+     * graph, so the audio thread never sees a partial chain. Blocks that are not in the
+     * new chain are removed but not deleted, the caller can delete them after the call.
+     * 
+     * @param blocks New DSP blocks in processing order.
+     */
+    void setDSPBlocks(const std::vector<NoteNagaDSPBlockBase*> &blocks);
 
     /**
      * @brief Get all DSP blocks for a specific synthesizer.
@@ -112,6 +152,170 @@ public:
      */
     std::vector<NoteNagaDSPBlockBase*> getSynthDSPBlocks(INoteNagaSoftSynth *synth) const;
 
+    /**
+     * @brief Replace the whole chain of a synthesizer at once (see setDSPBlocks).
+     * 
+     * @param synth Pointer to the synthesizer.
+     * @param blocks New DSP blocks in processing order.
+     */
+    void setSynthDSPBlocks(INoteNagaSoftSynth *synth, const std::vector<NoteNagaDSPBlockBase*> &blocks);
+
+    /**
+     * @brief Add a DSP block to one MIDI channel of a multi-output synthesizer.
+     * Channel chains are processed only when the synthesizer reports more than one
+     * audio output (see INoteNagaSoftSynth::getAudioOutputCount), each channel output
+     * passes its own chain before the channels are summed into the synth chain.
+     * 
+     * @param synth Pointer to the synthesizer.
+     * @param channel MIDI channel (0 - 15).
+     * @param block Pointer to the DSP block to add.
+     */
+    void addSynthChannelDSPBlock(INoteNagaSoftSynth *synth, int channel, NoteNagaDSPBlockBase *block);
+
+    /**
+     * @brief Remove a DSP block from one MIDI channel of a synthesizer.
+     * 
+     * @param synth Pointer to the synthesizer.
+     * @param channel MIDI channel (0 - 15).
+     * @param block Pointer to the DSP block to remove.
+     */
+    void removeSynthChannelDSPBlock(INoteNagaSoftSynth *synth, int channel, NoteNagaDSPBlockBase *block);
+
+    /**
+     * @brief Reorder a DSP block in one MIDI channel of a synthesizer.
+     * 
+     * @param synth Pointer to the synthesizer.
+     * @param channel MIDI channel (0 - 15).
+     * @param from_idx Index of the DSP block to move.
+     * @param to_idx New index for the DSP block.
+     */
+    void reorderSynthChannelDSPBlock(INoteNagaSoftSynth *synth, int channel, int from_idx, int to_idx);
+
+    /**
+     * @brief Get all DSP blocks of one MIDI channel of a synthesizer.
+     * 
+     * @param synth Pointer to the synthesizer.
+     * @param channel MIDI channel (0 - 15).
+     * @return std::vector<NoteNagaDSPBlockBase*> List of DSP blocks.
+     */
+    std::vector<NoteNagaDSPBlockBase*> getSynthChannelDSPBlocks(INoteNagaSoftSynth *synth, int channel) const;
+
+    /**
+     * @brief Add an aux bus (shared effect chain fed by synth sends).
+     * 
+     * @param name Display name of the bus.
+     * @return int Index of the new bus.
+     */
+    int addAuxBus(const std::string &name);
+
+    /**
+     * @brief Remove an aux bus and all sends to it. Indices of the following buses
+     * move down by one. Blocks of the bus are not deleted.
+     * 
+     * @param bus Index of the bus.
+     */
+    void removeAuxBus(int bus);
+
+    /**
+     * @brief Get the number of aux buses.
+     * 
+     * @return int Number of buses.
+     */
+    int getAuxBusCount() const;
+
+    /**
+     * @brief Get the display name of an aux bus.
+     * 
+     * @param bus Index of the bus.
+     * @return std::string Name of the bus (empty for an invalid index).
+     */
+    std::string getAuxBusName(int bus) const;
+
+    /**
+     * @brief Add a DSP block to an aux bus.
+     * 
+     * @param bus Index of the bus.
+     * @param block Pointer to the DSP block to add.
+     */
+    void addAuxBusDSPBlock(int bus, NoteNagaDSPBlockBase *block);
+
+    /**
+     * @brief Remove a DSP block from an aux bus.
+     * 
+     * @param bus Index of the bus.
+     * @param block Pointer to the DSP block to remove.
+     */
+    void removeAuxBusDSPBlock(int bus, NoteNagaDSPBlockBase *block);
+
+    /**
+     * @brief Reorder a DSP block in an aux bus.
+     * 
+     * @param bus Index of the bus.
+     * @param from_idx Index of the DSP block to move.
+     * @param to_idx New index for the DSP block.
+     */
+    void reorderAuxBusDSPBlock(int bus, int from_idx, int to_idx);
+
+    /**
+     * @brief Get all DSP blocks of an aux bus.
+     * 
+     * @param bus Index of the bus.
+     * @return std::vector<NoteNagaDSPBlockBase*> List of DSP blocks.
+     */
+    std::vector<NoteNagaDSPBlockBase*> getAuxBusDSPBlocks(int bus) const;
+
+    /**
+     * @brief Replace the whole chain of an aux bus at once (see setDSPBlocks).
+     * 
+     * @param bus Index of the bus.
+     * @param blocks New DSP blocks in processing order.
+     */
+    void setAuxBusDSPBlocks(int bus, const std::vector<NoteNagaDSPBlockBase*> &blocks);
+
+    /**
+     * @brief Set the level a synthesizer sends to an aux bus. The send is taken after
+     * the synth DSP chain, the dry synth output is not changed. Level changes are
+     * applied by the audio thread with a short ramp and do not rebuild the render graph.
+     * 
+     * @param synth Pointer to the synthesizer.
+     * @param bus Index of the bus.
+     * @param level Send level (0.0 to 1.0).
+     */
+    void setSynthAuxSend(INoteNagaSoftSynth *synth, int bus, float level);
+
+    /**
+     * @brief Get the level a synthesizer sends to an aux bus.
+     * 
+     * @param synth Pointer to the synthesizer.
+     * @param bus Index of the bus.
+     * @return float Send level (0.0 to 1.0).
+     */
+    float getSynthAuxSend(INoteNagaSoftSynth *synth, int bus) const;
+
+    /**
+     * @brief Key a DSP block off the output of a synthesizer (sidechain), e.g. duck the
+     * bass with the kick. Only blocks that support it (see
+     * NoteNagaDSPBlockBase::supportsSidechain) can be keyed. The key is the source synth
+     * output after its DSP chain from the same render block, read without a copy: synths
+     * are rendered in waves so that every source is finished before the synths keyed by
+     * it. A block can be in any chain, but a synth cannot key a block of its own chains,
+     * directly or through other sidechains. The routing is dropped when the block is
+     * removed from the engine or the source synth is removed.
+     * 
+     * @param block Pointer to the DSP block.
+     * @param source Synthesizer whose output keys the block, nullptr removes the sidechain.
+     * @return True if the sidechain was set, false for unsupported blocks and routing loops.
+     */
+    bool setBlockSidechain(NoteNagaDSPBlockBase *block, INoteNagaSoftSynth *source);
+
+    /**
+     * @brief Get the synthesizer that keys a DSP block.
+     * 
+     * @param block Pointer to the DSP block.
+     * @return INoteNagaSoftSynth* Source synthesizer, nullptr without sidechain.
+     */
+    INoteNagaSoftSynth *getBlockSidechain(const NoteNagaDSPBlockBase *block) const;
+
     /**
      * @brief Enable or disable DSP processing.
      * 
@@ -124,14 +328,14 @@ public:
      * 
      * @return True if DSP is enabled, false otherwise.
      */
-    bool isDSPEnabled() const { return enable_dsp_; }
+    bool isDSPEnabled() const { return enable_dsp_.load(std::memory_order_relaxed); }
 
     /**
      * @brief Get all synthesizers managed by this DSP engine.
      * 
      * @return std::vector<INoteNagaSoftSynth*> List of synthesizers.
      */
-    std::vector<INoteNagaSoftSynth*> getAllSynths() const { return synths_; }
+    std::vector<INoteNagaSoftSynth*> getAllSynths() const;
 
     /**
      * @brief Set the output volume.
@@ -145,7 +349,7 @@ public:
      * 
      * @return float Current output volume (0.0 to 1.0).
      */
-    float getOutputVolume() const { return output_volume_; }
+    float getOutputVolume() const { return output_volume_.load(std::memory_order_relaxed); }
 
     /**
      * @brief Get the current volume in dB.
@@ -154,26 +358,388 @@ public:
      */
     std::pair<float, float> getCurrentVolumeDb() const;
 
+    /**
+     * @brief Get the number of worker threads used for parallel synth rendering.
+     * 
+     * @return size_t Number of workers (the audio thread itself is not counted).
+     */
+    size_t getRenderWorkerCount() const { return thread_pool_ ? thread_pool_->getWorkerCount() : 0; }
+
+    /**
+     * @brief Prepare for rendering in the given format. Prepares all DSP blocks (see
+     * NoteNagaDSPBlockBase::prepare) and sets the sample rate of the metronome and, when
+     * the rate changed, of all synthesizers. Blocks and synths added later are prepared when they are added.
+     * A render running meanwhile is waited for, renders started meanwhile output silence.
+     * 
+     * @param sample_rate Sample rate in Hz.
+     * @param max_block_frames Largest number of frames of one render call, longer renders
+     * are split into blocks of this size (at most the size of the internal buffers).
+     */
+    void prepare(int sample_rate, size_t max_block_frames);
+
+    /**
+     * @brief Set the sample rate of the rendered audio, same as
+     * prepare(sample_rate, getMaxBlockFrames()).
+     * 
+     * @param sample_rate Sample rate in Hz.
+     */
+    void setSampleRate(int sample_rate);
+
+    /**
+     * @brief Get the sample rate of the rendered audio.
+     * 
+     * @return int Sample rate in Hz.
+     */
+    int getSampleRate() const { return sample_rate_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the largest block size DSP blocks are prepared for.
+     * 
+     * @return size_t Number of frames.
+     */
+    size_t getMaxBlockFrames() const { return max_block_frames_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Set the voice budget of a synthesizer.
+     * 
+     * @param synth Pointer to the synthesizer.
+     * @param max_voices Maximum number of voices (0 = default budget).
+     */
+    void setSynthVoiceLimit(INoteNagaSoftSynth *synth, size_t max_voices);
+
+    /**
+     * @brief Get the configured voice budget of a synthesizer.
+     * 
+     * @param synth Pointer to the synthesizer.
+     * @return size_t Maximum number of voices (0 = default budget).
+     */
+    size_t getSynthVoiceLimit(INoteNagaSoftSynth *synth) const;
+
+    /**
+     * @brief Set the voice budget shared by all synthesizers. When the sum of synth
+     * budgets exceeds it, all synth budgets are scaled down proportionally.
+     * 
+     * @param max_voices Maximum number of voices of all synths (0 = unlimited).
+     */
+    void setGlobalVoiceLimit(size_t max_voices);
+
+    /**
+     * @brief Get the voice budget shared by all synthesizers.
+     * 
+     * @return size_t Maximum number of voices (0 = unlimited).
+     */
+    size_t getGlobalVoiceLimit() const { return global_voice_limit_; }
+
+    /**
+     * @brief Set the policy used by synthesizers to steal voices.
+     * 
+     * @param policy Steal policy.
+     */
+    void setVoiceStealPolicy(NN_VoiceStealPolicy_t policy);
+
+    /**
+     * @brief Get the policy used by synthesizers to steal voices.
+     * 
+     * @return NN_VoiceStealPolicy_t Steal policy.
+     */
+    NN_VoiceStealPolicy_t getVoiceStealPolicy() const { return voice_steal_policy_; }
+
+    /**
+     * @brief Enable or disable the load guard. The guard measures render time of every
+     * block and lowers polyphony of all synths when the audio callback gets close to
+     * its deadline, then slowly restores it when load drops.
+     * 
+     * @param enable True to enable the guard.
+     */
+    void setVoiceGuardEnabled(bool enable);
+
+    /**
+     * @brief Check if the load guard is enabled.
+     * 
+     * @return True if the guard is enabled.
+     */
+    bool isVoiceGuardEnabled() const { return voice_guard_enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the polyphony scale currently applied by the load guard.
+     * 
+     * @return float Scale of all voice budgets (0.0 to 1.0).
+     */
+    float getVoiceGuardScale() const { return voice_guard_scale_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the load of the last rendered block (render time / block duration).
+     * 
+     * @return float Render load (1.0 = deadline reached).
+     */
+    float getRenderLoad() const { return render_load_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the delay of the output caused by latent DSP blocks (lookahead,
+     * oversampling) after compensation: the slowest synth branch plus the slowest aux
+     * bus plus the master chain. The playback cursor and offline export offset by it.
+     * 
+     * @return size_t Latency in samples at the current sample rate.
+     */
+    size_t getOutputLatencySamples() const;
+
+    /**
+     * @brief Get the output latency in seconds (see getOutputLatencySamples).
+     * 
+     * @return double Latency in seconds.
+     */
+    double getOutputLatencySeconds() const;
+
+    /**
+     * @brief Enable or disable CPU profiling. When enabled, every renderAudio call of a
+     * synthesizer and every process call of a DSP block is timed and its load is kept in
+     * lock-free rolling statistics.
+     * 
+     * @param enable True to enable profiling.
+     */
+    void setProfilingEnabled(bool enable);
+
+    /**
+     * @brief Check if CPU profiling is enabled.
+     * 
+     * @return True if profiling is enabled.
+     */
+    bool isProfilingEnabled() const { return profiling_enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the CPU load of a DSP block (any chain).
+     * 
+     * @param block Pointer to the DSP block.
+     * @return NN_DSPLoad_t Average and peak load relative to real time.
+     */
+    NN_DSPLoad_t getBlockLoad(const NoteNagaDSPBlockBase *block) const;
+
+    /**
+     * @brief Get the CPU load of a synthesizer (audio rendering only, without its DSP chain).
+     * 
+     * @param synth Pointer to the synthesizer.
+     * @return NN_DSPLoad_t Average and peak load relative to real time.
+     */
+    NN_DSPLoad_t getSynthLoad(INoteNagaSoftSynth *synth) const;
+
+    /**
+     * @brief Get voice statistics (active voices, limit, stolen and dropped counters)
+     * of a synthesizer.
+     * 
+     * @param synth Pointer to the synthesizer.
+     * @return NN_SynthVoiceStats_t Voice statistics.
+     */
+    NN_SynthVoiceStats_t getSynthVoiceStats(INoteNagaSoftSynth *synth) const;
+
+    /**
+     * @brief Get voice statistics summed over all synthesizers.
+     * 
+     * @return NN_SynthVoiceStats_t Voice statistics.
+     */
+    NN_SynthVoiceStats_t getTotalVoiceStats() const;
+
 private:
-    std::mutex dsp_engine_mutex_;
+    /**
+     * @brief Send level of one synth to one aux bus. Owned by the edit model and
+     * referenced by render graphs, level is written by any thread, applied only by
+     * the audio thread.
+     */
+    struct AuxSend {
+        std::atomic<float> level{0.0f};
+        float applied = 0.0f;
+    };
+
+    /**
+     * @brief Aux bus of the edit model.
+     */
+    struct AuxBus {
+        std::string name;
+        std::vector<NoteNagaDSPBlockBase*> blocks;
+        uint64_t id = 0; // identity across index shifts (see publishRenderGraph)
+    };
+
+    /**
+     * @brief Delay that aligns a path with the slowest parallel path (audio thread only).
+     * The ring always holds the latest input, a changed delay only moves the read tap.
+     * Graphs share the delay of a path that survives a publish (see carryCompensation),
+     * so edits do not cut gaps into the delayed audio.
+     */
+    struct CompensationDelay {
+        std::vector<float> left;
+        std::vector<float> right;
+        size_t pos = 0;
+    };
+
+    /**
+     * @brief Render branch of one synthesizer with its own preallocated buffers.
+     */
+    struct RenderBranch {
+        INoteNagaSoftSynth *synth = nullptr;
+        std::vector<NoteNagaDSPBlockBase*> blocks;
+        // Chains of MIDI channels, empty or one chain per synth output
+        std::vector<std::vector<NoteNagaDSPBlockBase*>> channel_blocks;
+
+        // Sidechain sources of the blocks (see resolveSidechains), empty without keyed blocks
+        std::vector<const RenderBranch*> sidechains;
+        std::vector<std::vector<const RenderBranch*>> channel_sidechains;
+
+        // Sends indexed by aux bus, nullptr for buses without send
+        std::vector<AuxSend*> aux_sends;
+
+        // Load of the synth rendering, owned by the edit model
+        NoteNagaDSPLoadMeter *load_meter = nullptr;
+
+        size_t voice_budget = 0;        // budget including the share of the global limit
+        size_t applied_voice_limit = 0; // limit currently set on the synth (audio thread)
+
+        std::vector<float> left;
+        std::vector<float> right;
+
+        // Per-channel outputs, allocated only when the synth has channel chains
+        std::vector<std::vector<float>> out_left;
+        std::vector<std::vector<float>> out_right;
+        std::vector<float*> out_left_ptrs;
+        std::vector<float*> out_right_ptrs;
+
+        // Latency compensation of the channel chains and of the whole branch
+        std::vector<std::shared_ptr<CompensationDelay>> channel_compensation;
+        std::shared_ptr<CompensationDelay> compensation;
+        size_t compensation_frames = 0; // delay of this block, set before the branch is rendered
+
+        // Parts of the synth pre-rendered in this block (range of RenderGraph::parts)
+        size_t first_part = 0;
+        size_t num_parts = 0;
+    };
+
+    /**
+     * @brief One pre-rendered part of a synth (audio thread scratch).
+     */
+    struct RenderPart {
+        size_t branch = 0;
+        size_t part = 0;
+        double seconds = 0.0; // render time (profiling)
+    };
+
+    /**
+     * @brief Immutable snapshot of everything the audio thread renders. It is built
+     * on the editing thread and published with a single atomic pointer swap. Only
+     * scratch buffers and applied voice limits are touched by the audio thread.
+     */
+    struct RenderAuxBus {
+        uint64_t id = 0; // AuxBus::id
+        std::vector<NoteNagaDSPBlockBase*> blocks;
+        std::vector<const RenderBranch*> sidechains;
+        std::vector<float> left;
+        std::vector<float> right;
+        std::shared_ptr<CompensationDelay> compensation;
+        size_t compensation_frames = 0;
+    };
+
+    struct RenderGraph {
+        std::vector<RenderBranch> branches; // in synth order
+        std::vector<RenderAuxBus> aux_buses;
+        std::vector<NoteNagaDSPBlockBase*> master_blocks;
+        std::vector<const RenderBranch*> master_sidechains;
+        std::vector<std::vector<size_t>> waves; // branch indices per wave, sidechain sources first
+        std::vector<RenderPart> parts;          // parts of the current wave, capacity reserved
+        std::shared_ptr<CompensationDelay> dry_compensation; // dry mix aligned with the aux bus returns
+    };
+
+    // Edit model, guarded by dsp_engine_mutex_ (never locked by the audio thread)
+    mutable std::mutex dsp_engine_mutex_;
     std::vector<INoteNagaSoftSynth*> synths_;
     std::vector<NoteNagaDSPBlockBase*> dsp_blocks_;
     
     // Mapping from synth to its DSP blocks
     std::map<INoteNagaSoftSynth*, std::vector<NoteNagaDSPBlockBase*>> synth_dsp_blocks_;
+
+    // Mapping from synth to DSP blocks of its MIDI channels (multi-output synths)
+    std::map<INoteNagaSoftSynth*, std::map<int, std::vector<NoteNagaDSPBlockBase*>>> synth_channel_dsp_blocks_;
+
+    // Mapping from synth to its configured voice budget
+    std::map<INoteNagaSoftSynth*, size_t> synth_voice_limits_;
+    size_t global_voice_limit_ = 0;
+    NN_VoiceStealPolicy_t voice_steal_policy_ = NN_VoiceStealPolicy_t::Quietest;
+
+    // Load meters of synths
+    std::map<INoteNagaSoftSynth*, std::unique_ptr<NoteNagaDSPLoadMeter>> synth_load_meters_;
+
+    // Aux buses and send levels of synths (bus index -> send)
+    std::vector<AuxBus> aux_buses_;
+    uint64_t next_aux_bus_id_ = 1;
+    std::map<INoteNagaSoftSynth*, std::map<int, std::unique_ptr<AuxSend>>> synth_aux_sends_;
+
+    // Sidechain routing (keyed block -> source synth)
+    std::map<const NoteNagaDSPBlockBase*, INoteNagaSoftSynth*> block_sidechains_;
+
+    // Published render graph and render sequence (odd while a block is rendered)
+    std::atomic<RenderGraph*> render_graph_{nullptr};
+    std::atomic<uint64_t> render_seq_{0};
+    std::atomic<bool> render_busy_{false};
     
+    // Audio thread scratch
+    RenderGraph *current_graph_ = nullptr; // graph of the block currently being rendered
+    const std::vector<size_t> *current_wave_ = nullptr; // branches of the wave being rendered
+    size_t render_num_frames_ = 0;         // frames of the block currently being rendered
+    double render_load_scale_ = 0.0;       // seconds to load of the current block (profiling)
     std::vector<float> mix_left_;
     std::vector<float> mix_right_;
-    std::vector<float> temp_left_;
-    std::vector<float> temp_right_;
+    std::vector<float> metronome_left_;
+    std::vector<float> metronome_right_;
+    std::shared_ptr<CompensationDelay> metronome_compensation_; // clicks aligned with the output latency
     
-    float output_volume_ = 1.0f;
-    float last_rms_left_ = -100.0f;
-    float last_rms_right_ = -100.0f;
-    bool enable_dsp_ = true;
+    std::atomic<float> output_volume_{1.0f};
+    std::atomic<float> last_rms_left_{-100.0f};
+    std::atomic<float> last_rms_right_{-100.0f};
+    std::atomic<bool> enable_dsp_{true};
     
     NoteNagaMetronome* metronome_ = nullptr;
     NoteNagaSpectrumAnalyzer* spectrum_analyzer_ = nullptr;
-    
+
+    // Load guard
+    std::atomic<int> sample_rate_{44100};
+    std::atomic<size_t> max_block_frames_{0};
+    std::atomic<bool> voice_guard_enabled_{true};
+    std::atomic<float> voice_guard_scale_{1.0f};
+    std::atomic<float> render_load_{0.0f};
+    std::atomic<bool> profiling_enabled_{true};
+
+    std::unique_ptr<NoteNagaDSPThreadPool> thread_pool_;
+
+    void renderBlock(float *output, size_t num_frames, bool compute_rms);
+    static void renderBranchJob(void *context, size_t branch_idx);
+    static void renderPartJob(void *context, size_t part_idx);
+    void renderParts(RenderGraph &graph, const std::vector<size_t> &wave);
+    double partSeconds(const RenderBranch &branch) const;
+    static void renderAuxBusJob(void *context, size_t bus_idx);
+    void mixAuxSends(RenderGraph &graph, size_t num_frames);
+    void renderBranch(RenderBranch &branch, size_t num_frames);
+    bool renderBranchChannels(RenderBranch &branch, size_t num_frames, bool profile);
+    void processChain(const std::vector<NoteNagaDSPBlockBase*> &blocks,
+                      const std::vector<const RenderBranch*> &sidechains, float *left, float *right,
+                      size_t num_frames, bool profile);
+    static bool isSilent(const float *left, const float *right, size_t num_frames);
+    static size_t chainLatency(const std::vector<NoteNagaDSPBlockBase*> &blocks);
+    static size_t branchLatency(const RenderBranch &branch, bool dsp);
+    static std::shared_ptr<CompensationDelay> carryCompensation(const std::shared_ptr<CompensationDelay> &previous);
+    static void applyCompensation(CompensationDelay &compensation, float *left, float *right,
+                                  size_t num_frames, size_t delay);
+    void prepareBlock(NoteNagaDSPBlockBase *block);
+    bool buildRenderWaves(std::vector<std::vector<size_t>> &waves, std::vector<size_t> &branch_waves) const;
+    std::vector<const RenderBranch*> resolveSidechains(const std::vector<NoteNagaDSPBlockBase*> &blocks,
+                                                       const RenderGraph &graph,
+                                                       const std::vector<size_t> &branch_waves,
+                                                       size_t wave) const;
+    void eraseSidechains(const std::vector<NoteNagaDSPBlockBase*> &blocks);
+    void replaceChain(std::vector<NoteNagaDSPBlockBase*> &chain, const std::vector<NoteNagaDSPBlockBase*> &blocks);
+    void applyVoiceLimits(RenderGraph &graph);
+    void updateVoiceGuard(float load);
     void calculateRMS(float *left, float *right, size_t numFrames);
+
+    /**
+     * @brief Build a new render graph from the edit model, publish it and free the
+     * previous one once the audio thread can no longer use it. Must be called with
+     * dsp_engine_mutex_ held, never from the audio thread.
+     */
+    void publishRenderGraph();
 };
\ No newline at end of file
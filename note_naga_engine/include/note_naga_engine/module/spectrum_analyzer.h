@@ -5,6 +5,7 @@
 #endif
 
 #include <note_naga_engine/core/async_queue_component.h>
+#include <note_naga_engine/core/dsp_fft.h>
 #include <note_naga_engine/core/types.h>
 #include <note_naga_engine/note_naga_api.h>
 
@@ -23,7 +24,7 @@ class NOTE_NAGA_ENGINE_API NoteNagaSpectrumAnalyzer
     Q_OBJECT
 #else
 class NOTE_NAGA_ENGINE_API NoteNagaSpectrumAnalyzer
-    : public AsyncQueueComponent<NN_AsyncTriggerMessage_t> {
+    : public AsyncQueueComponent<NN_AsyncTriggerMessage_t, 16> {
 #endif
 public:
     explicit NoteNagaSpectrumAnalyzer(size_t fft_size, ChannelMode mode = ChannelMode::Merged);
@@ -91,6 +92,11 @@ private:
     mutable std::mutex spectrum_mutex_; // Mutex for thread-safe access to spectrum data
     std::vector<float> spectrum_;       // Frequency spectrum data
 
+    // FFT plan and scratch buffers, allocated once so processing a frame never allocates
+    NoteNagaFFT fft_;
+    std::vector<float> working_buffer_;
+    std::vector<float> magnitudes_;
+
     void onItem(const NN_AsyncTriggerMessage_t &message) override;
 
     void processSampleBuffer();
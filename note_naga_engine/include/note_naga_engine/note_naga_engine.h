@@ -116,6 +116,14 @@ public:
      */
     bool isPlaying() const { return playback_worker ? playback_worker->isPlaying() : false; }
 
+    /**
+     * @brief Returns the tick that is currently heard. While playing it lags the playback
+     * tick by the output latency of the DSP engine (lookahead, oversampling), use it for
+     * the playback cursor.
+     * @return Audible playback tick.
+     */
+    int getAudibleTick() const;
+
     /*******************************************************************************************************/
     // Project Control
     /*******************************************************************************************************/
@@ -195,6 +203,15 @@ public:
      */
     std::pair<float, float> getCurrentVolumeDb();
 
+    /**
+     * @brief Restarts the audio output with a new format. The DSP engine, all DSP blocks,
+     * synthesizers and the metronome are prepared for it.
+     * @param sample_rate Sample rate in Hz (e.g. 44100, 48000, 96000).
+     * @param block_size Requested block size in frames.
+     * @return True if the audio output was started.
+     */
+    bool setAudioFormat(unsigned int sample_rate, unsigned int block_size);
+
     /*******************************************************************************************************/
     // Getters for main components
     /*******************************************************************************************************/
@@ -3,8 +3,10 @@
 #include <note_naga_engine/core/note_naga_synthesizer.h>
 #include <note_naga_engine/core/types.h>
 #include <fluidsynth.h>
+#include <atomic>
 #include <mutex>
 #include <string>
+#include <vector>
 
 class DSPEngine;
 
@@ -25,6 +27,12 @@ public:
     virtual void stopNote(const NN_Note_t &note) override;
     virtual void stopAllNotes(NoteNagaMidiSeq *seq = nullptr, NoteNagaTrack *track = nullptr) override;
     virtual void renderAudio(float* left, float* right, size_t num_frames) override;
+    virtual size_t getAudioOutputCount() const override;
+    virtual void renderAudioOutputs(float **left, float **right, size_t num_outputs,
+                                    size_t num_frames) override;
+    virtual void setVoiceLimit(size_t max_voices) override;
+    virtual void setSampleRate(int sample_rate) override;
+    virtual NN_SynthVoiceStats_t getVoiceStats() const override;
 
     virtual std::string getConfig(const std::string &key) const override;
     virtual bool setConfig(const std::string &key, const std::string &value) override;
@@ -43,6 +51,21 @@ public:
      */
     bool setSoundFont(const std::string &sf2_path);
 
+    /**
+     * @brief Enable or disable per-channel outputs. In multi-output mode every MIDI
+     * channel is rendered to its own stereo output (FluidSynth audio groups), so the
+     * DSP engine can process channels with separate DSP chains. Internal FluidSynth
+     * reverb and chorus are disabled in this mode, they would be shared by all channels.
+     * @param enabled True to enable per-channel outputs
+     * @return True if the synthesizer was successfully recreated
+     */
+    bool setMultiOutput(bool enabled);
+
+    /**
+     * @brief Check if per-channel outputs are enabled
+     */
+    bool isMultiOutput() const { return multi_output_.load(); }
+
 protected:
     // Mutex for thread-safe access to the synthesizer
     std::mutex synth_mutex_;
@@ -54,5 +77,53 @@ protected:
     // Store the current SoundFont path
     std::string sf2_path_;  
 
+    // Per-channel outputs (one FluidSynth audio group per MIDI channel). Switched
+    // under synth_mutex_, read without it by getAudioOutputCount on the audio thread.
+    std::atomic<bool> multi_output_{false};
+
+    // Per-group buffers of the mixdown in multi-output mode (one block of
+    // 2 * 16 * group_frames_ samples, left / right pointers per audio group)
+    std::vector<float> group_buffer_;
+    std::vector<float *> group_left_;
+    std::vector<float *> group_right_;
+    size_t group_frames_ = 0;
+
+    // Output sample rate of the FluidSynth instance
+    int sample_rate_ = 44100;
+
+    // Voice limit (0 = FluidSynth default), FluidSynth steals voices on its own.
+    // Requested by any thread, applied under synth_mutex_ by the next render.
+    std::atomic<size_t> voice_limit_{0};
+    size_t applied_voice_limit_ = 0;
+    // Estimate: FluidSynth does not report stealing, so a note started while all voices
+    // are busy counts as one stolen voice (a layered preset may steal more, voices in
+    // release count as busy). No note is ever dropped, dropped_notes stays zero.
+    std::atomic<uint64_t> stolen_voices_{0};
+
+    // Voice counts of the last render (getVoiceStats never touches the instance)
+    std::atomic<size_t> active_voices_{0};
+    std::atomic<size_t> max_voices_{0};
+
     void ensureFluidsynth();
+
+    /**
+     * @brief (Re)create FluidSynth settings and synth for the current SoundFont and
+     * output mode. Caller must make sure no rendering is in progress.
+     * @return SoundFont id or FLUID_FAILED
+     */
+    int createFluidsynth();
+
+    /**
+     * @brief Render the mix of all channels. In multi-output mode all audio groups are
+     * rendered and summed. Caller must hold synth_mutex_.
+     */
+    void renderMixdown(float *left, float *right, size_t num_frames);
+
+    /**
+     * @brief Apply a changed voice limit / publish voice counts. Caller must hold
+     * synth_mutex_.
+     */
+    void applyVoiceLimit();
+    void updateVoiceStats();
+    void allocateGroupBuffers(size_t num_frames);
 };
\ No newline at end of file
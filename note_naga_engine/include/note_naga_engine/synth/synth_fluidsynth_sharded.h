@@ -0,0 +1,154 @@
+#pragma once
+
+#include <note_naga_engine/core/note_naga_synthesizer.h>
+#include <note_naga_engine/core/types.h>
+#include <fluidsynth.h>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief FluidSynth synthesizer that spreads MIDI channels across several internal
+ * FluidSynth instances (shards). Shards are rendered in parallel and summed, so dense
+ * polyphony scales with CPU cores. For the mixer it behaves like one synthesizer.
+ *
+ * The DSP engine renders the shards as separate jobs of its worker pool (see
+ * renderPart), standalone renderAudio() renders them one after another.
+ * MIDI channel N is played by shard (N % shard count). Every shard loads its own copy
+ * of the SoundFont, so memory usage grows with the number of shards. The voice limit
+ * is shared: a shard may use all voices the other shards leave free. A note whose
+ * shard has no voice left because the other shards use the whole limit is dropped.
+ */
+class NoteNagaSynthFluidSynthSharded : public NoteNagaSynthesizer, public INoteNagaSoftSynth {
+public:
+    /**
+     * @brief Constructor of the sharded FluidSynth synthesizer
+     * @param name Name of the synthesizer
+     * @param sf2_path Path to the SoundFont file (.sf2 or .sf3)
+     * @param num_shards Number of FluidSynth instances, zero means "by CPU core count"
+     */
+    NoteNagaSynthFluidSynthSharded(const std::string &name, const std::string &sf2_path,
+                                   size_t num_shards = 0);
+    ~NoteNagaSynthFluidSynthSharded() override;
+
+    virtual void playNote(const NN_Note_t &note, int channel = 0, float pan = 0.0) override;
+    virtual void stopNote(const NN_Note_t &note) override;
+    virtual void stopAllNotes(NoteNagaMidiSeq *seq = nullptr, NoteNagaTrack *track = nullptr) override;
+    virtual void renderAudio(float* left, float* right, size_t num_frames) override;
+    virtual size_t getRenderPartCount() const override;
+    virtual void renderPart(size_t part, size_t num_frames) override;
+    virtual void setVoiceLimit(size_t max_voices) override;
+    virtual void setSampleRate(int sample_rate) override;
+    virtual NN_SynthVoiceStats_t getVoiceStats() const override;
+
+    virtual std::string getConfig(const std::string &key) const override;
+    virtual bool setConfig(const std::string &key, const std::string &value) override;
+    virtual std::vector<std::string> getSupportedConfigKeys() const override;
+
+    /**
+     * @brief Get the current SoundFont path
+     * @return The path to the currently loaded SoundFont file
+     */
+    std::string getSoundFontPath() const { return sf2_path_; }
+
+    /**
+     * @brief Change the SoundFont file at runtime (reloaded in all shards)
+     * @param sf2_path Path to the new SoundFont file
+     * @return True if the SoundFont was successfully loaded
+     */
+    bool setSoundFont(const std::string &sf2_path);
+
+    /**
+     * @brief Change the number of shards at runtime. All playing notes are stopped.
+     * @param num_shards Number of FluidSynth instances (1 - 16), zero means "by CPU core count"
+     * @return True if all shards were successfully recreated
+     */
+    bool setShardCount(size_t num_shards);
+
+    /**
+     * @brief Get the number of shards
+     */
+    size_t getShardCount() const { return shard_count_.load(); }
+
+protected:
+    /**
+     * @brief One FluidSynth instance with its own render buffers.
+     */
+    struct FluidShard {
+        fluid_settings_t *settings = nullptr;
+        fluid_synth_t *synth = nullptr;
+        std::vector<float> left;
+        std::vector<float> right;
+        size_t rendered_frames = 0; // frames pre-rendered by renderPart() for the next mix
+    };
+
+    // Shared for rendering (parts run in parallel) and note events, exclusive to
+    // recreate the shards
+    mutable std::shared_mutex synth_mutex_;
+
+    // Note events of different threads (playing_notes_, channel programs / pans),
+    // taken after a shared synth_mutex_. Not needed under an exclusive synth_mutex_.
+    std::mutex notes_mutex_;
+
+    std::vector<FluidShard> shards_;
+    std::atomic<size_t> shard_count_{0}; // shards_.size() readable without the lock
+
+    // Store the current SoundFont path
+    std::string sf2_path_;
+
+    // Output sample rate of all shards
+    int sample_rate_ = 44100;
+
+    // Voice limit of the whole synth (0 = FluidSynth default), shared by all shards.
+    // Requested by any thread, applied under synth_mutex_ by the next render.
+    std::atomic<size_t> voice_limit_{0};
+    size_t applied_voice_limit_ = 0;
+    // Estimate: FluidSynth does not report stealing, so a note started while all voices
+    // of its shard are busy counts as one stolen voice (a layered preset may steal more,
+    // voices in release count as busy)
+    std::atomic<uint64_t> stolen_voices_{0};
+    std::atomic<uint64_t> dropped_notes_{0};
+
+    // Voice counts of the last render (getVoiceStats never touches the shards)
+    std::atomic<size_t> active_voices_{0};
+    std::atomic<size_t> max_voices_{0};
+
+    /**
+     * @brief Apply the voice limit to all shards / publish voice counts. Caller must
+     * hold synth_mutex_.
+     */
+    void applyVoiceLimit();
+    void updateVoiceStats();
+
+    /**
+     * @brief Limit the polyphony of a shard to the voices left by the other shards,
+     * called before a note starts on it. Caller must hold synth_mutex_.
+     * @return False when the other shards use the whole voice limit (note is dropped)
+     */
+    bool balanceVoices(fluid_synth_t *synth);
+
+    /**
+     * @brief Stop notes like stopAllNotes(). Caller must hold synth_mutex_ exclusively,
+     * or shared together with notes_mutex_.
+     */
+    void stopAllNotesLocked(NoteNagaMidiSeq *seq, NoteNagaTrack *track);
+
+    /**
+     * @brief Get the FluidSynth instance that plays the given MIDI channel. Caller
+     * must hold synth_mutex_.
+     */
+    fluid_synth_t *shardForChannel(int channel) const {
+        return shards_[size_t(channel) % shards_.size()].synth;
+    }
+
+    /**
+     * @brief (Re)create all shards. Caller must hold synth_mutex_ exclusively.
+     * @return True if the SoundFont was loaded in all shards
+     */
+    bool createShards(size_t num_shards);
+    void destroyShards();
+
+    static void renderShard(FluidShard &shard, size_t num_frames);
+};
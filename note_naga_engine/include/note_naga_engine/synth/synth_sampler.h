@@ -0,0 +1,215 @@
+#pragma once
+
+#include <note_naga_engine/core/note_naga_synthesizer.h>
+#include <note_naga_engine/core/lock_free_mpmc_queue.h>
+#include <note_naga_engine/core/types.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Interpolation used by the sampler when a zone is played at different pitch.
+ */
+enum class NOTE_NAGA_ENGINE_API NN_SamplerInterpolation_t {
+    Linear, ///< 2-point linear interpolation
+    Cubic   ///< 4-point Catmull-Rom interpolation
+};
+
+/**
+ * @brief One sample zone of the sampler (PCM data mapped to key / velocity range).
+ */
+struct NOTE_NAGA_ENGINE_API NN_SamplerZone_t {
+    std::vector<float> left;  ///< Left channel samples
+    std::vector<float> right; ///< Right channel samples (same as left for mono samples)
+    int sample_rate = 44100;  ///< Sample rate of the PCM data
+    int root_key = 60;        ///< MIDI note played at original pitch
+    int low_key = 0;          ///< Lowest MIDI note of the zone
+    int high_key = 127;       ///< Highest MIDI note of the zone
+    int low_velocity = 0;     ///< Lowest velocity of the zone
+    int high_velocity = 127;  ///< Highest velocity of the zone
+    bool loop = false;        ///< Loop between loop_start and loop_end while the note is held
+    size_t loop_start = 0;    ///< First frame of the loop
+    size_t loop_end = 0;      ///< Frame after the last frame of the loop (0 = end of sample)
+    float gain = 1.0f;        ///< Linear gain of the zone
+};
+
+/**
+ * @brief Lightweight built-in sample playback synthesizer.
+ *
+ * Plays preloaded PCM zones with linear or cubic interpolation and a linear ADSR
+ * envelope. Active voices are kept packed and rendered in batches of 4 voices with
+ * SIMD instructions (SSE2 / NEON, scalar fallback). Rendering never allocates, note
+ * events are passed to the audio thread through a lock-free queue.
+ */
+class NoteNagaSynthSampler : public NoteNagaSynthesizer, public INoteNagaSoftSynth {
+public:
+    /// Maximum number of simultaneously playing voices
+    static constexpr size_t MAX_VOICES = 256;
+
+    /**
+     * @brief Constructor of the sampler
+     * @param name Name of the synthesizer
+     * @param sample_path Optional path to a WAV file mapped to all keys (root key C4)
+     */
+    NoteNagaSynthSampler(const std::string &name, const std::string &sample_path = "");
+    ~NoteNagaSynthSampler() override;
+
+    virtual void playNote(const NN_Note_t &note, int channel = 0, float pan = 0.0) override;
+    virtual void stopNote(const NN_Note_t &note) override;
+    virtual void stopAllNotes(NoteNagaMidiSeq *seq = nullptr, NoteNagaTrack *track = nullptr) override;
+    virtual void renderAudio(float* left, float* right, size_t num_frames) override;
+    virtual void setVoiceLimit(size_t max_voices) override;
+    virtual void setVoiceStealPolicy(NN_VoiceStealPolicy_t policy) override;
+    virtual NN_SynthVoiceStats_t getVoiceStats() const override;
+
+    virtual std::string getConfig(const std::string &key) const override;
+    virtual bool setConfig(const std::string &key, const std::string &value) override;
+    virtual std::vector<std::string> getSupportedConfigKeys() const override;
+
+    /**
+     * @brief Load a WAV file as a new zone
+     * @param path Path to the WAV file
+     * @param root_key MIDI note played at original pitch
+     * @param low_key Lowest MIDI note of the zone
+     * @param high_key Highest MIDI note of the zone
+     * @param loop True to loop the whole sample while the note is held
+     * @return True if the file was loaded
+     */
+    bool loadSample(const std::string &path, int root_key = 60, int low_key = 0,
+                    int high_key = 127, bool loop = false);
+
+    /**
+     * @brief Add a zone. Zones are matched in the order they were added.
+     * @param zone Zone description with PCM data
+     */
+    void addZone(const NN_SamplerZone_t &zone);
+
+    /**
+     * @brief Remove all zones (all playing voices are stopped)
+     */
+    void clearZones();
+
+    /**
+     * @brief Get the number of loaded zones
+     */
+    size_t getZoneCount() const { return zones_.size(); }
+
+    /**
+     * @brief Set the interpolation type
+     */
+    void setInterpolation(NN_SamplerInterpolation_t interpolation);
+
+    /**
+     * @brief Get the interpolation type
+     */
+    NN_SamplerInterpolation_t getInterpolation() const { return interpolation_; }
+
+    /**
+     * @brief Set the ADSR envelope applied to all voices
+     * @param attack Attack time in seconds
+     * @param decay Decay time in seconds
+     * @param sustain Sustain level (0.0 - 1.0)
+     * @param release Release time in seconds
+     */
+    void setEnvelope(float attack, float decay, float sustain, float release);
+
+    /**
+     * @brief Set the output sample rate used for pitch and envelope timing
+     */
+    void setSampleRate(int sample_rate) override;
+
+    /**
+     * @brief Get the number of currently playing voices
+     */
+    size_t getActiveVoiceCount() const { return active_voices_.load(std::memory_order_relaxed); }
+
+protected:
+    /**
+     * @brief Note event passed from the synth thread to the audio thread.
+     */
+    struct SamplerEvent {
+        enum Type { NoteOn, NoteOff, AllNotesOff } type = NoteOn;
+        NoteNagaTrack *track = nullptr;
+        unsigned long note_id = 0;
+        int key = 0;
+        int velocity = 0;
+        float pan = 0.0f;
+    };
+
+    /**
+     * @brief Zone with padded PCM data, so interpolation never reads out of bounds.
+     */
+    struct Zone {
+        NN_SamplerZone_t desc;
+        std::vector<float> left;
+        std::vector<float> right;
+        int32_t length = 0;
+        int32_t loop_start = 0;
+        int32_t loop_end = 0;
+    };
+
+    enum EnvelopeStage : uint8_t { EnvAttack, EnvDecay, EnvSustain, EnvRelease, EnvOff };
+
+    // Mutex for thread-safe access to zones
+    std::mutex synth_mutex_;
+
+    std::vector<std::unique_ptr<Zone>> zones_;
+    std::unique_ptr<LockFreeMPMCQueue<SamplerEvent, 1024>> events_;
+
+    std::string sample_path_;
+    NN_SamplerInterpolation_t interpolation_ = NN_SamplerInterpolation_t::Cubic;
+    float attack_ = 0.002f;
+    float decay_ = 0.1f;
+    float sustain_ = 1.0f;
+    float release_ = 0.1f;
+    int sample_rate_ = 44100;
+
+    // Hot voice state, structure of arrays (voices 0 .. num_active_ - 1 are playing)
+    alignas(16) int32_t voice_pos_[MAX_VOICES];
+    alignas(16) float voice_frac_[MAX_VOICES];
+    alignas(16) float voice_step_[MAX_VOICES];
+    alignas(16) float voice_env_[MAX_VOICES];
+    alignas(16) float voice_env_step_[MAX_VOICES];
+    alignas(16) float voice_gain_l_[MAX_VOICES];
+    alignas(16) float voice_gain_r_[MAX_VOICES];
+    const float *voice_data_l_[MAX_VOICES];
+    const float *voice_data_r_[MAX_VOICES];
+    int32_t voice_end_[MAX_VOICES];
+    int32_t voice_loop_len_[MAX_VOICES];
+
+    // Cold voice state
+    float voice_env_target_[MAX_VOICES];
+    float voice_env_slope_[MAX_VOICES];
+    int32_t voice_stage_left_[MAX_VOICES];
+    EnvelopeStage voice_stage_[MAX_VOICES];
+    bool voice_ended_[MAX_VOICES];
+    NoteNagaTrack *voice_track_[MAX_VOICES];
+    unsigned long voice_note_id_[MAX_VOICES];
+    uint64_t voice_age_[MAX_VOICES];
+
+    size_t num_active_ = 0;
+    uint64_t voice_counter_ = 0;
+
+    // Voice budget (applied by the audio thread at block start)
+    std::atomic<size_t> max_voices_{MAX_VOICES};
+    std::atomic<NN_VoiceStealPolicy_t> steal_policy_{NN_VoiceStealPolicy_t::Quietest};
+    std::atomic<size_t> active_voices_{0};
+    std::atomic<uint64_t> stolen_voices_{0};
+    std::atomic<uint64_t> dropped_notes_{0};
+
+    void processEvents();
+    void startVoice(const SamplerEvent &event);
+    void releaseVoice(size_t v);
+    void resetVoice(size_t v);
+    void moveVoice(size_t from, size_t to);
+    void freeFinishedVoices();
+    void enforceVoiceLimit(size_t max_voices);
+    size_t pickVictim() const;
+    float voiceLevel(size_t v) const;
+    void updateEnvelopes(size_t num_frames);
+    void renderVoices(float *left, float *right, size_t num_frames);
+    const Zone *findZone(int key, int velocity) const;
+};
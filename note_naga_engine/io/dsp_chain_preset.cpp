@@ -0,0 +1,301 @@
+#include <note_naga_engine/io/dsp_chain_preset.h>
+
+#include <note_naga_engine/dsp/dsp_factory.h>
+#include <note_naga_engine/logger.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <locale>
+#include <sstream>
+
+// Binary format
+static constexpr char PRESET_MAGIC[4] = {'N', 'N', 'C', 'P'};
+static constexpr uint16_t PRESET_VERSION = 1;
+static constexpr uint8_t PRESET_FLAG_ACTIVE = 0x01;
+
+// Text format
+static const char *TEXT_HEADER = "[Note Naga DSP Chain]";
+
+static void writeLE16(std::vector<uint8_t> &out, uint16_t v) {
+    out.push_back(uint8_t(v));
+    out.push_back(uint8_t(v >> 8));
+}
+
+static void writeLE32(std::vector<uint8_t> &out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(uint8_t(v >> (8 * i)));
+}
+
+static uint16_t readLE16(const uint8_t *p) { return uint16_t(p[0] | (p[1] << 8)); }
+
+static uint32_t readLE32(const uint8_t *p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) |
+           (uint32_t(p[3]) << 24);
+}
+
+static std::string trim(const std::string &s) {
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return {};
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+// Number parsing and printing independent of the C locale (set by Qt)
+static bool parseFloat(const std::string &s, float &value) {
+    std::istringstream in(s);
+    in.imbue(std::locale::classic());
+    in >> value;
+    return !in.fail();
+}
+
+void DSPChainPreset::clear() {
+    name.clear();
+    blocks.clear();
+}
+
+DSPChainPreset DSPChainPreset::fromBlocks(const std::vector<NoteNagaDSPBlockBase *> &chain) {
+    DSPChainPreset preset;
+    for (NoteNagaDSPBlockBase *block : chain) {
+        const DSPBlockFactoryEntry *entry = DSPBlockFactory::findByBlock(block);
+        if (!entry) {
+            NOTE_NAGA_LOG_WARNING("DSP block not saved to preset, unknown type: " + block->getBlockName());
+            continue;
+        }
+        DSPChainPresetBlock saved;
+        saved.type_id = entry->type_id;
+        saved.active = block->isActive();
+        size_t count = block->getParamDescriptors().size();
+        for (size_t i = 0; i < count; ++i) saved.params.push_back(block->getParamValue(i));
+        preset.blocks.push_back(std::move(saved));
+    }
+    return preset;
+}
+
+std::vector<NoteNagaDSPBlockBase *> DSPChainPreset::createBlocks() const {
+    std::vector<NoteNagaDSPBlockBase *> chain;
+    for (const DSPChainPresetBlock &saved : blocks) {
+        const DSPBlockFactoryEntry *entry = DSPBlockFactory::findById(saved.type_id);
+        if (!entry) {
+            NOTE_NAGA_LOG_WARNING("DSP block of preset skipped, unknown type id: " + std::to_string(saved.type_id));
+            continue;
+        }
+        NoteNagaDSPBlockBase *block = entry->create();
+        // Parameters added after the preset was saved keep their defaults
+        size_t count = std::min(saved.params.size(), block->getParamDescriptors().size());
+        for (size_t i = 0; i < count; ++i) block->setParamValue(i, saved.params[i]);
+        block->setActive(saved.active);
+        chain.push_back(block);
+    }
+    return chain;
+}
+
+/*******************************************************************************************************/
+// Binary format
+/*******************************************************************************************************/
+
+std::vector<uint8_t> DSPChainPreset::toBinary() const {
+    std::vector<uint8_t> out(PRESET_MAGIC, PRESET_MAGIC + 4);
+    writeLE16(out, PRESET_VERSION);
+    size_t name_size = std::min<size_t>(name.size(), UINT16_MAX);
+    writeLE16(out, uint16_t(name_size));
+    out.insert(out.end(), name.begin(), name.begin() + name_size);
+
+    size_t block_count = std::min<size_t>(blocks.size(), UINT16_MAX);
+    writeLE16(out, uint16_t(block_count));
+    for (size_t b = 0; b < block_count; ++b) {
+        const DSPChainPresetBlock &block = blocks[b];
+        size_t param_count = std::min<size_t>(block.params.size(), UINT8_MAX);
+        writeLE16(out, uint16_t(block.type_id));
+        out.push_back(block.active ? PRESET_FLAG_ACTIVE : 0);
+        out.push_back(uint8_t(param_count));
+        for (size_t i = 0; i < param_count; ++i) {
+            uint32_t bits;
+            std::memcpy(&bits, &block.params[i], 4);
+            writeLE32(out, bits);
+        }
+    }
+    return out;
+}
+
+bool DSPChainPreset::fromBinary(const uint8_t *data, size_t size) {
+    clear();
+    size_t pos = 0;
+    auto available = [&](size_t n) { return size - pos >= n; };
+
+    if (!data || !available(8) || std::memcmp(data, PRESET_MAGIC, 4) != 0) {
+        NOTE_NAGA_LOG_ERROR("Not a DSP chain preset");
+        return false;
+    }
+    uint16_t version = readLE16(data + 4);
+    if (version > PRESET_VERSION) {
+        NOTE_NAGA_LOG_ERROR("Unsupported DSP chain preset version: " + std::to_string(version));
+        return false;
+    }
+    uint16_t name_size = readLE16(data + 6);
+    pos = 8;
+    if (!available(size_t(name_size) + 2)) {
+        NOTE_NAGA_LOG_ERROR("Truncated DSP chain preset");
+        return false;
+    }
+    name.assign(reinterpret_cast<const char *>(data + pos), name_size);
+    pos += name_size;
+
+    uint16_t block_count = readLE16(data + pos);
+    pos += 2;
+    for (uint16_t b = 0; b < block_count; ++b) {
+        if (!available(4)) break;
+        DSPChainPresetBlock block;
+        block.type_id = readLE16(data + pos);
+        block.active = (data[pos + 2] & PRESET_FLAG_ACTIVE) != 0;
+        uint8_t param_count = data[pos + 3];
+        pos += 4;
+        if (!available(size_t(param_count) * 4)) break;
+        block.params.resize(param_count);
+        for (uint8_t i = 0; i < param_count; ++i, pos += 4) {
+            uint32_t bits = readLE32(data + pos);
+            std::memcpy(&block.params[i], &bits, 4);
+        }
+        blocks.push_back(std::move(block));
+    }
+    if (blocks.size() != block_count) {
+        NOTE_NAGA_LOG_ERROR("Truncated DSP chain preset");
+        clear();
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************************************/
+// Text format
+/*******************************************************************************************************/
+
+std::string DSPChainPreset::toText() const {
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out.precision(9); // float round trip
+    out << TEXT_HEADER << "\n";
+    out << "version = " << PRESET_VERSION << "\n";
+    out << "name = " << name << "\n";
+
+    for (const DSPChainPresetBlock &block : blocks) {
+        const DSPBlockFactoryEntry *entry = DSPBlockFactory::findById(block.type_id);
+        if (!entry) continue;
+        const std::vector<DSPParamDescriptor> &descriptors = DSPBlockFactory::paramDescriptors(*entry);
+
+        out << "\n[" << entry->name << "]\n";
+        out << "active = " << (block.active ? 1 : 0) << "\n";
+        for (size_t i = 0; i < block.params.size() && i < descriptors.size(); ++i) {
+            out << descriptors[i].name << " = " << block.params[i] << "\n";
+        }
+    }
+    return out.str();
+}
+
+bool DSPChainPreset::fromText(const std::string &text) {
+    clear();
+    std::istringstream in(text);
+    std::string line;
+    bool header = false;                         // header section was found
+    bool in_header = false;                      // lines belong to the header section
+    std::vector<DSPParamDescriptor> descriptors; // of the current block
+    bool skip_section = false;
+
+    while (std::getline(in, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#' || line[0] == ';') continue;
+
+        if (line.front() == '[' && line.back() == ']') {
+            std::string section = trim(line.substr(1, line.size() - 2));
+            if (!header) {
+                if (line != TEXT_HEADER) break;
+                header = in_header = true;
+                continue;
+            }
+            in_header = false;
+            const DSPBlockFactoryEntry *entry = DSPBlockFactory::findByName(section);
+            skip_section = entry == nullptr;
+            if (skip_section) {
+                NOTE_NAGA_LOG_WARNING("DSP block of preset skipped, unknown type: " + section);
+                continue;
+            }
+
+            // Parameters not listed keep their defaults
+            descriptors = DSPBlockFactory::paramDescriptors(*entry);
+            DSPChainPresetBlock block;
+            block.type_id = entry->type_id;
+            for (const DSPParamDescriptor &desc : descriptors) block.params.push_back(desc.default_value);
+            blocks.push_back(std::move(block));
+            continue;
+        }
+        if (!header) break;
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+
+        if (in_header) {
+            if (key == "name") name = value;
+            continue;
+        }
+        if (skip_section) continue;
+
+        float number;
+        if (!parseFloat(value, number)) continue;
+        DSPChainPresetBlock &block = blocks.back();
+        if (key == "active") {
+            block.active = number != 0.0f;
+            continue;
+        }
+        for (size_t i = 0; i < descriptors.size(); ++i) {
+            if (descriptors[i].name == key) {
+                block.params[i] = number;
+                break;
+            }
+        }
+    }
+
+    if (!header) {
+        NOTE_NAGA_LOG_ERROR("Not a DSP chain preset");
+        clear();
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************************************/
+// Files
+/*******************************************************************************************************/
+
+bool DSPChainPreset::save(const std::string &filename, bool binary) const {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+        NOTE_NAGA_LOG_ERROR("Failed to open DSP chain preset for writing: " + filename);
+        return false;
+    }
+    if (binary) {
+        std::vector<uint8_t> data = toBinary();
+        out.write(reinterpret_cast<const char *>(data.data()), std::streamsize(data.size()));
+    } else {
+        out << toText();
+    }
+    if (!out) {
+        NOTE_NAGA_LOG_ERROR("Failed to write DSP chain preset: " + filename);
+        return false;
+    }
+    return true;
+}
+
+bool DSPChainPreset::load(const std::string &filename) {
+    clear();
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) {
+        NOTE_NAGA_LOG_ERROR("Failed to open DSP chain preset: " + filename);
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (data.size() >= 4 && std::memcmp(data.data(), PRESET_MAGIC, 4) == 0) {
+        return fromBinary(data.data(), data.size());
+    }
+    return fromText(std::string(data.begin(), data.end()));
+}
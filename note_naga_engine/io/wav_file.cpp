@@ -0,0 +1,122 @@
+#include <note_naga_engine/io/wav_file.h>
+
+#include <note_naga_engine/logger.h>
+
+#include <cstring>
+#include <fstream>
+
+// WAV format tags
+#define WAV_FORMAT_PCM 0x0001
+#define WAV_FORMAT_IEEE_FLOAT 0x0003
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+
+static uint16_t readLE16(const uint8_t *p) { return uint16_t(p[0] | (p[1] << 8)); }
+
+static uint32_t readLE32(const uint8_t *p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) |
+           (uint32_t(p[3]) << 24);
+}
+
+static float decodeSample(const uint8_t *p, uint16_t format, uint16_t bits) {
+    if (format == WAV_FORMAT_IEEE_FLOAT) {
+        if (bits == 32) {
+            float v;
+            std::memcpy(&v, p, 4);
+            return v;
+        }
+        double v;
+        std::memcpy(&v, p, 8);
+        return float(v);
+    }
+    switch (bits) {
+    case 8:
+        return (float(p[0]) - 128.0f) / 128.0f;
+    case 16:
+        return float(int16_t(readLE16(p))) / 32768.0f;
+    case 24: {
+        int32_t v = int32_t(uint32_t(p[0]) << 8 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 24);
+        return float(v >> 8) / 8388608.0f;
+    }
+    default:
+        return float(int32_t(readLE32(p))) / 2147483648.0f;
+    }
+}
+
+void WavFile::clear() {
+    left.clear();
+    right.clear();
+    num_channels = 0;
+}
+
+bool WavFile::load(const std::string &filename) {
+    clear();
+
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) {
+        NOTE_NAGA_LOG_ERROR("Failed to open WAV file: " + filename);
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)),
+                              std::istreambuf_iterator<char>());
+
+    if (data.size() < 12 || std::memcmp(data.data(), "RIFF", 4) != 0 ||
+        std::memcmp(data.data() + 8, "WAVE", 4) != 0) {
+        NOTE_NAGA_LOG_ERROR("Not a RIFF/WAVE file: " + filename);
+        return false;
+    }
+
+    uint16_t format = 0, channels = 0, bits = 0;
+    uint32_t rate = 0;
+    const uint8_t *pcm = nullptr;
+    size_t pcm_size = 0;
+
+    // Walk through chunks
+    size_t pos = 12;
+    while (pos + 8 <= data.size()) {
+        const uint8_t *chunk = data.data() + pos;
+        uint32_t chunk_size = readLE32(chunk + 4);
+        size_t body = pos + 8;
+        size_t avail = std::min<size_t>(chunk_size, data.size() - body);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && avail >= 16) {
+            format = readLE16(chunk + 8);
+            channels = readLE16(chunk + 10);
+            rate = readLE32(chunk + 12);
+            bits = readLE16(chunk + 22);
+            // Extensible format stores real format tag in sub-format GUID
+            if (format == WAV_FORMAT_EXTENSIBLE && avail >= 26) {
+                format = readLE16(chunk + 32);
+            }
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            pcm = data.data() + body;
+            pcm_size = avail;
+        }
+        // Chunks are word aligned
+        pos = body + chunk_size + (chunk_size & 1);
+    }
+
+    bool supported = (format == WAV_FORMAT_PCM && (bits == 8 || bits == 16 || bits == 24 || bits == 32)) ||
+                     (format == WAV_FORMAT_IEEE_FLOAT && (bits == 32 || bits == 64));
+    if (!pcm || channels == 0 || rate == 0 || !supported) {
+        NOTE_NAGA_LOG_ERROR("Unsupported WAV format in file: " + filename);
+        return false;
+    }
+
+    size_t bytes_per_sample = bits / 8;
+    size_t frame_size = bytes_per_sample * channels;
+    size_t frames = pcm_size / frame_size;
+
+    sample_rate = int(rate);
+    num_channels = channels;
+    left.resize(frames);
+    right.resize(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        const uint8_t *frame = pcm + i * frame_size;
+        left[i] = decodeSample(frame, format, bits);
+        right[i] = channels > 1 ? decodeSample(frame + bytes_per_sample, format, bits) : left[i];
+    }
+
+    NOTE_NAGA_LOG_INFO("Loaded WAV file: " + filename + " (" + std::to_string(frames) +
+                       " frames, " + std::to_string(sample_rate) + " Hz)");
+    return true;
+}
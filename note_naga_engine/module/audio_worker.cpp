@@ -1,6 +1,9 @@
 #include <note_naga_engine/module/audio_worker.h>
 
+#include <note_naga_engine/core/dsp_denormals.h>
+
 #include <cstring>
+#include <thread>
 
 NoteNagaAudioWorker::NoteNagaAudioWorker(NoteNagaDSPEngine *dsp) {
     this->setDSPEngine(dsp);
@@ -27,6 +30,9 @@ bool NoteNagaAudioWorker::start(unsigned int sampleRate, unsigned int blockSize)
 
     this->audio.openStream(&params, nullptr, RTAUDIO_FLOAT32, this->sample_rate, &this->block_size,
                       &NoteNagaAudioWorker::audioCallback, this);
+
+    // Block size is final after opening, prepare all DSP before the first callback
+    if (this->dsp_engine) this->dsp_engine->prepare(int(this->sample_rate), this->block_size);
     this->audio.startStream();
     this->stream_open = true;
 
@@ -63,8 +69,13 @@ bool NoteNagaAudioWorker::stop() {
 int NoteNagaAudioWorker::audioCallback(void *outputBuffer, void *, unsigned int nFrames, double,
                                        RtAudioStreamStatus, void *userData) {
     NoteNagaAudioWorker *self = static_cast<NoteNagaAudioWorker *>(userData);
+    // Decaying reverb / delay tails must not fall into slow denormal arithmetic
+    NoteNagaScopedNoDenormals no_denormals;
     float *out = static_cast<float *>(outputBuffer);
 
+    // Announce the callback before checking mute, mute() waits until it is cleared
+    self->in_callback.store(true);
+
     // Zkontrolujeme, zda je worker ztlumený (muted) nebo nemá DSP engine.
     // .load() bezpečně přečte hodnotu z atomické proměnné.
     if (self->is_muted.load(std::memory_order_relaxed) || !self->dsp_engine) {
@@ -74,11 +85,16 @@ int NoteNagaAudioWorker::audioCallback(void *outputBuffer, void *, unsigned int
         // Pokud není ztlumený, renderujeme normálně.
         self->dsp_engine->render(out, nFrames, true);
     }
+    self->in_callback.store(false);
     return 0;
 }
 
 void NoteNagaAudioWorker::mute() {
-    this->is_muted.store(true, std::memory_order_relaxed);
+    this->is_muted.store(true);
+    // A callback that saw the worker unmuted may still be rendering, wait for it
+    while (this->in_callback.load()) {
+        std::this_thread::yield();
+    }
 }
 
 void NoteNagaAudioWorker::unmute() {
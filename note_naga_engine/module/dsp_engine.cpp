@@ -1,79 +1,406 @@
 #include <note_naga_engine/module/dsp_engine.h>
 
 #include <note_naga_engine/core/types.h>
+#include <note_naga_engine/core/dsp_vector_math.h>
 
 #include <cmath>
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <cstring>
+#include <thread>
+
+// Size of all render buffers, longer renders are processed in blocks of this size
+static constexpr size_t RENDER_BLOCK_FRAMES = 2048;
+// Maximum number of per-channel synth outputs (one per MIDI channel)
+static constexpr size_t MAX_SYNTH_OUTPUTS = 16;
+// Maximum number of parts of one synth pre-rendered in parallel
+static constexpr size_t MAX_RENDER_PARTS = 16;
+// Longest latency compensation delay of one path (power of two)
+static constexpr size_t MAX_COMPENSATION_FRAMES = 4096;
+// Voice budget of a synth without explicit limit
+static constexpr size_t DEFAULT_SYNTH_VOICES = 256;
+// Load guard: lower polyphony above high load, restore it slowly below low load
+static constexpr float GUARD_HIGH_LOAD = 0.8f;
+static constexpr float GUARD_LOW_LOAD = 0.5f;
+static constexpr float GUARD_DECREASE = 0.85f;
+static constexpr float GUARD_INCREASE = 1.02f;
+static constexpr float GUARD_MIN_SCALE = 0.1f;
+
+using ProfileClock = std::chrono::steady_clock;
 
 NoteNagaDSPEngine::NoteNagaDSPEngine(NoteNagaMetronome* metronome, NoteNagaSpectrumAnalyzer * spectrum_analyzer) {
     this->metronome_ = metronome;
     this->spectrum_analyzer_ = spectrum_analyzer;
     this->enable_dsp_ = true;
+    this->thread_pool_ = std::make_unique<NoteNagaDSPThreadPool>();
+
+    // Audio thread buffers are never resized, longer renders are split into chunks
+    this->mix_left_.assign(RENDER_BLOCK_FRAMES, 0.0f);
+    this->mix_right_.assign(RENDER_BLOCK_FRAMES, 0.0f);
+    this->metronome_left_.assign(RENDER_BLOCK_FRAMES, 0.0f);
+    this->metronome_right_.assign(RENDER_BLOCK_FRAMES, 0.0f);
+    this->metronome_compensation_ = carryCompensation(nullptr);
+    this->max_block_frames_.store(RENDER_BLOCK_FRAMES);
+    this->publishRenderGraph();
     NOTE_NAGA_LOG_INFO("DSP Engine initialized");
 }
 
+NoteNagaDSPEngine::~NoteNagaDSPEngine() {
+    delete this->render_graph_.exchange(nullptr);
+}
+
+void NoteNagaDSPEngine::renderBranchJob(void *context, size_t job_idx) {
+    NoteNagaDSPEngine *self = static_cast<NoteNagaDSPEngine *>(context);
+    size_t branch_idx = (*self->current_wave_)[job_idx];
+    self->renderBranch(self->current_graph_->branches[branch_idx], self->render_num_frames_);
+}
+
+void NoteNagaDSPEngine::renderPartJob(void *context, size_t part_idx) {
+    NoteNagaDSPEngine *self = static_cast<NoteNagaDSPEngine *>(context);
+    RenderPart &part = self->current_graph_->parts[part_idx];
+    RenderBranch &branch = self->current_graph_->branches[part.branch];
+    if (!self->profiling_enabled_.load(std::memory_order_relaxed) || !branch.load_meter) {
+        branch.synth->renderPart(part.part, self->render_num_frames_);
+        return;
+    }
+    auto start = ProfileClock::now();
+    branch.synth->renderPart(part.part, self->render_num_frames_);
+    part.seconds = std::chrono::duration<double>(ProfileClock::now() - start).count();
+}
+
+void NoteNagaDSPEngine::renderParts(RenderGraph &graph, const std::vector<size_t> &wave) {
+    // Parts of all synths of the wave form one job set, so they share the workers with
+    // each other instead of every synth bringing its own threads
+    graph.parts.clear();
+    for (size_t b : wave) {
+        RenderBranch &branch = graph.branches[b];
+        branch.first_part = graph.parts.size();
+        branch.num_parts = std::min(branch.synth->getRenderPartCount(), MAX_RENDER_PARTS);
+        for (size_t p = 0; p < branch.num_parts; ++p) graph.parts.push_back({b, p, 0.0});
+    }
+    if (!graph.parts.empty()) {
+        this->thread_pool_->run(&NoteNagaDSPEngine::renderPartJob, this, graph.parts.size());
+    }
+}
+
+double NoteNagaDSPEngine::partSeconds(const RenderBranch &branch) const {
+    double seconds = 0.0;
+    for (size_t p = 0; p < branch.num_parts; ++p) seconds += this->current_graph_->parts[branch.first_part + p].seconds;
+    return seconds;
+}
+
+void NoteNagaDSPEngine::renderAuxBusJob(void *context, size_t bus_idx) {
+    NoteNagaDSPEngine *self = static_cast<NoteNagaDSPEngine *>(context);
+    RenderAuxBus &bus = self->current_graph_->aux_buses[bus_idx];
+    self->processChain(bus.blocks, bus.sidechains, bus.left.data(), bus.right.data(), self->render_num_frames_,
+                       self->profiling_enabled_.load(std::memory_order_relaxed));
+    applyCompensation(*bus.compensation, bus.left.data(), bus.right.data(), self->render_num_frames_,
+                      bus.compensation_frames);
+}
+
+void NoteNagaDSPEngine::processChain(const std::vector<NoteNagaDSPBlockBase *> &blocks,
+                                     const std::vector<const RenderBranch *> &sidechains, float *left,
+                                     float *right, size_t num_frames, bool profile) {
+    if (blocks.empty()) return;
+
+    // Blocks whose input was silent for longer than their tail are skipped, the buffer
+    // stays silent then and the next block sees silent input as well
+    const double sample_rate = double(this->sample_rate_.load(std::memory_order_relaxed));
+    bool silent = isSilent(left, right, num_frames);
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        NoteNagaDSPBlockBase *block = blocks[b];
+        if (!block->isActive()) continue;
+
+        NN_DSPSleepState_t &sleep = block->getSleepState();
+        if (silent) {
+            if (sleep.sleeping) {
+                if (profile) block->getLoadMeter().record(0.0f);
+                continue;
+            }
+            sleep.silent_frames += num_frames;
+        } else {
+            sleep.silent_frames = 0;
+            sleep.sleeping = false;
+        }
+
+        // Sidechain source was rendered in an earlier wave, its buffers are read in place
+        const RenderBranch *key = b < sidechains.size() ? sidechains[b] : nullptr;
+        if (key) block->setSidechainInput(key->left.data(), key->right.data());
+
+        if (profile) {
+            auto start = ProfileClock::now();
+            block->process(left, right, num_frames);
+            double elapsed = std::chrono::duration<double>(ProfileClock::now() - start).count();
+            block->getLoadMeter().record(float(elapsed * this->render_load_scale_));
+        } else {
+            block->process(left, right, num_frames);
+        }
+        if (key) block->setSidechainInput(nullptr, nullptr);
+
+        // Sleep once the output is silent and the tail of the last sound has passed
+        silent = isSilent(left, right, num_frames);
+        if (silent && double(sleep.silent_frames) > double(block->getTailSeconds()) * sample_rate) {
+            sleep.sleeping = true;
+        }
+    }
+}
+
+bool NoteNagaDSPEngine::isSilent(const float *left, const float *right, size_t num_frames) {
+    return nn_vec_abs_max(left, num_frames) < NN_DSP_SILENCE_LEVEL &&
+           nn_vec_abs_max(right, num_frames) < NN_DSP_SILENCE_LEVEL;
+}
+
+size_t NoteNagaDSPEngine::chainLatency(const std::vector<NoteNagaDSPBlockBase *> &blocks) {
+    size_t latency = 0;
+    for (const NoteNagaDSPBlockBase *block : blocks) {
+        if (block->isActive()) latency += block->getLatencySamples();
+    }
+    return latency;
+}
+
+size_t NoteNagaDSPEngine::branchLatency(const RenderBranch &branch, bool dsp) {
+    if (!dsp) return 0;
+    // Channel chains are aligned to the slowest one before they are summed
+    size_t channels = 0;
+    size_t num_outputs = std::min(branch.synth->getAudioOutputCount(), branch.channel_blocks.size());
+    if (num_outputs > 1) {
+        for (size_t c = 0; c < num_outputs; ++c) channels = std::max(channels, chainLatency(branch.channel_blocks[c]));
+    }
+    return channels + chainLatency(branch.blocks);
+}
+
+std::shared_ptr<NoteNagaDSPEngine::CompensationDelay>
+NoteNagaDSPEngine::carryCompensation(const std::shared_ptr<CompensationDelay> &previous) {
+    // The path existed in the previous graph, keep its delayed audio
+    if (previous) return previous;
+    auto compensation = std::make_shared<CompensationDelay>();
+    compensation->left.assign(MAX_COMPENSATION_FRAMES, 0.0f);
+    compensation->right.assign(MAX_COMPENSATION_FRAMES, 0.0f);
+    return compensation;
+}
+
+void NoteNagaDSPEngine::applyCompensation(CompensationDelay &compensation, float *left, float *right,
+                                          size_t num_frames, size_t delay) {
+    // The ring keeps the latest input even without delay, so a changed latency only moves the tap
+    const size_t size = compensation.left.size();
+    const size_t mask = size - 1;
+    delay = std::min(delay, size);
+    float *buf_left = compensation.left.data();
+    float *buf_right = compensation.right.data();
+    size_t pos = compensation.pos;
+    if (delay == 0) {
+        for (size_t done = 0; done < num_frames;) {
+            const size_t count = std::min(num_frames - done, size - pos);
+            std::copy(left + done, left + done + count, buf_left + pos);
+            std::copy(right + done, right + done + count, buf_right + pos);
+            pos = (pos + count) & mask;
+            done += count;
+        }
+        compensation.pos = pos;
+        return;
+    }
+
+    for (size_t i = 0; i < num_frames; ++i) {
+        const size_t read = (pos - delay) & mask;
+        const float in_left = left[i];
+        const float in_right = right[i];
+        left[i] = buf_left[read];
+        right[i] = buf_right[read];
+        buf_left[pos] = in_left;
+        buf_right[pos] = in_right;
+        pos = (pos + 1) & mask;
+    }
+    compensation.pos = pos;
+}
+
+void NoteNagaDSPEngine::renderBranch(RenderBranch &branch, size_t num_frames) {
+    // Clear branch buffers
+    std::fill(branch.left.begin(), branch.left.begin() + num_frames, 0.0f);
+    std::fill(branch.right.begin(), branch.right.begin() + num_frames, 0.0f);
+
+    // Render this synth to its own buffers, per channel if it has channel chains
+    bool dsp = this->enable_dsp_.load(std::memory_order_relaxed);
+    bool profile = this->profiling_enabled_.load(std::memory_order_relaxed) && branch.load_meter;
+    if (!dsp || !renderBranchChannels(branch, num_frames, profile)) {
+        auto start = profile ? ProfileClock::now() : ProfileClock::time_point();
+        branch.synth->renderAudio(branch.left.data(), branch.right.data(), num_frames);
+        if (profile) {
+            double elapsed = std::chrono::duration<double>(ProfileClock::now() - start).count();
+            elapsed += this->partSeconds(branch);
+            branch.load_meter->record(float(elapsed * this->render_load_scale_));
+        }
+    }
+
+    // Apply synth-specific DSP blocks if DSP is enabled
+    if (dsp) {
+        this->processChain(branch.blocks, branch.sidechains, branch.left.data(), branch.right.data(), num_frames,
+                           profile);
+    }
+
+    // Align with the slowest branch
+    applyCompensation(*branch.compensation, branch.left.data(), branch.right.data(), num_frames,
+                      branch.compensation_frames);
+}
+
+bool NoteNagaDSPEngine::renderBranchChannels(RenderBranch &branch, size_t num_frames, bool profile) {
+    size_t num_outputs = std::min(branch.synth->getAudioOutputCount(), branch.channel_blocks.size());
+    if (num_outputs <= 1) return false;
+
+    for (size_t c = 0; c < num_outputs; ++c) {
+        std::fill(branch.out_left[c].begin(), branch.out_left[c].begin() + num_frames, 0.0f);
+        std::fill(branch.out_right[c].begin(), branch.out_right[c].begin() + num_frames, 0.0f);
+    }
+    auto start = profile ? ProfileClock::now() : ProfileClock::time_point();
+    branch.synth->renderAudioOutputs(branch.out_left_ptrs.data(), branch.out_right_ptrs.data(),
+                                     num_outputs, num_frames);
+    if (profile) {
+        double elapsed = std::chrono::duration<double>(ProfileClock::now() - start).count();
+        elapsed += this->partSeconds(branch);
+        branch.load_meter->record(float(elapsed * this->render_load_scale_));
+    }
+
+    size_t max_latency = 0;
+    for (size_t c = 0; c < num_outputs; ++c) max_latency = std::max(max_latency, chainLatency(branch.channel_blocks[c]));
+
+    for (size_t c = 0; c < num_outputs; ++c) {
+        float *out_left = branch.out_left_ptrs[c];
+        float *out_right = branch.out_right_ptrs[c];
+
+        // Channel DSP chain, aligned with the slowest channel chain
+        this->processChain(branch.channel_blocks[c], branch.channel_sidechains[c], out_left, out_right,
+                           num_frames, profile);
+        applyCompensation(*branch.channel_compensation[c], out_left, out_right, num_frames,
+                          max_latency - chainLatency(branch.channel_blocks[c]));
+
+        // Sum channel into the synth branch
+        nn_vec_add(branch.left.data(), out_left, num_frames);
+        nn_vec_add(branch.right.data(), out_right, num_frames);
+    }
+    return true;
+}
+
 void NoteNagaDSPEngine::render(float *output, size_t num_frames, bool compute_rms) {
-    // Prepare mix buffers
-    if (mix_left_.size() < num_frames) mix_left_.resize(num_frames, 0.0f);
-    if (mix_right_.size() < num_frames) mix_right_.resize(num_frames, 0.0f);
-    if (temp_left_.size() < num_frames) temp_left_.resize(num_frames, 0.0f);
-    if (temp_right_.size() < num_frames) temp_right_.resize(num_frames, 0.0f);
-    
+    // Only one render at a time, never wait. Offline export mutes the audio worker
+    // first, which waits for an in-flight callback, so it never lands here.
+    if (this->render_busy_.exchange(true, std::memory_order_acquire)) {
+        std::fill(output, output + num_frames * 2, 0.0f);
+        return;
+    }
+
+    auto render_start = std::chrono::steady_clock::now();
+
+    // Split long renders (offline export) into blocks the DSP blocks are prepared for
+    const size_t max_frames = this->max_block_frames_.load(std::memory_order_relaxed);
+    for (size_t offset = 0; offset < num_frames; offset += max_frames) {
+        size_t frames = std::min(max_frames, num_frames - offset);
+        this->renderBlock(output + offset * 2, frames, compute_rms);
+    }
+
+    // Measure load of this block and let the guard adjust polyphony
+    int sample_rate = this->sample_rate_.load(std::memory_order_relaxed);
+    if (sample_rate > 0 && num_frames > 0) {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - render_start).count();
+        float load = float(elapsed * sample_rate / double(num_frames));
+        this->render_load_.store(load, std::memory_order_relaxed);
+        if (this->voice_guard_enabled_.load(std::memory_order_relaxed)) this->updateVoiceGuard(load);
+    }
+
+    this->render_busy_.store(false, std::memory_order_release);
+}
+
+void NoteNagaDSPEngine::renderBlock(float *output, size_t num_frames, bool compute_rms) {
+    // Odd sequence marks a block in progress, the graph it loads stays alive until it is even again
+    this->render_seq_.fetch_add(1);
+    RenderGraph *graph = this->render_graph_.load();
+    this->current_graph_ = graph;
+
     std::fill(mix_left_.begin(), mix_left_.begin() + num_frames, 0.0f);
     std::fill(mix_right_.begin(), mix_right_.begin() + num_frames, 0.0f);
 
-    // Render all synths and mix
-    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
-    for (INoteNagaSoftSynth *synth : this->synths_) {
-        // Clear temporary buffers
-        std::fill(temp_left_.begin(), temp_left_.begin() + num_frames, 0.0f);
-        std::fill(temp_right_.begin(), temp_right_.begin() + num_frames, 0.0f);
-        
-        // Render this synth to temporary buffers
-        synth->renderAudio(temp_left_.data(), temp_right_.data(), num_frames);
-        
-        // Apply synth-specific DSP blocks if DSP is enabled
-        if (this->enable_dsp_) {
-            auto it = synth_dsp_blocks_.find(synth);
-            if (it != synth_dsp_blocks_.end()) {
-                for (NoteNagaDSPBlockBase *block : it->second) {
-                    if (block->isActive()) {
-                        block->process(temp_left_.data(), temp_right_.data(), num_frames);
-                    }
-                }
-            }
+    // Polyphony follows the budgets of the graph and the load guard
+    this->applyVoiceLimits(*graph);
+
+    // Delay every branch to the latency of the slowest one
+    bool dsp = this->enable_dsp_.load(std::memory_order_relaxed);
+    size_t branch_latency = 0;
+    for (RenderBranch &branch : graph->branches) {
+        branch.compensation_frames = branchLatency(branch, dsp);
+        branch_latency = std::max(branch_latency, branch.compensation_frames);
+    }
+    for (RenderBranch &branch : graph->branches) {
+        branch.compensation_frames = branch_latency - branch.compensation_frames;
+    }
+
+    // Render synth branches in parallel, wave by wave so that sidechain sources are
+    // finished before the branches keyed by them (one wave without sidechains)
+    this->render_num_frames_ = num_frames;
+    this->render_load_scale_ = double(this->sample_rate_.load(std::memory_order_relaxed)) / double(num_frames);
+    for (const std::vector<size_t> &wave : graph->waves) {
+        this->current_wave_ = &wave;
+        this->renderParts(*graph, wave);
+        this->thread_pool_->run(&NoteNagaDSPEngine::renderBranchJob, this, wave.size());
+    }
+    this->current_wave_ = nullptr;
+
+    // Sum branches in fixed synth order (deterministic result)
+    for (const RenderBranch &branch : graph->branches) {
+        nn_vec_add(mix_left_.data(), branch.left.data(), num_frames);
+        nn_vec_add(mix_right_.data(), branch.right.data(), num_frames);
+    }
+
+    size_t bus_latency = 0;
+    if (dsp && !graph->aux_buses.empty()) {
+        // Bus returns are aligned with the slowest bus, the dry mix is delayed by its latency
+        for (RenderAuxBus &bus : graph->aux_buses) {
+            bus.compensation_frames = chainLatency(bus.blocks);
+            bus_latency = std::max(bus_latency, bus.compensation_frames);
         }
-        
-        // Add to mix buffers
-        for (size_t i = 0; i < num_frames; i++) {
-            mix_left_[i] += temp_left_[i];
-            mix_right_[i] += temp_right_[i];
+        for (RenderAuxBus &bus : graph->aux_buses) bus.compensation_frames = bus_latency - bus.compensation_frames;
+
+        // Aux buses: sends in synth order, bus chains in parallel, returns in bus order
+        this->mixAuxSends(*graph, num_frames);
+        this->thread_pool_->run(&NoteNagaDSPEngine::renderAuxBusJob, this, graph->aux_buses.size());
+        applyCompensation(*graph->dry_compensation, mix_left_.data(), mix_right_.data(), num_frames, bus_latency);
+        for (const RenderAuxBus &bus : graph->aux_buses) {
+            nn_vec_add(mix_left_.data(), bus.left.data(), num_frames);
+            nn_vec_add(mix_right_.data(), bus.right.data(), num_frames);
         }
+    } else {
+        applyCompensation(*graph->dry_compensation, mix_left_.data(), mix_right_.data(), num_frames, 0);
     }
 
     // Master DSP blocks processing
-    if (this->enable_dsp_) {
-        for (NoteNagaDSPBlockBase *block : this->dsp_blocks_) {
-            if (block->isActive()) {
-                block->process(mix_left_.data(), mix_right_.data(), num_frames);
-            }
-        }
+    size_t output_latency = branch_latency + bus_latency;
+    if (dsp) {
+        this->processChain(graph->master_blocks, graph->master_sidechains, mix_left_.data(), mix_right_.data(),
+                           num_frames, this->profiling_enabled_.load(std::memory_order_relaxed));
+        output_latency += chainLatency(graph->master_blocks);
     }
 
-    // Metronome rendering
+    // Blocks of the graph are not used after this point
+    this->current_graph_ = nullptr;
+    this->render_seq_.fetch_add(1);
+
+    // Metronome rendering, delayed by the output latency so the clicks stay on the beat
+    // of the music (and of the export, which trims that latency)
     if (this->metronome_) {
-        this->metronome_->render(mix_left_.data(), mix_right_.data(), num_frames);
+        std::fill(metronome_left_.begin(), metronome_left_.begin() + num_frames, 0.0f);
+        std::fill(metronome_right_.begin(), metronome_right_.begin() + num_frames, 0.0f);
+        this->metronome_->render(metronome_left_.data(), metronome_right_.data(), num_frames);
+        applyCompensation(*metronome_compensation_, metronome_left_.data(), metronome_right_.data(), num_frames,
+                          output_latency);
+        nn_vec_add(mix_left_.data(), metronome_left_.data(), num_frames);
+        nn_vec_add(mix_right_.data(), metronome_right_.data(), num_frames);
     }
 
     // apply master volume with logarithmic effect
-    if (output_volume_ < 1.0f) {
+    float volume = this->output_volume_.load(std::memory_order_relaxed);
+    if (volume < 1.0f) {
         // Use a simple logarithmic curve for perceptual loudness
-        float log_volume = powf(output_volume_, 2.0f); // or use another exponent for desired curve
-        for (size_t i = 0; i < num_frames; ++i) {
-            mix_left_[i] *= log_volume;
-            mix_right_[i] *= log_volume;
-        }
+        float log_volume = powf(volume, 2.0f); // or use another exponent for desired curve
+        nn_vec_scale(mix_left_.data(), log_volume, num_frames);
+        nn_vec_scale(mix_right_.data(), log_volume, num_frames);
     }
 
     // Calculate RMS for visualization
@@ -90,58 +417,306 @@ void NoteNagaDSPEngine::render(float *output, size_t num_frames, bool compute_rm
         this->spectrum_analyzer_->pushSamplesToRightBuffer(mix_right_.data(), num_frames);
     }
 
-    // Interleave left and right channels using pointer arithmetic for efficiency
-    float *left = mix_left_.data();
-    float *right = mix_right_.data();
-    float *out = output;
-    size_t i = 0;
-    size_t n = num_frames;
-    // Unroll loop for better performance
-    for (; i + 3 < n; i += 4) {
-        out[0] = left[i];
-        out[1] = right[i];
-        out[2] = left[i + 1];
-        out[3] = right[i + 1];
-        out[4] = left[i + 2];
-        out[5] = right[i + 2];
-        out[6] = left[i + 3];
-        out[7] = right[i + 3];
-        out += 8;
+    // Interleave left and right channels
+    nn_vec_interleave(output, mix_left_.data(), mix_right_.data(), num_frames);
+}
+
+void NoteNagaDSPEngine::mixAuxSends(RenderGraph &graph, size_t num_frames) {
+    for (RenderAuxBus &bus : graph.aux_buses) {
+        std::fill(bus.left.begin(), bus.left.begin() + num_frames, 0.0f);
+        std::fill(bus.right.begin(), bus.right.begin() + num_frames, 0.0f);
     }
-    // Handle remaining frames
-    for (; i < n; ++i) {
-        *out++ = left[i];
-        *out++ = right[i];
+
+    for (const RenderBranch &branch : graph.branches) {
+        for (size_t b = 0; b < branch.aux_sends.size(); ++b) {
+            AuxSend *send = branch.aux_sends[b];
+            if (!send) continue;
+            float target = send->level.load(std::memory_order_relaxed);
+            float from = send->applied;
+            send->applied = target;
+            if (from == 0.0f && target == 0.0f) continue;
+
+            float *bus_left = graph.aux_buses[b].left.data();
+            float *bus_right = graph.aux_buses[b].right.data();
+            if (from == target) {
+                nn_vec_mul_add(bus_left, branch.left.data(), target, num_frames);
+                nn_vec_mul_add(bus_right, branch.right.data(), target, num_frames);
+                continue;
+            }
+
+            // Level changed, ramp over this block
+            float step = (target - from) / float(num_frames);
+            for (size_t i = 0; i < num_frames; ++i) {
+                float gain = from + step * float(i + 1);
+                bus_left[i] += branch.left[i] * gain;
+                bus_right[i] += branch.right[i] * gain;
+            }
+        }
     }
 }
 
+void NoteNagaDSPEngine::publishRenderGraph() {
+    // Build the new graph with all buffers allocated here, outside of the audio thread
+    RenderGraph *graph = new RenderGraph();
+    graph->master_blocks = dsp_blocks_;
+
+    // Compensation delays of surviving paths are shared with the previous graph (only one
+    // block renders at a time), matched by synth, bus id and the dry path
+    const RenderGraph *previous = this->render_graph_.load();
+    graph->dry_compensation = carryCompensation(previous ? previous->dry_compensation : nullptr);
+
+    graph->aux_buses.resize(aux_buses_.size());
+    for (size_t b = 0; b < aux_buses_.size(); ++b) {
+        RenderAuxBus &bus = graph->aux_buses[b];
+        bus.id = aux_buses_[b].id;
+        bus.blocks = aux_buses_[b].blocks;
+        bus.left.assign(RENDER_BLOCK_FRAMES, 0.0f);
+        bus.right.assign(RENDER_BLOCK_FRAMES, 0.0f);
+        // Removed buses shift the indices of the following ones
+        std::shared_ptr<CompensationDelay> previous_compensation;
+        if (previous) {
+            for (const RenderAuxBus &previous_bus : previous->aux_buses) {
+                if (previous_bus.id == bus.id) previous_compensation = previous_bus.compensation;
+            }
+        }
+        bus.compensation = carryCompensation(previous_compensation);
+    }
+
+    // Share of the global voice budget
+    size_t total = 0;
+    for (INoteNagaSoftSynth *synth : synths_) {
+        auto limit = synth_voice_limits_.find(synth);
+        total += limit != synth_voice_limits_.end() ? limit->second : DEFAULT_SYNTH_VOICES;
+    }
+    float share = 1.0f;
+    if (global_voice_limit_ > 0 && total > global_voice_limit_) {
+        share = float(global_voice_limit_) / float(total);
+    }
+
+    graph->branches.resize(synths_.size());
+    graph->parts.reserve(synths_.size() * MAX_RENDER_PARTS);
+    for (size_t b = 0; b < synths_.size(); ++b) {
+        RenderBranch &branch = graph->branches[b];
+        branch.synth = synths_[b];
+        branch.left.assign(RENDER_BLOCK_FRAMES, 0.0f);
+        branch.right.assign(RENDER_BLOCK_FRAMES, 0.0f);
+
+        const RenderBranch *previous_branch = nullptr;
+        if (previous) {
+            for (const RenderBranch &candidate : previous->branches) {
+                if (candidate.synth == branch.synth) previous_branch = &candidate;
+            }
+        }
+        branch.compensation = carryCompensation(previous_branch ? previous_branch->compensation : nullptr);
+
+        auto limit = synth_voice_limits_.find(branch.synth);
+        size_t budget = limit != synth_voice_limits_.end() ? limit->second : DEFAULT_SYNTH_VOICES;
+        branch.voice_budget = std::max<size_t>(1, size_t(float(budget) * share));
+
+        auto blocks = synth_dsp_blocks_.find(branch.synth);
+        if (blocks != synth_dsp_blocks_.end()) branch.blocks = blocks->second;
+
+        auto meter = synth_load_meters_.find(branch.synth);
+        if (meter != synth_load_meters_.end()) branch.load_meter = meter->second.get();
+
+        auto sends = synth_aux_sends_.find(branch.synth);
+        if (sends != synth_aux_sends_.end()) {
+            branch.aux_sends.assign(aux_buses_.size(), nullptr);
+            for (const auto &[bus, send] : sends->second) {
+                if (bus < int(aux_buses_.size())) branch.aux_sends[size_t(bus)] = send.get();
+            }
+        }
+
+        auto chains = synth_channel_dsp_blocks_.find(branch.synth);
+        if (chains == synth_channel_dsp_blocks_.end()) continue;
+
+        // Per-channel outputs only for synths with channel chains
+        branch.channel_blocks.resize(MAX_SYNTH_OUTPUTS);
+        for (const auto &[channel, chain] : chains->second) {
+            branch.channel_blocks[size_t(channel)] = chain;
+        }
+        branch.out_left.assign(MAX_SYNTH_OUTPUTS, std::vector<float>(RENDER_BLOCK_FRAMES, 0.0f));
+        branch.out_right.assign(MAX_SYNTH_OUTPUTS, std::vector<float>(RENDER_BLOCK_FRAMES, 0.0f));
+        for (size_t c = 0; c < MAX_SYNTH_OUTPUTS; ++c) {
+            branch.out_left_ptrs.push_back(branch.out_left[c].data());
+            branch.out_right_ptrs.push_back(branch.out_right[c].data());
+        }
+        branch.channel_compensation.resize(MAX_SYNTH_OUTPUTS);
+        for (size_t c = 0; c < MAX_SYNTH_OUTPUTS; ++c) {
+            const bool existed = previous_branch && c < previous_branch->channel_compensation.size();
+            branch.channel_compensation[c] = carryCompensation(existed ? previous_branch->channel_compensation[c] : nullptr);
+        }
+    }
+
+    // Sidechain sources render in earlier waves than the branches they key, master and
+    // aux bus blocks run after all branches
+    std::vector<size_t> branch_waves;
+    this->buildRenderWaves(graph->waves, branch_waves);
+    const size_t after_branches = graph->waves.size();
+    graph->master_sidechains = resolveSidechains(graph->master_blocks, *graph, branch_waves, after_branches);
+    for (RenderAuxBus &bus : graph->aux_buses) {
+        bus.sidechains = resolveSidechains(bus.blocks, *graph, branch_waves, after_branches);
+    }
+    for (size_t b = 0; b < graph->branches.size(); ++b) {
+        RenderBranch &branch = graph->branches[b];
+        branch.sidechains = resolveSidechains(branch.blocks, *graph, branch_waves, branch_waves[b]);
+        branch.channel_sidechains.resize(branch.channel_blocks.size());
+        for (size_t c = 0; c < branch.channel_blocks.size(); ++c) {
+            branch.channel_sidechains[c] = resolveSidechains(branch.channel_blocks[c], *graph, branch_waves,
+                                                             branch_waves[b]);
+        }
+    }
+
+    RenderGraph *old = this->render_graph_.exchange(graph);
+
+    // Wait until a block that may have loaded the old graph is finished
+    uint64_t seq = this->render_seq_.load();
+    if (seq & 1) {
+        while (this->render_seq_.load() == seq) {
+            std::this_thread::yield();
+        }
+    }
+    delete old;
+}
+
+bool NoteNagaDSPEngine::buildRenderWaves(std::vector<std::vector<size_t>> &waves,
+                                         std::vector<size_t> &branch_waves) const {
+    // Synths every synth branch depends on through sidechains of its blocks
+    const size_t count = synths_.size();
+    std::vector<std::vector<size_t>> sources(count);
+    auto addSources = [&](size_t b, const std::vector<NoteNagaDSPBlockBase *> &blocks) {
+        for (const NoteNagaDSPBlockBase *block : blocks) {
+            auto key = block_sidechains_.find(block);
+            if (key == block_sidechains_.end()) continue;
+            auto source = std::find(synths_.begin(), synths_.end(), key->second);
+            if (source != synths_.end()) sources[b].push_back(size_t(source - synths_.begin()));
+        }
+    };
+    for (size_t b = 0; b < count; ++b) {
+        auto blocks = synth_dsp_blocks_.find(synths_[b]);
+        if (blocks != synth_dsp_blocks_.end()) addSources(b, blocks->second);
+        auto chains = synth_channel_dsp_blocks_.find(synths_[b]);
+        if (chains == synth_channel_dsp_blocks_.end()) continue;
+        for (const auto &[channel, chain] : chains->second) addSources(b, chain);
+    }
+
+    // Every wave takes the branches whose sources are all in earlier waves, in synth order
+    waves.clear();
+    branch_waves.assign(count, SIZE_MAX);
+    size_t assigned = 0;
+    while (assigned < count) {
+        std::vector<size_t> wave;
+        for (size_t b = 0; b < count; ++b) {
+            if (branch_waves[b] != SIZE_MAX) continue;
+            bool ready = std::all_of(sources[b].begin(), sources[b].end(),
+                                     [&](size_t source) { return branch_waves[source] < waves.size(); });
+            if (ready) wave.push_back(b);
+        }
+        if (wave.empty()) {
+            // Routing loop: the rest renders last, sidechains within it are ignored
+            for (size_t b = 0; b < count; ++b) {
+                if (branch_waves[b] == SIZE_MAX) wave.push_back(b);
+            }
+            for (size_t b : wave) branch_waves[b] = waves.size();
+            waves.push_back(std::move(wave));
+            return false;
+        }
+        for (size_t b : wave) branch_waves[b] = waves.size();
+        assigned += wave.size();
+        waves.push_back(std::move(wave));
+    }
+    return true;
+}
+
+std::vector<const NoteNagaDSPEngine::RenderBranch *>
+NoteNagaDSPEngine::resolveSidechains(const std::vector<NoteNagaDSPBlockBase *> &blocks, const RenderGraph &graph,
+                                     const std::vector<size_t> &branch_waves, size_t wave) const {
+    std::vector<const RenderBranch *> sidechains;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        auto key = block_sidechains_.find(blocks[i]);
+        if (key == block_sidechains_.end()) continue;
+        auto source = std::find(synths_.begin(), synths_.end(), key->second);
+        if (source == synths_.end()) continue;
+
+        // Only sources finished before this chain is processed
+        size_t b = size_t(source - synths_.begin());
+        if (branch_waves[b] >= wave) continue;
+        sidechains.resize(blocks.size(), nullptr);
+        sidechains[i] = &graph.branches[b];
+    }
+    return sidechains;
+}
+
+void NoteNagaDSPEngine::eraseSidechains(const std::vector<NoteNagaDSPBlockBase *> &blocks) {
+    for (const NoteNagaDSPBlockBase *block : blocks) block_sidechains_.erase(block);
+}
+
+void NoteNagaDSPEngine::replaceChain(std::vector<NoteNagaDSPBlockBase *> &chain,
+                                     const std::vector<NoteNagaDSPBlockBase *> &blocks) {
+    // Blocks that stay in the chain keep their state, only new ones are prepared
+    for (NoteNagaDSPBlockBase *block : blocks) {
+        if (std::find(chain.begin(), chain.end(), block) == chain.end()) prepareBlock(block);
+    }
+    for (NoteNagaDSPBlockBase *block : chain) {
+        if (std::find(blocks.begin(), blocks.end(), block) == blocks.end()) block_sidechains_.erase(block);
+    }
+    chain = blocks;
+}
+
 void NoteNagaDSPEngine::setEnableDSP(bool enable) {
-    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
-    this->enable_dsp_ = enable;
+    this->enable_dsp_.store(enable, std::memory_order_relaxed);
 }
 
 void NoteNagaDSPEngine::addSynth(INoteNagaSoftSynth *synth) {
     std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    synth->setVoiceStealPolicy(voice_steal_policy_);
+    synth->setSampleRate(this->sample_rate_.load(std::memory_order_relaxed));
     synths_.push_back(synth);
+    synth_load_meters_[synth] = std::make_unique<NoteNagaDSPLoadMeter>();
+    publishRenderGraph();
 }
 
 void NoteNagaDSPEngine::removeSynth(INoteNagaSoftSynth *synth) {
     std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
     synths_.erase(std::remove(synths_.begin(), synths_.end(), synth), synths_.end());
+
+    // Sidechains keyed by the synth and of blocks in its chains
+    for (auto it = block_sidechains_.begin(); it != block_sidechains_.end();) {
+        it = it->second == synth ? block_sidechains_.erase(it) : std::next(it);
+    }
+    auto blocks = synth_dsp_blocks_.find(synth);
+    if (blocks != synth_dsp_blocks_.end()) eraseSidechains(blocks->second);
+    auto chains = synth_channel_dsp_blocks_.find(synth);
+    if (chains != synth_channel_dsp_blocks_.end()) {
+        for (const auto &[channel, chain] : chains->second) eraseSidechains(chain);
+    }
     
     // Also remove any DSP blocks for this synth
     synth_dsp_blocks_.erase(synth);
+    synth_channel_dsp_blocks_.erase(synth);
+    synth_voice_limits_.erase(synth);
+
+    // Budget of the removed synth goes to the others
+    publishRenderGraph();
+
+    // Sends and meters are referenced by the old graph until it was replaced
+    synth_aux_sends_.erase(synth);
+    synth_load_meters_.erase(synth);
 }
 
 void NoteNagaDSPEngine::addDSPBlock(NoteNagaDSPBlockBase *block) {
     std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    prepareBlock(block);
     dsp_blocks_.push_back(block);
+    publishRenderGraph();
 }
 
 void NoteNagaDSPEngine::removeDSPBlock(NoteNagaDSPBlockBase *block) {
     std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
     dsp_blocks_.erase(std::remove(dsp_blocks_.begin(), dsp_blocks_.end(), block),
                       dsp_blocks_.end());
+    block_sidechains_.erase(block);
+    publishRenderGraph();
 }
 
 void NoteNagaDSPEngine::reorderDSPBlock(int from_idx, int to_idx) {
@@ -153,11 +728,25 @@ void NoteNagaDSPEngine::reorderDSPBlock(int from_idx, int to_idx) {
     auto block = *it_from;
     dsp_blocks_.erase(it_from);
     dsp_blocks_.insert(dsp_blocks_.begin() + to_idx, block);
+    publishRenderGraph();
+}
+
+std::vector<NoteNagaDSPBlockBase*> NoteNagaDSPEngine::getDSPBlocks() const {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    return dsp_blocks_;
+}
+
+void NoteNagaDSPEngine::setDSPBlocks(const std::vector<NoteNagaDSPBlockBase*> &blocks) {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    replaceChain(dsp_blocks_, blocks);
+    publishRenderGraph();
 }
 
 void NoteNagaDSPEngine::addSynthDSPBlock(INoteNagaSoftSynth *synth, NoteNagaDSPBlockBase *block) {
     std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    prepareBlock(block);
     synth_dsp_blocks_[synth].push_back(block);
+    publishRenderGraph();
 }
 
 void NoteNagaDSPEngine::removeSynthDSPBlock(INoteNagaSoftSynth *synth, NoteNagaDSPBlockBase *block) {
@@ -166,6 +755,8 @@ void NoteNagaDSPEngine::removeSynthDSPBlock(INoteNagaSoftSynth *synth, NoteNagaD
     if (it != synth_dsp_blocks_.end()) {
         auto &blocks = it->second;
         blocks.erase(std::remove(blocks.begin(), blocks.end(), block), blocks.end());
+        block_sidechains_.erase(block);
+        publishRenderGraph();
     }
 }
 
@@ -183,9 +774,11 @@ void NoteNagaDSPEngine::reorderSynthDSPBlock(INoteNagaSoftSynth *synth, int from
     auto block = *it_from;
     blocks.erase(it_from);
     blocks.insert(blocks.begin() + to_idx, block);
+    publishRenderGraph();
 }
 
 std::vector<NoteNagaDSPBlockBase*> NoteNagaDSPEngine::getSynthDSPBlocks(INoteNagaSoftSynth *synth) const {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
     auto it = synth_dsp_blocks_.find(synth);
     if (it != synth_dsp_blocks_.end()) {
         return it->second;
@@ -193,23 +786,395 @@ std::vector<NoteNagaDSPBlockBase*> NoteNagaDSPEngine::getSynthDSPBlocks(INoteNag
     return {};
 }
 
+void NoteNagaDSPEngine::setSynthDSPBlocks(INoteNagaSoftSynth *synth, const std::vector<NoteNagaDSPBlockBase*> &blocks) {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    replaceChain(synth_dsp_blocks_[synth], blocks);
+    publishRenderGraph();
+}
+
+void NoteNagaDSPEngine::addSynthChannelDSPBlock(INoteNagaSoftSynth *synth, int channel,
+                                                NoteNagaDSPBlockBase *block) {
+    if (channel < 0 || channel >= int(MAX_SYNTH_OUTPUTS)) return;
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    prepareBlock(block);
+    synth_channel_dsp_blocks_[synth][channel].push_back(block);
+    publishRenderGraph();
+}
+
+void NoteNagaDSPEngine::removeSynthChannelDSPBlock(INoteNagaSoftSynth *synth, int channel,
+                                                   NoteNagaDSPBlockBase *block) {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    auto it = synth_channel_dsp_blocks_.find(synth);
+    if (it == synth_channel_dsp_blocks_.end()) return;
+    auto chain = it->second.find(channel);
+    if (chain == it->second.end()) return;
+
+    auto &blocks = chain->second;
+    blocks.erase(std::remove(blocks.begin(), blocks.end(), block), blocks.end());
+    if (blocks.empty()) it->second.erase(chain);
+    if (it->second.empty()) synth_channel_dsp_blocks_.erase(it);
+    block_sidechains_.erase(block);
+    publishRenderGraph();
+}
+
+void NoteNagaDSPEngine::reorderSynthChannelDSPBlock(INoteNagaSoftSynth *synth, int channel,
+                                                    int from_idx, int to_idx) {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    auto it = synth_channel_dsp_blocks_.find(synth);
+    if (it == synth_channel_dsp_blocks_.end()) return;
+    auto chain = it->second.find(channel);
+    if (chain == it->second.end()) return;
+
+    auto &blocks = chain->second;
+    if (from_idx < 0 || from_idx >= int(blocks.size()) || to_idx < 0 ||
+        to_idx >= int(blocks.size()) || from_idx == to_idx)
+        return;
+
+    auto it_from = blocks.begin() + from_idx;
+    auto block = *it_from;
+    blocks.erase(it_from);
+    blocks.insert(blocks.begin() + to_idx, block);
+    publishRenderGraph();
+}
+
+std::vector<NoteNagaDSPBlockBase*> NoteNagaDSPEngine::getSynthChannelDSPBlocks(INoteNagaSoftSynth *synth,
+                                                                              int channel) const {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    auto it = synth_channel_dsp_blocks_.find(synth);
+    if (it != synth_channel_dsp_blocks_.end()) {
+        auto chain = it->second.find(channel);
+        if (chain != it->second.end()) return chain->second;
+    }
+    return {};
+}
+
+int NoteNagaDSPEngine::addAuxBus(const std::string &name) {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    aux_buses_.push_back({name, {}, next_aux_bus_id_++});
+    publishRenderGraph();
+    return int(aux_buses_.size()) - 1;
+}
+
+void NoteNagaDSPEngine::removeAuxBus(int bus) {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    if (bus < 0 || bus >= int(aux_buses_.size())) return;
+    eraseSidechains(aux_buses_[size_t(bus)].blocks);
+    aux_buses_.erase(aux_buses_.begin() + bus);
+
+    // Drop sends to the bus and shift sends to the following buses
+    std::vector<std::unique_ptr<AuxSend>> removed;
+    for (auto &[synth, sends] : synth_aux_sends_) {
+        std::map<int, std::unique_ptr<AuxSend>> shifted;
+        for (auto &[idx, send] : sends) {
+            if (idx == bus) {
+                removed.push_back(std::move(send));
+            } else {
+                shifted[idx > bus ? idx - 1 : idx] = std::move(send);
+            }
+        }
+        sends = std::move(shifted);
+    }
+    publishRenderGraph();
+    // Removed sends are freed here, after the old graph is gone
+}
+
+int NoteNagaDSPEngine::getAuxBusCount() const {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    return int(aux_buses_.size());
+}
+
+std::string NoteNagaDSPEngine::getAuxBusName(int bus) const {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    if (bus < 0 || bus >= int(aux_buses_.size())) return {};
+    return aux_buses_[size_t(bus)].name;
+}
+
+void NoteNagaDSPEngine::addAuxBusDSPBlock(int bus, NoteNagaDSPBlockBase *block) {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    if (bus < 0 || bus >= int(aux_buses_.size())) return;
+    prepareBlock(block);
+    aux_buses_[size_t(bus)].blocks.push_back(block);
+    publishRenderGraph();
+}
+
+void NoteNagaDSPEngine::removeAuxBusDSPBlock(int bus, NoteNagaDSPBlockBase *block) {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    if (bus < 0 || bus >= int(aux_buses_.size())) return;
+    auto &blocks = aux_buses_[size_t(bus)].blocks;
+    blocks.erase(std::remove(blocks.begin(), blocks.end(), block), blocks.end());
+    block_sidechains_.erase(block);
+    publishRenderGraph();
+}
+
+void NoteNagaDSPEngine::reorderAuxBusDSPBlock(int bus, int from_idx, int to_idx) {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    if (bus < 0 || bus >= int(aux_buses_.size())) return;
+
+    auto &blocks = aux_buses_[size_t(bus)].blocks;
+    if (from_idx < 0 || from_idx >= int(blocks.size()) || to_idx < 0 ||
+        to_idx >= int(blocks.size()) || from_idx == to_idx)
+        return;
+
+    auto it_from = blocks.begin() + from_idx;
+    auto block = *it_from;
+    blocks.erase(it_from);
+    blocks.insert(blocks.begin() + to_idx, block);
+    publishRenderGraph();
+}
+
+std::vector<NoteNagaDSPBlockBase*> NoteNagaDSPEngine::getAuxBusDSPBlocks(int bus) const {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    if (bus < 0 || bus >= int(aux_buses_.size())) return {};
+    return aux_buses_[size_t(bus)].blocks;
+}
+
+void NoteNagaDSPEngine::setAuxBusDSPBlocks(int bus, const std::vector<NoteNagaDSPBlockBase*> &blocks) {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    if (bus < 0 || bus >= int(aux_buses_.size())) return;
+    replaceChain(aux_buses_[size_t(bus)].blocks, blocks);
+    publishRenderGraph();
+}
+
+void NoteNagaDSPEngine::setSynthAuxSend(INoteNagaSoftSynth *synth, int bus, float level) {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    if (bus < 0 || bus >= int(aux_buses_.size())) return;
+    level = std::clamp(level, 0.0f, 1.0f);
+
+    // Existing send only changes its level, a new one needs a new graph
+    std::unique_ptr<AuxSend> &send = synth_aux_sends_[synth][bus];
+    if (send) {
+        send->level.store(level, std::memory_order_relaxed);
+        return;
+    }
+    send = std::make_unique<AuxSend>();
+    send->level.store(level, std::memory_order_relaxed);
+    publishRenderGraph();
+}
+
+float NoteNagaDSPEngine::getSynthAuxSend(INoteNagaSoftSynth *synth, int bus) const {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    auto it = synth_aux_sends_.find(synth);
+    if (it == synth_aux_sends_.end()) return 0.0f;
+    auto send = it->second.find(bus);
+    return send != it->second.end() ? send->second->level.load(std::memory_order_relaxed) : 0.0f;
+}
+
+bool NoteNagaDSPEngine::setBlockSidechain(NoteNagaDSPBlockBase *block, INoteNagaSoftSynth *source) {
+    if (!block || (source && !block->supportsSidechain())) return false;
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    auto it = block_sidechains_.find(block);
+    INoteNagaSoftSynth *previous = it != block_sidechains_.end() ? it->second : nullptr;
+    if (previous == source) return true;
+
+    if (!source) {
+        block_sidechains_.erase(block);
+        publishRenderGraph();
+        return true;
+    }
+
+    // A source must not depend on the synth it keys
+    block_sidechains_[block] = source;
+    std::vector<std::vector<size_t>> waves;
+    std::vector<size_t> branch_waves;
+    if (!this->buildRenderWaves(waves, branch_waves)) {
+        if (previous) {
+            block_sidechains_[block] = previous;
+        } else {
+            block_sidechains_.erase(block);
+        }
+        NOTE_NAGA_LOG_WARNING("Sidechain of " + block->getBlockName() + " not set, it would create a routing loop");
+        return false;
+    }
+    publishRenderGraph();
+    return true;
+}
+
+INoteNagaSoftSynth *NoteNagaDSPEngine::getBlockSidechain(const NoteNagaDSPBlockBase *block) const {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    auto it = block_sidechains_.find(block);
+    return it != block_sidechains_.end() ? it->second : nullptr;
+}
+
+std::vector<INoteNagaSoftSynth*> NoteNagaDSPEngine::getAllSynths() const {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    return synths_;
+}
+
 void NoteNagaDSPEngine::setOutputVolume(float volume) {
     // Ensure volume is within [0.0, 1.0] range
-    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
-    this->output_volume_ = std::clamp(volume, 0.0f, 1.0f);
+    this->output_volume_.store(std::clamp(volume, 0.0f, 1.0f), std::memory_order_relaxed);
 }
 
 std::pair<float, float> NoteNagaDSPEngine::getCurrentVolumeDb() const {
-    return {last_rms_left_, last_rms_right_};
+    return {last_rms_left_.load(std::memory_order_relaxed), last_rms_right_.load(std::memory_order_relaxed)};
+}
+
+void NoteNagaDSPEngine::prepare(int sample_rate, size_t max_block_frames) {
+    if (sample_rate <= 0) return;
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+
+    // Blocks must not be processed while they are prepared, take the render slot
+    while (this->render_busy_.exchange(true, std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    const bool rate_changed = this->sample_rate_.exchange(sample_rate, std::memory_order_relaxed) != sample_rate;
+    this->max_block_frames_.store(std::clamp<size_t>(max_block_frames, 1, RENDER_BLOCK_FRAMES));
+
+    for (NoteNagaDSPBlockBase *block : dsp_blocks_) prepareBlock(block);
+    for (auto &[synth, blocks] : synth_dsp_blocks_) {
+        for (NoteNagaDSPBlockBase *block : blocks) prepareBlock(block);
+    }
+    for (auto &[synth, chains] : synth_channel_dsp_blocks_) {
+        for (auto &[channel, blocks] : chains) {
+            for (NoteNagaDSPBlockBase *block : blocks) prepareBlock(block);
+        }
+    }
+    for (AuxBus &bus : aux_buses_) {
+        for (NoteNagaDSPBlockBase *block : bus.blocks) prepareBlock(block);
+    }
+    // New rate recreates FluidSynth instances (SoundFont reload, voices lost), block size changes keep them
+    if (rate_changed) {
+        for (INoteNagaSoftSynth *synth : synths_) synth->setSampleRate(sample_rate);
+    }
+    if (this->metronome_) this->metronome_->setSampleRate(unsigned(sample_rate));
+
+    this->render_busy_.store(false, std::memory_order_release);
+    NOTE_NAGA_LOG_INFO("DSP Engine prepared for " + std::to_string(sample_rate) + " Hz, " +
+                       std::to_string(this->getMaxBlockFrames()) + " frames");
+}
+
+void NoteNagaDSPEngine::setSampleRate(int sample_rate) {
+    this->prepare(sample_rate, this->getMaxBlockFrames());
+}
+
+void NoteNagaDSPEngine::prepareBlock(NoteNagaDSPBlockBase *block) {
+    block->prepare(float(this->sample_rate_.load(std::memory_order_relaxed)), this->getMaxBlockFrames());
+    block->getSleepState() = NN_DSPSleepState_t();
+}
+
+void NoteNagaDSPEngine::setSynthVoiceLimit(INoteNagaSoftSynth *synth, size_t max_voices) {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    if (max_voices > 0) {
+        synth_voice_limits_[synth] = max_voices;
+    } else {
+        synth_voice_limits_.erase(synth);
+    }
+    publishRenderGraph();
+}
+
+size_t NoteNagaDSPEngine::getSynthVoiceLimit(INoteNagaSoftSynth *synth) const {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    auto it = synth_voice_limits_.find(synth);
+    return it != synth_voice_limits_.end() ? it->second : 0;
+}
+
+void NoteNagaDSPEngine::setGlobalVoiceLimit(size_t max_voices) {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    this->global_voice_limit_ = max_voices;
+    publishRenderGraph();
+}
+
+void NoteNagaDSPEngine::setVoiceStealPolicy(NN_VoiceStealPolicy_t policy) {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    this->voice_steal_policy_ = policy;
+    for (INoteNagaSoftSynth *synth : this->synths_) {
+        synth->setVoiceStealPolicy(policy);
+    }
+}
+
+void NoteNagaDSPEngine::setVoiceGuardEnabled(bool enable) {
+    this->voice_guard_enabled_.store(enable, std::memory_order_relaxed);
+    if (!enable) {
+        // Full polyphony without the guard, applied by the next rendered block
+        this->voice_guard_scale_.store(1.0f, std::memory_order_relaxed);
+    }
+}
+
+size_t NoteNagaDSPEngine::getOutputLatencySamples() const {
+    // The published graph is only replaced with the mutex held, so it stays alive here
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    const RenderGraph *graph = this->render_graph_.load();
+    bool dsp = this->enable_dsp_.load(std::memory_order_relaxed);
+    if (!graph || !dsp) return 0;
+
+    size_t branch_latency = 0;
+    for (const RenderBranch &branch : graph->branches) {
+        branch_latency = std::max(branch_latency, branchLatency(branch, dsp));
+    }
+    size_t bus_latency = 0;
+    for (const RenderAuxBus &bus : graph->aux_buses) {
+        bus_latency = std::max(bus_latency, chainLatency(bus.blocks));
+    }
+    return branch_latency + bus_latency + chainLatency(graph->master_blocks);
+}
+
+double NoteNagaDSPEngine::getOutputLatencySeconds() const {
+    int sample_rate = this->sample_rate_.load(std::memory_order_relaxed);
+    return sample_rate > 0 ? double(getOutputLatencySamples()) / double(sample_rate) : 0.0;
+}
+
+void NoteNagaDSPEngine::setProfilingEnabled(bool enable) {
+    this->profiling_enabled_.store(enable, std::memory_order_relaxed);
+}
+
+NN_DSPLoad_t NoteNagaDSPEngine::getBlockLoad(const NoteNagaDSPBlockBase *block) const {
+    return block ? block->getLoadMeter().get() : NN_DSPLoad_t();
+}
+
+NN_DSPLoad_t NoteNagaDSPEngine::getSynthLoad(INoteNagaSoftSynth *synth) const {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    auto it = synth_load_meters_.find(synth);
+    return it != synth_load_meters_.end() ? it->second->get() : NN_DSPLoad_t();
+}
+
+NN_SynthVoiceStats_t NoteNagaDSPEngine::getSynthVoiceStats(INoteNagaSoftSynth *synth) const {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    if (std::find(synths_.begin(), synths_.end(), synth) == synths_.end()) return {};
+    return synth->getVoiceStats();
+}
+
+NN_SynthVoiceStats_t NoteNagaDSPEngine::getTotalVoiceStats() const {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    NN_SynthVoiceStats_t total;
+    for (INoteNagaSoftSynth *synth : this->synths_) {
+        NN_SynthVoiceStats_t stats = synth->getVoiceStats();
+        total.active_voices += stats.active_voices;
+        total.max_voices += stats.max_voices;
+        total.stolen_voices += stats.stolen_voices;
+        total.dropped_notes += stats.dropped_notes;
+    }
+    return total;
+}
+
+void NoteNagaDSPEngine::applyVoiceLimits(RenderGraph &graph) {
+    float scale = this->voice_guard_scale_.load(std::memory_order_relaxed);
+    for (RenderBranch &branch : graph.branches) {
+        size_t limit = std::max<size_t>(1, size_t(float(branch.voice_budget) * scale));
+        if (limit != branch.applied_voice_limit) {
+            branch.synth->setVoiceLimit(limit);
+            branch.applied_voice_limit = limit;
+        }
+    }
+}
+
+void NoteNagaDSPEngine::updateVoiceGuard(float load) {
+    float scale = this->voice_guard_scale_.load(std::memory_order_relaxed);
+    float new_scale = scale;
+    if (load > GUARD_HIGH_LOAD) {
+        new_scale = std::max(GUARD_MIN_SCALE, scale * GUARD_DECREASE);
+    } else if (load < GUARD_LOW_LOAD && scale < 1.0f) {
+        new_scale = std::min(1.0f, scale * GUARD_INCREASE);
+    }
+
+    // New limits are applied at the start of the next block
+    if (new_scale != scale) this->voice_guard_scale_.store(new_scale, std::memory_order_relaxed);
 }
 
 void NoteNagaDSPEngine::calculateRMS(float *left, float *right, size_t numFrames) {
     // Výpočet RMS pro left/right
-    double sum_left = 0.0, sum_right = 0.0;
-    for (size_t i = 0; i < numFrames; ++i) {
-        sum_left += left[i] * left[i];
-        sum_right += right[i] * right[i];
-    }
+    double sum_left = nn_vec_sum_squares(left, numFrames);
+    double sum_right = nn_vec_sum_squares(right, numFrames);
     float rms_left = sqrt(sum_left / numFrames);
     float rms_right = sqrt(sum_right / numFrames);
 
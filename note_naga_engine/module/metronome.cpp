@@ -1,5 +1,7 @@
 #include <note_naga_engine/module/metronome.h>
 
+#include <note_naga_engine/core/dsp_fast_math.h>
+
 #include <deque>
 #include <cmath>
 #include <cstring>
@@ -14,8 +16,8 @@ inline float metronomeTickSample(bool accent, int sampleIdx, int tickLen, int sa
     const float freq = accent ? 3500.0f : 2200.0f;
     const float amp  = accent ? 1.0f : 0.7f;
     // 1 ms tick při 44.1kHz = ~44 sample, 2ms = 88 sample
-    const float env = amp * std::exp(-8.0f * float(sampleIdx) / float(tickLen));
-    return env * std::sin(2.0f * M_PI * freq * float(sampleIdx) / float(sampleRate));
+    const float env = amp * nn_fast_exp(-8.0f * float(sampleIdx) / float(tickLen));
+    return env * nn_fast_sin_turns(freq * float(sampleIdx) / float(sampleRate));
 }
 
 
@@ -7,7 +7,8 @@
 NoteNagaSpectrumAnalyzer::NoteNagaSpectrumAnalyzer(size_t fft_size, ChannelMode mode)
     : fft_size_(fft_size), fft_current_pos_left_(0), fft_current_pos_right_(0),
       samples_buffer_left_(fft_size, 0.0f), samples_buffer_right_(fft_size, 0.0f),
-      spectrum_(fft_size / 2, 0.0f), channel_mode_(mode) {
+      spectrum_(fft_size / 2, 0.0f), channel_mode_(mode), fft_(fft_size, NN_FFTWindow_t::Hann),
+      working_buffer_(fft_.getSize(), 0.0f), magnitudes_(fft_.getNumBins(), 0.0f) {
     this->enable_ = false; 
     // Reset all buffers to zero
     std::fill(samples_buffer_left_.begin(), samples_buffer_left_.end(), 0.0f);
@@ -57,52 +58,33 @@ void NoteNagaSpectrumAnalyzer::onItem(const NN_AsyncTriggerMessage_t &) {
 }
 
 void NoteNagaSpectrumAnalyzer::processSampleBuffer() {
-    std::vector<float> working_buffer(fft_size_, 0.0f);
+    float *working = working_buffer_.data();
 
     if (channel_mode_ == ChannelMode::Left) {
-        std::copy(samples_buffer_left_.begin(), samples_buffer_left_.end(), working_buffer.begin());
+        std::copy(samples_buffer_left_.begin(), samples_buffer_left_.end(), working);
     } else if (channel_mode_ == ChannelMode::Right) {
-        std::copy(samples_buffer_right_.begin(), samples_buffer_right_.end(), working_buffer.begin());
+        std::copy(samples_buffer_right_.begin(), samples_buffer_right_.end(), working);
     } else if (channel_mode_ == ChannelMode::Merged) {
         for (size_t i = 0; i < fft_size_; ++i)
-            working_buffer[i] = 0.5f * (samples_buffer_left_[i] + samples_buffer_right_[i]);
+            working[i] = 0.5f * (samples_buffer_left_[i] + samples_buffer_right_[i]);
     }
 
     // DC offset removal
-    float mean = std::accumulate(working_buffer.begin(), working_buffer.end(), 0.0f) /
-                 float(working_buffer.size());
-    for (size_t i = 0; i < working_buffer.size(); ++i)
-        working_buffer[i] -= mean;
-
-    // Hann window
-    for (size_t i = 0; i < working_buffer.size(); ++i)
-        working_buffer[i] *=
-            0.5f * (1.0f - std::cos(2.0f * M_PI * i / (working_buffer.size() - 1)));
-
-    // FFT
-    std::vector<std::complex<float>> fft_in(fft_size_);
+    float mean = std::accumulate(working, working + fft_size_, 0.0f) / float(fft_size_);
     for (size_t i = 0; i < fft_size_; ++i)
-        fft_in[i] = std::complex<float>(working_buffer[i], 0.0f);
+        working[i] -= mean;
 
-    nn_fft(fft_in);
-
-    // Magnitude spectrum
-    std::vector<float> mag(fft_size_ / 2, 0.0f);
-    for (size_t k = 1; k < fft_size_ / 2; ++k)
-        mag[k] = std::abs(fft_in[k]);
+    // Magnitude spectrum of the Hann windowed buffer (window table of the FFT plan)
+    fft_.magnitudes(working, magnitudes_.data());
 
     // THRESHOLD: pokud je maxMag menší než 1e-5, považuj za ticho!
-    float maxMag = *std::max_element(mag.begin() + 1, mag.end()); // ignoruj DC
+    const size_t bins = fft_size_ / 2;
+    float maxMag = *std::max_element(magnitudes_.begin() + 1, magnitudes_.begin() + bins); // ignoruj DC
     const float noiseFloor = 1e-5f;
-    if (maxMag > noiseFloor) {
-        for (size_t k = 1; k < mag.size(); ++k)
-            mag[k] /= maxMag;
-    } else {
-        for (size_t k = 1; k < mag.size(); ++k)
-            mag[k] = 0.0f;
-    }
-    mag[0] = 0.0f;
+    const float gain = maxMag > noiseFloor ? 1.0f / maxMag : 0.0f;
 
     std::lock_guard<std::mutex> lock(this->spectrum_mutex_);
-    spectrum_ = mag;
+    spectrum_[0] = 0.0f;
+    for (size_t k = 1; k < bins; ++k)
+        spectrum_[k] = magnitudes_[k] * gain;
 }
@@ -5,6 +5,12 @@
 #include <note_naga_engine/synth/synth_fluidsynth.h>
 #include <note_naga_engine/core/soundfont_finder.h>
 
+#include <algorithm>
+
+// Audio output format used until setAudioFormat is called
+static constexpr unsigned int DEFAULT_SAMPLE_RATE = 44100;
+static constexpr unsigned int DEFAULT_BLOCK_SIZE = 512;
+
 NoteNagaEngine::NoteNagaEngine()
 #ifndef QT_DEACTIVATED
     : QObject(nullptr)
@@ -83,7 +89,6 @@ bool NoteNagaEngine::initialize() {
     // Initialize metronome
     if (!this->metronome) {
         this->metronome = new NoteNagaMetronome();
-        this->metronome->setSampleRate(44100);
         this->metronome->setProject(this->project);
     }
 
@@ -115,8 +120,9 @@ bool NoteNagaEngine::initialize() {
 
     // audio worker
     if (!this->audio_worker) { 
+        // Starting the stream prepares the DSP engine for its format
         this->audio_worker = new NoteNagaAudioWorker(this->dsp_engine);
-        this->audio_worker->start(44100, 512);
+        this->audio_worker->start(DEFAULT_SAMPLE_RATE, DEFAULT_BLOCK_SIZE);
     }
 
     bool status = this->project && this->mixer && this->playback_worker &&
@@ -185,6 +191,17 @@ void NoteNagaEngine::stopSingleNote(const NN_Note_t &midi_note) {
     }
 }
 
+int NoteNagaEngine::getAudibleTick() const {
+    if (!this->project) return 0;
+    int tick = this->project->getCurrentTick();
+    if (!isPlaying() || !this->dsp_engine) return tick;
+
+    double latency = this->dsp_engine->getOutputLatencySeconds();
+    if (latency <= 0.0) return tick;
+    int lag = int(nn_seconds_to_ticks(latency, this->project->getPPQ(), this->project->getTempo()));
+    return std::max(0, tick - lag);
+}
+
 void NoteNagaEngine::setPlaybackPosition(int tick) {
     if (playback_worker && playback_worker->isPlaying()) { playback_worker->stop(); }
     if (this->project) {
@@ -282,4 +299,10 @@ std::pair<float, float> NoteNagaEngine::getCurrentVolumeDb() {
         return dsp_engine->getCurrentVolumeDb();
     }
     return {-100.0f, -100.0f};
+}
+
+bool NoteNagaEngine::setAudioFormat(unsigned int sample_rate, unsigned int block_size) {
+    if (!this->audio_worker || sample_rate == 0 || block_size == 0) return false;
+    this->audio_worker->stop();
+    return this->audio_worker->start(sample_rate, block_size);
 }
\ No newline at end of file
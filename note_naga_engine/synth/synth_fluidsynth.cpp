@@ -1,15 +1,21 @@
 #include <note_naga_engine/synth/synth_fluidsynth.h>
 
+#include <note_naga_engine/core/dsp_vector_math.h>
 #include <note_naga_engine/logger.h>
 
+#include <algorithm>
+
+// Number of per-channel outputs in multi-output mode (one per MIDI channel)
+static constexpr size_t MULTI_OUTPUT_CHANNELS = 16;
+// Initial size of the per-group mixdown buffers (covers common audio block sizes)
+static constexpr size_t DEFAULT_GROUP_FRAMES = 2048;
+
 NoteNagaSynthFluidSynth::NoteNagaSynthFluidSynth(const std::string &name,
                                                  const std::string &sf2_path)
     : NoteNagaSynthesizer(name), synth_settings_(nullptr), fluidsynth_(nullptr),
       sf2_path_(sf2_path) {
   // Initialize FluidSynth settings and synth
-  synth_settings_ = new_fluid_settings();
-  fluidsynth_ = new_fluid_synth(synth_settings_);
-  int sfid = fluid_synth_sfload(fluidsynth_, sf2_path.c_str(), 1);
+  int sfid = createFluidsynth();
   // fluid_synth_set_reverb_on(fluidsynth_, 1);
   // fluid_synth_set_reverb(fluidsynth_, 0.8f, 0.5f, 0.9f, 0.3f);
 
@@ -37,10 +43,68 @@ NoteNagaSynthFluidSynth::~NoteNagaSynthFluidSynth() {
 void NoteNagaSynthFluidSynth::renderAudio(float *left, float *right,
                                           size_t num_frames) {
   std::lock_guard<std::mutex> lock(synth_mutex_);
+  applyVoiceLimit();
 
   // render audio using FluidSynth
-  fluid_synth_write_float(this->fluidsynth_, num_frames, left, 0, 1, right, 0,
-                          1);
+  renderMixdown(left, right, num_frames);
+  updateVoiceStats();
+}
+
+void NoteNagaSynthFluidSynth::renderMixdown(float *left, float *right,
+                                            size_t num_frames) {
+  if (!multi_output_) {
+    fluid_synth_write_float(this->fluidsynth_, num_frames, left, 0, 1, right,
+                            0, 1);
+    return;
+  }
+
+  // fluid_synth_write_float outputs audio group 0 only, render all groups
+  // (= MIDI channels) and sum them. Buffers grow only for unexpectedly large
+  // blocks.
+  if (group_frames_ < num_frames)
+    allocateGroupBuffers(num_frames);
+  fluid_synth_nwrite_float(this->fluidsynth_, num_frames, group_left_.data(),
+                           group_right_.data(), nullptr, nullptr);
+
+  std::copy(group_left_[0], group_left_[0] + num_frames, left);
+  std::copy(group_right_[0], group_right_[0] + num_frames, right);
+  for (size_t g = 1; g < MULTI_OUTPUT_CHANNELS; ++g) {
+    nn_vec_add(left, group_left_[g], num_frames);
+    nn_vec_add(right, group_right_[g], num_frames);
+  }
+}
+
+void NoteNagaSynthFluidSynth::allocateGroupBuffers(size_t num_frames) {
+  group_frames_ = num_frames;
+  group_buffer_.assign(2 * MULTI_OUTPUT_CHANNELS * num_frames, 0.0f);
+  group_left_.resize(MULTI_OUTPUT_CHANNELS);
+  group_right_.resize(MULTI_OUTPUT_CHANNELS);
+  for (size_t g = 0; g < MULTI_OUTPUT_CHANNELS; ++g) {
+    group_left_[g] = group_buffer_.data() + (2 * g) * num_frames;
+    group_right_[g] = group_buffer_.data() + (2 * g + 1) * num_frames;
+  }
+}
+
+size_t NoteNagaSynthFluidSynth::getAudioOutputCount() const {
+  return multi_output_.load() ? MULTI_OUTPUT_CHANNELS : 1;
+}
+
+void NoteNagaSynthFluidSynth::renderAudioOutputs(float **left, float **right,
+                                                 size_t num_outputs,
+                                                 size_t num_frames) {
+  std::lock_guard<std::mutex> lock(synth_mutex_);
+  applyVoiceLimit();
+
+  if (!multi_output_ || num_outputs < MULTI_OUTPUT_CHANNELS) {
+    // Mixed output only
+    if (num_outputs > 0)
+      renderMixdown(left[0], right[0], num_frames);
+  } else {
+    // One stereo buffer per audio group (= MIDI channel), effects are disabled
+    fluid_synth_nwrite_float(this->fluidsynth_, num_frames, left, right,
+                             nullptr, nullptr);
+  }
+  updateVoiceStats();
 }
 
 void NoteNagaSynthFluidSynth::playNote(const NN_Note_t &note, int channel,
@@ -74,6 +138,12 @@ void NoteNagaSynthFluidSynth::playNote(const NN_Note_t &note, int channel,
     return;
   }
 
+  // All voices busy, FluidSynth steals one for the new note
+  if (fluid_synth_get_active_voice_count(fluidsynth_) >=
+      fluid_synth_get_polyphony(fluidsynth_)) {
+    stolen_voices_.fetch_add(1, std::memory_order_relaxed);
+  }
+
   // play note
   fluid_synth_noteon(fluidsynth_, channel, note.note,
                      note.velocity.value_or(100));
@@ -82,6 +152,36 @@ void NoteNagaSynthFluidSynth::playNote(const NN_Note_t &note, int channel,
   playing_notes_[track][note.id] = PlayedNote_t{note, channel};
 }
 
+void NoteNagaSynthFluidSynth::setVoiceLimit(size_t max_voices) {
+  // Applied by the next render under synth_mutex_, the instance may be recreated
+  // by another thread at any time
+  voice_limit_.store(std::max<size_t>(max_voices, 1));
+}
+
+void NoteNagaSynthFluidSynth::applyVoiceLimit() {
+  size_t limit = voice_limit_.load();
+  if (limit == 0 || limit == applied_voice_limit_)
+    return;
+  fluid_synth_set_polyphony(fluidsynth_, int(limit));
+  applied_voice_limit_ = limit;
+}
+
+void NoteNagaSynthFluidSynth::updateVoiceStats() {
+  active_voices_.store(size_t(fluid_synth_get_active_voice_count(fluidsynth_)),
+                       std::memory_order_relaxed);
+  max_voices_.store(size_t(fluid_synth_get_polyphony(fluidsynth_)),
+                    std::memory_order_relaxed);
+}
+
+NN_SynthVoiceStats_t NoteNagaSynthFluidSynth::getVoiceStats() const {
+  // Values of the last render, the instance is not touched here
+  NN_SynthVoiceStats_t stats;
+  stats.active_voices = active_voices_.load(std::memory_order_relaxed);
+  stats.max_voices = max_voices_.load(std::memory_order_relaxed);
+  stats.stolen_voices = stolen_voices_.load(std::memory_order_relaxed);
+  return stats;
+}
+
 void NoteNagaSynthFluidSynth::stopNote(const NN_Note_t &note) {
   NoteNagaTrack *track = note.parent;
   if (!track)
@@ -125,6 +225,9 @@ std::string NoteNagaSynthFluidSynth::getConfig(const std::string &key) const {
   if (key == "soundfont") {
     return sf2_path_;
   }
+  if (key == "multi_output") {
+    return multi_output_.load() ? "true" : "false";
+  }
   return "";
 }
 
@@ -136,12 +239,16 @@ bool NoteNagaSynthFluidSynth::setConfig(const std::string &key,
     NN_QT_EMIT(synthUpdated(this));
     return setSoundFont(value);
   }
+  if (key == "multi_output") {
+    NN_QT_EMIT(synthUpdated(this));
+    return setMultiOutput(value == "true" || value == "1");
+  }
   return false;
 }
 
 std::vector<std::string>
 NoteNagaSynthFluidSynth::getSupportedConfigKeys() const {
-  return {"soundfont"};
+  return {"soundfont", "multi_output"};
 }
 
 bool NoteNagaSynthFluidSynth::setSoundFont(const std::string &sf2_path) {
@@ -152,30 +259,93 @@ bool NoteNagaSynthFluidSynth::setSoundFont(const std::string &sf2_path) {
   sf2_path_ = sf2_path;
 
   // Reload FluidSynth with new SoundFont
+  int sfid = createFluidsynth();
+
+  // Reset channel programs and pans
+  for (int i = 0; i < 16; ++i) {
+    channel_programs_[i] = -1;
+    channel_pan_[i] = 0.0f;
+  }
+
+  NOTE_NAGA_LOG_INFO("FluidSynth reloaded with soundfont: " + sf2_path +
+                     ", sfid=" + std::to_string(sfid));
+
+  return sfid >= 0; // Return true if loading was successful
+}
+
+bool NoteNagaSynthFluidSynth::setMultiOutput(bool enabled) {
+  // Called by setConfig under synth_mutex_, the instance is recreated below
+  if (multi_output_.load() == enabled)
+    return true;
+
+  // Stop all notes, voices are lost when the synth is recreated
+  stopAllNotes();
+  multi_output_.store(enabled);
+
+  int sfid = createFluidsynth();
+
+  // Programs and pans must be sent again to the new instance
+  for (int i = 0; i < 16; ++i) {
+    channel_programs_[i] = -1;
+    channel_pan_[i] = 0.0f;
+  }
+
+  NOTE_NAGA_LOG_INFO(std::string("FluidSynth multi-output ") +
+                     (enabled ? "enabled" : "disabled"));
+  return sfid >= 0;
+}
+
+void NoteNagaSynthFluidSynth::setSampleRate(int sample_rate) {
+  std::lock_guard<std::mutex> lock(synth_mutex_);
+  if (sample_rate <= 0 || sample_rate == sample_rate_)
+    return;
+
+  // The sample rate is fixed per FluidSynth instance, voices are lost
+  stopAllNotes();
+  sample_rate_ = sample_rate;
+  int sfid = createFluidsynth();
+
+  // Programs and pans must be sent again to the new instance
+  for (int i = 0; i < 16; ++i) {
+    channel_programs_[i] = -1;
+    channel_pan_[i] = 0.0f;
+  }
+
+  NOTE_NAGA_LOG_INFO("FluidSynth sample rate set to " +
+                     std::to_string(sample_rate) + " Hz, sfid=" + std::to_string(sfid));
+}
+
+int NoteNagaSynthFluidSynth::createFluidsynth() {
   if (fluidsynth_) {
     delete_fluid_synth(fluidsynth_);
     fluidsynth_ = nullptr;
   }
-
   if (synth_settings_) {
     delete_fluid_settings(synth_settings_);
     synth_settings_ = nullptr;
   }
 
-  // Reinitialize with new SoundFont
   synth_settings_ = new_fluid_settings();
-  fluidsynth_ = new_fluid_synth(synth_settings_);
-
-  int sfid = fluid_synth_sfload(fluidsynth_, sf2_path.c_str(), 1);
-
-  // Reset channel programs and pans
-  for (int i = 0; i < 16; ++i) {
-    channel_programs_[i] = -1;
-    channel_pan_[i] = 0.0f;
+  fluid_settings_setnum(synth_settings_, "synth.sample-rate", double(sample_rate_));
+  if (multi_output_) {
+    // audio channel N = audio group N = MIDI channel N
+    fluid_settings_setint(synth_settings_, "synth.audio-channels",
+                          MULTI_OUTPUT_CHANNELS);
+    fluid_settings_setint(synth_settings_, "synth.audio-groups",
+                          MULTI_OUTPUT_CHANNELS);
+    fluid_settings_setint(synth_settings_, "synth.reverb.active", 0);
+    fluid_settings_setint(synth_settings_, "synth.chorus.active", 0);
   }
+  fluidsynth_ = new_fluid_synth(synth_settings_);
+  if (multi_output_ && group_frames_ == 0)
+    allocateGroupBuffers(DEFAULT_GROUP_FRAMES);
 
-  NOTE_NAGA_LOG_INFO("FluidSynth reloaded with soundfont: " + sf2_path +
-                     ", sfid=" + std::to_string(sfid));
+  // Keep the voice limit of the previous instance
+  applied_voice_limit_ = 0;
+  applyVoiceLimit();
+  updateVoiceStats();
 
-  return sfid >= 0; // Return true if loading was successful
-}
\ No newline at end of file
+  if (sf2_path_.empty())
+    return FLUID_FAILED;
+  return fluid_synth_sfload(fluidsynth_, sf2_path_.c_str(), 1);
+}
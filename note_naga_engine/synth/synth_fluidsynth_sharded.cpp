@@ -0,0 +1,402 @@
+#include <note_naga_engine/synth/synth_fluidsynth_sharded.h>
+
+#include <note_naga_engine/logger.h>
+
+#include <algorithm>
+#include <thread>
+
+// Maximum number of shards (one per MIDI channel)
+static constexpr size_t MAX_SHARDS = 16;
+// Default number of shards when it is derived from CPU core count
+static constexpr size_t DEFAULT_MAX_SHARDS = 4;
+// Initial size of per-shard render buffers (covers common audio block sizes)
+static constexpr size_t DEFAULT_SHARD_FRAMES = 2048;
+
+NoteNagaSynthFluidSynthSharded::NoteNagaSynthFluidSynthSharded(
+    const std::string &name, const std::string &sf2_path, size_t num_shards)
+    : NoteNagaSynthesizer(name), sf2_path_(sf2_path) {
+  createShards(num_shards);
+
+  // Initialize all channels with no program and no pan set
+  for (int i = 0; i < 16; ++i) {
+    channel_programs_[i] = -1;
+    channel_pan_[i] = 0.0f;
+  }
+
+  NOTE_NAGA_LOG_INFO("Sharded FluidSynth initialized with " +
+                     std::to_string(shards_.size()) + " shards");
+}
+
+NoteNagaSynthFluidSynthSharded::~NoteNagaSynthFluidSynthSharded() {
+  std::unique_lock<std::shared_mutex> lock(synth_mutex_);
+  destroyShards();
+}
+
+void NoteNagaSynthFluidSynthSharded::renderShard(FluidShard &shard,
+                                                 size_t num_frames) {
+  // Shard buffers are preallocated, grow only for unexpectedly large blocks
+  if (shard.left.size() < num_frames) shard.left.resize(num_frames, 0.0f);
+  if (shard.right.size() < num_frames) shard.right.resize(num_frames, 0.0f);
+  fluid_synth_write_float(shard.synth, int(num_frames), shard.left.data(), 0,
+                          1, shard.right.data(), 0, 1);
+}
+
+size_t NoteNagaSynthFluidSynthSharded::getRenderPartCount() const {
+  size_t count = shard_count_.load(std::memory_order_relaxed);
+  return count > 1 ? count : 0;
+}
+
+void NoteNagaSynthFluidSynthSharded::renderPart(size_t part,
+                                                size_t num_frames) {
+  // Parts run in parallel, every one touches only its own shard
+  std::shared_lock<std::shared_mutex> lock(synth_mutex_);
+  if (part >= shards_.size())
+    return;
+  renderShard(shards_[part], num_frames);
+  shards_[part].rendered_frames = num_frames;
+}
+
+void NoteNagaSynthFluidSynthSharded::renderAudio(float *left, float *right,
+                                                 size_t num_frames) {
+  std::shared_lock<std::shared_mutex> lock(synth_mutex_);
+  if (shards_.empty())
+    return;
+  if (voice_limit_.load() != applied_voice_limit_)
+    applyVoiceLimit();
+
+  // Shards not pre-rendered by the DSP engine (see renderPart) are rendered here
+  for (FluidShard &shard : shards_) {
+    if (shard.rendered_frames != num_frames)
+      renderShard(shard, num_frames);
+    shard.rendered_frames = 0;
+  }
+
+  // Sum shards in fixed order (deterministic result)
+  const FluidShard &first = shards_[0];
+  std::copy(first.left.begin(), first.left.begin() + num_frames, left);
+  std::copy(first.right.begin(), first.right.begin() + num_frames, right);
+  for (size_t s = 1; s < shards_.size(); ++s) {
+    const float *shard_left = shards_[s].left.data();
+    const float *shard_right = shards_[s].right.data();
+    for (size_t i = 0; i < num_frames; ++i) {
+      left[i] += shard_left[i];
+      right[i] += shard_right[i];
+    }
+  }
+  updateVoiceStats();
+}
+
+void NoteNagaSynthFluidSynthSharded::playNote(const NN_Note_t &note,
+                                              int channel, float pan) {
+  if (!note.velocity.has_value() || note.velocity.value() <= 0)
+    return;
+
+  NoteNagaTrack *track = note.parent;
+  if (!track)
+    return;
+
+  // Shards stay alive while the note starts, renders keep running in parallel
+  std::shared_lock<std::shared_mutex> lock(synth_mutex_);
+  std::lock_guard<std::mutex> notes_lock(notes_mutex_);
+  if (shards_.empty())
+    return;
+  fluid_synth_t *synth = shardForChannel(channel);
+
+  // get program for the track (parent of note)
+  int prog = track->getInstrument().value_or(0);
+
+  // Set program change if needed
+  if (channel_programs_[channel] != prog) {
+    fluid_synth_program_change(synth, channel, prog);
+    channel_programs_[channel] = prog;
+  }
+
+  // Set pan if needed
+  if (std::abs(channel_pan_[channel] - pan) > 0.01f) {
+    int midiPan = static_cast<int>(std::round(pan * 63.5 + 63.5));
+    fluid_synth_cc(synth, channel, 10,
+                   static_cast<int>(std::clamp(midiPan, 0, 127)));
+    channel_pan_[channel] = pan;
+  }
+
+  // Check if note is already playing
+  if (playing_notes_[track].find(note.id) != playing_notes_[track].end()) {
+    return;
+  }
+
+  // No voice left in the shared limit, FluidSynth cannot go below one voice per shard
+  if (!balanceVoices(synth)) {
+    dropped_notes_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  // All voices of the shard busy, FluidSynth steals one for the new note
+  if (fluid_synth_get_active_voice_count(synth) >=
+      fluid_synth_get_polyphony(synth)) {
+    stolen_voices_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // play note
+  fluid_synth_noteon(synth, channel, note.note, note.velocity.value_or(100));
+
+  // Store the note in playing_notes_ for later stop
+  playing_notes_[track][note.id] = PlayedNote_t{note, channel};
+}
+
+void NoteNagaSynthFluidSynthSharded::stopNote(const NN_Note_t &note) {
+  NoteNagaTrack *track = note.parent;
+  if (!track)
+    return;
+
+  std::shared_lock<std::shared_mutex> lock(synth_mutex_);
+  std::lock_guard<std::mutex> notes_lock(notes_mutex_);
+  if (shards_.empty())
+    return;
+
+  // find note in playing notes by ID
+  TrackNotesMap &playingTrackNotes = playing_notes_[track];
+  auto it = playingTrackNotes.find(note.id);
+
+  // retrieve note parameters and stop it on the shard that plays it
+  if (it != playingTrackNotes.end()) {
+    const PlayedNote_t &pn = it->second;
+    fluid_synth_noteoff(shardForChannel(pn.channel), pn.channel, pn.note.note);
+    playingTrackNotes.erase(it);
+  }
+}
+
+void NoteNagaSynthFluidSynthSharded::stopAllNotes(NoteNagaMidiSeq *seq,
+                                                  NoteNagaTrack *track) {
+  std::shared_lock<std::shared_mutex> lock(synth_mutex_);
+  std::lock_guard<std::mutex> notes_lock(notes_mutex_);
+  if (shards_.empty())
+    return;
+  stopAllNotesLocked(seq, track);
+}
+
+void NoteNagaSynthFluidSynthSharded::stopAllNotesLocked(NoteNagaMidiSeq *seq,
+                                                        NoteNagaTrack *track) {
+  if (track) {
+    for (const auto &[id, pn] : playing_notes_[track]) {
+      fluid_synth_noteoff(shardForChannel(pn.channel), pn.channel,
+                          pn.note.note);
+    }
+    playing_notes_[track].clear();
+  } else if (seq) {
+    for (auto &tr : seq->getTracks()) {
+      if (tr)
+        stopAllNotesLocked(nullptr, tr);
+    }
+  } else {
+    for (auto &[track, notes] : playing_notes_) {
+      for (const auto &[id, pn] : notes) {
+        fluid_synth_noteoff(shardForChannel(pn.channel), pn.channel,
+                            pn.note.note);
+      }
+      notes.clear();
+    }
+  }
+}
+
+void NoteNagaSynthFluidSynthSharded::setVoiceLimit(size_t max_voices) {
+  // Applied by the next render under synth_mutex_, the shards may be recreated
+  // by another thread at any time
+  voice_limit_.store(std::max<size_t>(max_voices, 1));
+}
+
+void NoteNagaSynthFluidSynthSharded::applyVoiceLimit() {
+  // Every shard may use the whole budget, balanceVoices() keeps the total
+  size_t limit = voice_limit_.load();
+  applied_voice_limit_ = limit;
+  if (limit == 0)
+    return;
+  for (FluidShard &shard : shards_) {
+    fluid_synth_set_polyphony(shard.synth, int(limit));
+  }
+}
+
+void NoteNagaSynthFluidSynthSharded::updateVoiceStats() {
+  size_t active = 0, max_voices = 0;
+  for (const FluidShard &shard : shards_) {
+    active += size_t(fluid_synth_get_active_voice_count(shard.synth));
+    max_voices += size_t(fluid_synth_get_polyphony(shard.synth));
+  }
+  // Shards share one budget
+  if (applied_voice_limit_ > 0)
+    max_voices = applied_voice_limit_;
+  active_voices_.store(active, std::memory_order_relaxed);
+  max_voices_.store(max_voices, std::memory_order_relaxed);
+}
+
+bool NoteNagaSynthFluidSynthSharded::balanceVoices(fluid_synth_t *synth) {
+  size_t limit = voice_limit_.load();
+  if (limit == 0 || shards_.size() < 2)
+    return true;
+
+  // The shard gets what the other shards leave of the budget, so a dense channel
+  // can use all voices while the total stays within the limit
+  size_t others = 0;
+  for (const FluidShard &shard : shards_) {
+    if (shard.synth != synth)
+      others += size_t(fluid_synth_get_active_voice_count(shard.synth));
+  }
+  if (others >= limit)
+    return false;
+  int polyphony = int(limit - others);
+  if (fluid_synth_get_polyphony(synth) != polyphony)
+    fluid_synth_set_polyphony(synth, polyphony);
+  return true;
+}
+
+NN_SynthVoiceStats_t NoteNagaSynthFluidSynthSharded::getVoiceStats() const {
+  // Values of the last render, the shards are not touched here
+  NN_SynthVoiceStats_t stats;
+  stats.active_voices = active_voices_.load(std::memory_order_relaxed);
+  stats.max_voices = max_voices_.load(std::memory_order_relaxed);
+  stats.stolen_voices = stolen_voices_.load(std::memory_order_relaxed);
+  stats.dropped_notes = dropped_notes_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+std::string
+NoteNagaSynthFluidSynthSharded::getConfig(const std::string &key) const {
+  std::shared_lock<std::shared_mutex> lock(synth_mutex_);
+  if (key == "soundfont") {
+    return sf2_path_;
+  }
+  if (key == "shards") {
+    return std::to_string(shards_.size());
+  }
+  return "";
+}
+
+bool NoteNagaSynthFluidSynthSharded::setConfig(const std::string &key,
+                                               const std::string &value) {
+  // setSoundFont / setShardCount lock the shards exclusively
+  if (key == "soundfont") {
+    NN_QT_EMIT(synthUpdated(this));
+    return setSoundFont(value);
+  }
+  if (key == "shards") {
+    NN_QT_EMIT(synthUpdated(this));
+    try {
+      return setShardCount(size_t(std::stoul(value)));
+    } catch (const std::exception &) {
+      return false;
+    }
+  }
+  return false;
+}
+
+std::vector<std::string>
+NoteNagaSynthFluidSynthSharded::getSupportedConfigKeys() const {
+  return {"soundfont", "shards"};
+}
+
+bool NoteNagaSynthFluidSynthSharded::setSoundFont(const std::string &sf2_path) {
+  std::unique_lock<std::shared_mutex> lock(synth_mutex_);
+
+  // Stop all notes
+  stopAllNotesLocked(nullptr, nullptr);
+
+  // Save the new path
+  sf2_path_ = sf2_path;
+
+  // Reload all shards with new SoundFont
+  bool loaded = createShards(shards_.size());
+
+  // Reset channel programs and pans
+  for (int i = 0; i < 16; ++i) {
+    channel_programs_[i] = -1;
+    channel_pan_[i] = 0.0f;
+  }
+
+  NOTE_NAGA_LOG_INFO("Sharded FluidSynth reloaded with soundfont: " + sf2_path);
+  return loaded;
+}
+
+bool NoteNagaSynthFluidSynthSharded::setShardCount(size_t num_shards) {
+  std::unique_lock<std::shared_mutex> lock(synth_mutex_);
+
+  // Stop all notes, voices are lost when the shards are recreated
+  stopAllNotesLocked(nullptr, nullptr);
+
+  bool loaded = createShards(num_shards);
+
+  // Programs and pans must be sent again to the new instances
+  for (int i = 0; i < 16; ++i) {
+    channel_programs_[i] = -1;
+    channel_pan_[i] = 0.0f;
+  }
+
+  NOTE_NAGA_LOG_INFO("Sharded FluidSynth recreated with " +
+                     std::to_string(shards_.size()) + " shards");
+  return loaded;
+}
+
+void NoteNagaSynthFluidSynthSharded::setSampleRate(int sample_rate) {
+  std::unique_lock<std::shared_mutex> lock(synth_mutex_);
+  if (sample_rate <= 0 || sample_rate == sample_rate_)
+    return;
+
+  // The sample rate is fixed per FluidSynth instance, voices are lost
+  stopAllNotesLocked(nullptr, nullptr);
+  sample_rate_ = sample_rate;
+  createShards(shards_.size());
+
+  // Programs and pans must be sent again to the new instances
+  for (int i = 0; i < 16; ++i) {
+    channel_programs_[i] = -1;
+    channel_pan_[i] = 0.0f;
+  }
+
+  NOTE_NAGA_LOG_INFO("Sharded FluidSynth sample rate set to " +
+                     std::to_string(sample_rate) + " Hz");
+}
+
+bool NoteNagaSynthFluidSynthSharded::createShards(size_t num_shards) {
+  destroyShards();
+
+  if (num_shards == 0) {
+    unsigned int hw = std::thread::hardware_concurrency();
+    num_shards = std::clamp<size_t>(hw, 1, DEFAULT_MAX_SHARDS);
+  }
+  num_shards = std::min(num_shards, MAX_SHARDS);
+
+  bool loaded = !sf2_path_.empty();
+  shards_.resize(num_shards);
+  for (FluidShard &shard : shards_) {
+    shard.settings = new_fluid_settings();
+    fluid_settings_setnum(shard.settings, "synth.sample-rate", double(sample_rate_));
+    shard.synth = new_fluid_synth(shard.settings);
+    shard.left.assign(DEFAULT_SHARD_FRAMES, 0.0f);
+    shard.right.assign(DEFAULT_SHARD_FRAMES, 0.0f);
+    if (!sf2_path_.empty() &&
+        fluid_synth_sfload(shard.synth, sf2_path_.c_str(), 1) == FLUID_FAILED) {
+      loaded = false;
+    }
+  }
+
+  shard_count_.store(shards_.size());
+
+  // Keep the voice limit of the previous instances
+  applyVoiceLimit();
+  updateVoiceStats();
+
+  if (!loaded && !sf2_path_.empty()) {
+    NOTE_NAGA_LOG_ERROR("Sharded FluidSynth failed to load soundfont: " +
+                        sf2_path_);
+  }
+  return loaded;
+}
+
+void NoteNagaSynthFluidSynthSharded::destroyShards() {
+  for (FluidShard &shard : shards_) {
+    if (shard.synth)
+      delete_fluid_synth(shard.synth);
+    if (shard.settings)
+      delete_fluid_settings(shard.settings);
+  }
+  shards_.clear();
+  shard_count_.store(0);
+}
@@ -0,0 +1,700 @@
+#include <note_naga_engine/synth/synth_sampler.h>
+
+#include <note_naga_engine/io/wav_file.h>
+#include <note_naga_engine/logger.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/*******************************************************************************************************/
+// 4-lane vector helpers (SSE2 / NEON / scalar)
+/*******************************************************************************************************/
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+typedef __m128 nn_f4;
+typedef __m128i nn_i4;
+static inline nn_f4 f4_load(const float *p) { return _mm_load_ps(p); }
+static inline void f4_store(float *p, nn_f4 v) { _mm_store_ps(p, v); }
+static inline nn_f4 f4_dup(float a) { return _mm_set1_ps(a); }
+static inline nn_f4 f4_add(nn_f4 a, nn_f4 b) { return _mm_add_ps(a, b); }
+static inline nn_f4 f4_sub(nn_f4 a, nn_f4 b) { return _mm_sub_ps(a, b); }
+static inline nn_f4 f4_mul(nn_f4 a, nn_f4 b) { return _mm_mul_ps(a, b); }
+static inline nn_i4 i4_load(const int32_t *p) { return _mm_load_si128((const __m128i *)p); }
+static inline void i4_store(int32_t *p, nn_i4 v) { _mm_store_si128((__m128i *)p, v); }
+static inline nn_i4 i4_add(nn_i4 a, nn_i4 b) { return _mm_add_epi32(a, b); }
+static inline nn_i4 f4_trunc(nn_f4 v) { return _mm_cvttps_epi32(v); }
+static inline nn_f4 i4_to_f4(nn_i4 v) { return _mm_cvtepi32_ps(v); }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+typedef float32x4_t nn_f4;
+typedef int32x4_t nn_i4;
+static inline nn_f4 f4_load(const float *p) { return vld1q_f32(p); }
+static inline void f4_store(float *p, nn_f4 v) { vst1q_f32(p, v); }
+static inline nn_f4 f4_dup(float a) { return vdupq_n_f32(a); }
+static inline nn_f4 f4_add(nn_f4 a, nn_f4 b) { return vaddq_f32(a, b); }
+static inline nn_f4 f4_sub(nn_f4 a, nn_f4 b) { return vsubq_f32(a, b); }
+static inline nn_f4 f4_mul(nn_f4 a, nn_f4 b) { return vmulq_f32(a, b); }
+static inline nn_i4 i4_load(const int32_t *p) { return vld1q_s32(p); }
+static inline void i4_store(int32_t *p, nn_i4 v) { vst1q_s32(p, v); }
+static inline nn_i4 i4_add(nn_i4 a, nn_i4 b) { return vaddq_s32(a, b); }
+static inline nn_i4 f4_trunc(nn_f4 v) { return vcvtq_s32_f32(v); }
+static inline nn_f4 i4_to_f4(nn_i4 v) { return vcvtq_f32_s32(v); }
+#else
+struct nn_f4 { float v[4]; };
+struct nn_i4 { int32_t v[4]; };
+static inline nn_f4 f4_load(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+static inline void f4_store(float *p, nn_f4 a) { std::memcpy(p, a.v, sizeof(a.v)); }
+static inline nn_f4 f4_dup(float a) { return {{a, a, a, a}}; }
+static inline nn_f4 f4_add(nn_f4 a, nn_f4 b) { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+static inline nn_f4 f4_sub(nn_f4 a, nn_f4 b) { for (int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+static inline nn_f4 f4_mul(nn_f4 a, nn_f4 b) { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+static inline nn_i4 i4_load(const int32_t *p) { return {{p[0], p[1], p[2], p[3]}}; }
+static inline void i4_store(int32_t *p, nn_i4 a) { std::memcpy(p, a.v, sizeof(a.v)); }
+static inline nn_i4 i4_add(nn_i4 a, nn_i4 b) { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+static inline nn_i4 f4_trunc(nn_f4 a) { return {{int32_t(a.v[0]), int32_t(a.v[1]), int32_t(a.v[2]), int32_t(a.v[3])}}; }
+static inline nn_f4 i4_to_f4(nn_i4 a) { return {{float(a.v[0]), float(a.v[1]), float(a.v[2]), float(a.v[3])}}; }
+#endif
+
+/*******************************************************************************************************/
+// Sampler
+/*******************************************************************************************************/
+
+// Envelope is evaluated once per chunk and ramped linearly inside of it
+static constexpr size_t ENV_CHUNK = 32;
+// Samples around zone data, interpolation may read up to 1 before / 2 after position. Zeros,
+// looped zones continue after the loop end with the start of the loop
+static constexpr size_t ZONE_PAD_FRONT = 2;
+static constexpr size_t ZONE_PAD_BACK = 4;
+// Data of unused voice lanes
+static const float SILENCE[ZONE_PAD_FRONT + ZONE_PAD_BACK] = {0.0f};
+
+NoteNagaSynthSampler::NoteNagaSynthSampler(const std::string &name,
+                                           const std::string &sample_path)
+    : NoteNagaSynthesizer(name),
+      events_(std::make_unique<LockFreeMPMCQueue<SamplerEvent, 1024>>()) {
+  for (size_t v = 0; v < MAX_VOICES; ++v) {
+    resetVoice(v);
+  }
+  if (!sample_path.empty()) {
+    loadSample(sample_path);
+  }
+  NOTE_NAGA_LOG_INFO("Sampler initialized with " +
+                     std::to_string(zones_.size()) + " zones");
+}
+
+NoteNagaSynthSampler::~NoteNagaSynthSampler() {
+  std::lock_guard<std::mutex> lock(synth_mutex_);
+  num_active_ = 0;
+  zones_.clear();
+}
+
+/*******************************************************************************************************/
+// Synth thread side
+/*******************************************************************************************************/
+
+void NoteNagaSynthSampler::playNote(const NN_Note_t &note, int channel,
+                                    float pan) {
+  if (!note.velocity.has_value() || note.velocity.value() <= 0)
+    return;
+
+  NoteNagaTrack *track = note.parent;
+  if (!track)
+    return;
+
+  // Check if note is already playing
+  if (playing_notes_[track].find(note.id) != playing_notes_[track].end()) {
+    return;
+  }
+
+  SamplerEvent event;
+  event.type = SamplerEvent::NoteOn;
+  event.track = track;
+  event.note_id = note.id;
+  event.key = note.note;
+  event.velocity = note.velocity.value();
+  event.pan = pan;
+  // queue full = note dropped, the audio thread is hopelessly behind anyway
+  if (!events_->enqueue(event))
+    return;
+
+  // Store the note in playing_notes_ for later stop
+  playing_notes_[track][note.id] = PlayedNote_t{note, channel};
+}
+
+void NoteNagaSynthSampler::stopNote(const NN_Note_t &note) {
+  NoteNagaTrack *track = note.parent;
+  if (!track)
+    return;
+
+  TrackNotesMap &playingTrackNotes = playing_notes_[track];
+  auto it = playingTrackNotes.find(note.id);
+  if (it == playingTrackNotes.end())
+    return;
+
+  SamplerEvent event;
+  event.type = SamplerEvent::NoteOff;
+  event.track = track;
+  event.note_id = note.id;
+  events_->enqueue(event);
+  playingTrackNotes.erase(it);
+}
+
+void NoteNagaSynthSampler::stopAllNotes(NoteNagaMidiSeq *seq,
+                                        NoteNagaTrack *track) {
+  if (seq && !track) {
+    for (auto &tr : seq->getTracks()) {
+      if (tr)
+        stopAllNotes(nullptr, tr);
+    }
+    return;
+  }
+
+  // nullptr track = all tracks
+  SamplerEvent event;
+  event.type = SamplerEvent::AllNotesOff;
+  event.track = track;
+  events_->enqueue(event);
+
+  if (track) {
+    playing_notes_[track].clear();
+  } else {
+    for (auto &[tr, notes] : playing_notes_) {
+      notes.clear();
+    }
+  }
+}
+
+std::string NoteNagaSynthSampler::getConfig(const std::string &key) const {
+  if (key == "sample")
+    return sample_path_;
+  if (key == "interpolation")
+    return interpolation_ == NN_SamplerInterpolation_t::Cubic ? "cubic" : "linear";
+  if (key == "attack")
+    return std::to_string(attack_);
+  if (key == "decay")
+    return std::to_string(decay_);
+  if (key == "sustain")
+    return std::to_string(sustain_);
+  if (key == "release")
+    return std::to_string(release_);
+  return "";
+}
+
+bool NoteNagaSynthSampler::setConfig(const std::string &key,
+                                     const std::string &value) {
+  if (key == "sample") {
+    NN_QT_EMIT(synthUpdated(this));
+    clearZones();
+    return loadSample(value);
+  }
+  if (key == "interpolation") {
+    if (value != "cubic" && value != "linear")
+      return false;
+    setInterpolation(value == "cubic" ? NN_SamplerInterpolation_t::Cubic
+                                      : NN_SamplerInterpolation_t::Linear);
+    NN_QT_EMIT(synthUpdated(this));
+    return true;
+  }
+  if (key == "attack" || key == "decay" || key == "sustain" ||
+      key == "release") {
+    float v;
+    try {
+      v = std::stof(value);
+    } catch (const std::exception &) {
+      return false;
+    }
+    float a = attack_, d = decay_, s = sustain_, r = release_;
+    if (key == "attack") a = v;
+    else if (key == "decay") d = v;
+    else if (key == "sustain") s = v;
+    else r = v;
+    setEnvelope(a, d, s, r);
+    NN_QT_EMIT(synthUpdated(this));
+    return true;
+  }
+  return false;
+}
+
+std::vector<std::string> NoteNagaSynthSampler::getSupportedConfigKeys() const {
+  return {"sample", "interpolation", "attack", "decay", "sustain", "release"};
+}
+
+bool NoteNagaSynthSampler::loadSample(const std::string &path, int root_key,
+                                      int low_key, int high_key, bool loop) {
+  WavFile wav;
+  if (!wav.load(path))
+    return false;
+
+  NN_SamplerZone_t zone;
+  zone.left = std::move(wav.left);
+  zone.right = std::move(wav.right);
+  zone.sample_rate = wav.sample_rate;
+  zone.root_key = root_key;
+  zone.low_key = low_key;
+  zone.high_key = high_key;
+  zone.loop = loop;
+  addZone(zone);
+
+  sample_path_ = path;
+  return true;
+}
+
+void NoteNagaSynthSampler::addZone(const NN_SamplerZone_t &desc) {
+  // Prepare padded copy outside of the lock
+  auto zone = std::make_unique<Zone>();
+  zone->desc = desc;
+  zone->desc.left.clear();
+  zone->desc.right.clear();
+
+  size_t length = desc.left.size();
+  const std::vector<float> &src_right = desc.right.size() == length ? desc.right : desc.left;
+  size_t loop_end = desc.loop_end == 0 ? length : std::min(desc.loop_end, length);
+  size_t loop_start = std::min(desc.loop_start, loop_end);
+  if (loop_end == loop_start)
+    zone->desc.loop = false;
+
+  // A looped zone never plays past the loop end, its data stops there and the back
+  // padding continues with the start of the loop, so taps read across the wrap
+  size_t data_length = zone->desc.loop ? loop_end : length;
+  zone->left.assign(ZONE_PAD_FRONT + data_length + ZONE_PAD_BACK, 0.0f);
+  zone->right.assign(ZONE_PAD_FRONT + data_length + ZONE_PAD_BACK, 0.0f);
+  std::copy(desc.left.begin(), desc.left.begin() + data_length, zone->left.begin() + ZONE_PAD_FRONT);
+  std::copy(src_right.begin(), src_right.begin() + data_length, zone->right.begin() + ZONE_PAD_FRONT);
+  if (zone->desc.loop) {
+    size_t loop_len = loop_end - loop_start;
+    for (size_t i = 0; i < ZONE_PAD_BACK; ++i) {
+      zone->left[ZONE_PAD_FRONT + loop_end + i] = desc.left[loop_start + i % loop_len];
+      zone->right[ZONE_PAD_FRONT + loop_end + i] = src_right[loop_start + i % loop_len];
+    }
+  }
+
+  zone->length = int32_t(length);
+  zone->loop_start = int32_t(loop_start);
+  zone->loop_end = int32_t(loop_end);
+
+  std::lock_guard<std::mutex> lock(synth_mutex_);
+  zones_.push_back(std::move(zone));
+}
+
+void NoteNagaSynthSampler::clearZones() {
+  std::lock_guard<std::mutex> lock(synth_mutex_);
+  // Voices point into zone data
+  for (size_t v = 0; v < num_active_; ++v) {
+    resetVoice(v);
+  }
+  num_active_ = 0;
+  active_voices_.store(0, std::memory_order_relaxed);
+  zones_.clear();
+  sample_path_.clear();
+}
+
+void NoteNagaSynthSampler::setInterpolation(NN_SamplerInterpolation_t interpolation) {
+  std::lock_guard<std::mutex> lock(synth_mutex_);
+  interpolation_ = interpolation;
+}
+
+void NoteNagaSynthSampler::setEnvelope(float attack, float decay, float sustain,
+                                       float release) {
+  std::lock_guard<std::mutex> lock(synth_mutex_);
+  attack_ = std::max(attack, 0.0f);
+  decay_ = std::max(decay, 0.0f);
+  sustain_ = std::clamp(sustain, 0.0f, 1.0f);
+  release_ = std::max(release, 0.0f);
+}
+
+void NoteNagaSynthSampler::setSampleRate(int sample_rate) {
+  if (sample_rate <= 0)
+    return;
+  std::lock_guard<std::mutex> lock(synth_mutex_);
+  sample_rate_ = sample_rate;
+}
+
+/*******************************************************************************************************/
+// Audio thread side
+/*******************************************************************************************************/
+
+void NoteNagaSynthSampler::renderAudio(float *left, float *right,
+                                       size_t num_frames) {
+  std::lock_guard<std::mutex> lock(synth_mutex_);
+
+  std::fill(left, left + num_frames, 0.0f);
+  std::fill(right, right + num_frames, 0.0f);
+
+  enforceVoiceLimit(max_voices_.load(std::memory_order_relaxed));
+  processEvents();
+
+  for (size_t offset = 0; offset < num_frames; offset += ENV_CHUNK) {
+    size_t frames = std::min(ENV_CHUNK, num_frames - offset);
+    freeFinishedVoices();
+    if (num_active_ == 0)
+      break;
+    updateEnvelopes(frames);
+    renderVoices(left + offset, right + offset, frames);
+  }
+  active_voices_.store(num_active_, std::memory_order_relaxed);
+}
+
+void NoteNagaSynthSampler::setVoiceLimit(size_t max_voices) {
+  max_voices_.store(std::clamp<size_t>(max_voices, 1, MAX_VOICES),
+                    std::memory_order_relaxed);
+}
+
+void NoteNagaSynthSampler::setVoiceStealPolicy(NN_VoiceStealPolicy_t policy) {
+  steal_policy_.store(policy, std::memory_order_relaxed);
+}
+
+NN_SynthVoiceStats_t NoteNagaSynthSampler::getVoiceStats() const {
+  NN_SynthVoiceStats_t stats;
+  stats.active_voices = active_voices_.load(std::memory_order_relaxed);
+  stats.max_voices = max_voices_.load(std::memory_order_relaxed);
+  stats.stolen_voices = stolen_voices_.load(std::memory_order_relaxed);
+  stats.dropped_notes = dropped_notes_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void NoteNagaSynthSampler::processEvents() {
+  while (auto event = events_->dequeue()) {
+    switch (event->type) {
+    case SamplerEvent::NoteOn:
+      startVoice(*event);
+      break;
+    case SamplerEvent::NoteOff:
+      for (size_t v = 0; v < num_active_; ++v) {
+        if (voice_track_[v] == event->track &&
+            voice_note_id_[v] == event->note_id)
+          releaseVoice(v);
+      }
+      break;
+    case SamplerEvent::AllNotesOff:
+      for (size_t v = 0; v < num_active_; ++v) {
+        if (!event->track || voice_track_[v] == event->track)
+          releaseVoice(v);
+      }
+      break;
+    }
+  }
+}
+
+const NoteNagaSynthSampler::Zone *NoteNagaSynthSampler::findZone(int key,
+                                                                 int velocity) const {
+  for (const auto &zone : zones_) {
+    const NN_SamplerZone_t &d = zone->desc;
+    if (key >= d.low_key && key <= d.high_key && velocity >= d.low_velocity &&
+        velocity <= d.high_velocity)
+      return zone.get();
+  }
+  return nullptr;
+}
+
+void NoteNagaSynthSampler::startVoice(const SamplerEvent &event) {
+  const Zone *zone = findZone(event.key, event.velocity);
+  if (!zone || zone->length == 0)
+    return;
+
+  const NN_SamplerZone_t &d = zone->desc;
+  float vel = float(std::clamp(event.velocity, 0, 127)) / 127.0f;
+  float amp = vel * vel * d.gain;
+
+  size_t v;
+  size_t max_voices = max_voices_.load(std::memory_order_relaxed);
+  if (num_active_ < max_voices) {
+    v = num_active_++;
+  } else {
+    // Voice budget exhausted, steal a voice or drop the note
+    v = pickVictim();
+    if (v >= num_active_ ||
+        (steal_policy_.load(std::memory_order_relaxed) == NN_VoiceStealPolicy_t::Quietest &&
+         voice_stage_[v] != EnvRelease && voiceLevel(v) > amp)) {
+      // Every playing voice is louder than the new note
+      dropped_notes_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    stolen_voices_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  float sr = float(sample_rate_);
+
+  voice_pos_[v] = 0;
+  voice_frac_[v] = 0.0f;
+  voice_step_[v] = std::pow(2.0f, float(event.key - d.root_key) / 12.0f) *
+                   float(d.sample_rate) / sr;
+  voice_data_l_[v] = zone->left.data() + ZONE_PAD_FRONT;
+  voice_data_r_[v] = zone->right.data() + ZONE_PAD_FRONT;
+  // Loop wraps one frame late, so the tap before the position still reads the
+  // frame before the loop end (the frame at the loop end is a padded copy)
+  voice_end_[v] = d.loop ? zone->loop_end + 1 : zone->length;
+  voice_loop_len_[v] = d.loop ? zone->loop_end - zone->loop_start : 0;
+
+  // Velocity curve and constant power pan (unity at center)
+  float angle = (std::clamp(event.pan, -1.0f, 1.0f) + 1.0f) * float(M_PI) * 0.25f;
+  voice_gain_l_[v] = amp * std::cos(angle) * float(M_SQRT2);
+  voice_gain_r_[v] = amp * std::sin(angle) * float(M_SQRT2);
+
+  // Envelope starts in attack stage
+  int32_t attack = std::max<int32_t>(1, int32_t(attack_ * sr));
+  voice_env_[v] = 0.0f;
+  voice_env_target_[v] = 0.0f;
+  voice_env_step_[v] = 0.0f;
+  voice_env_slope_[v] = 1.0f / float(attack);
+  voice_stage_left_[v] = attack;
+  voice_stage_[v] = EnvAttack;
+  voice_ended_[v] = false;
+
+  voice_track_[v] = event.track;
+  voice_note_id_[v] = event.note_id;
+  voice_age_[v] = ++voice_counter_;
+}
+
+void NoteNagaSynthSampler::releaseVoice(size_t v) {
+  if (voice_stage_[v] == EnvRelease || voice_stage_[v] == EnvOff)
+    return;
+  int32_t release = std::max<int32_t>(1, int32_t(release_ * float(sample_rate_)));
+  voice_stage_[v] = EnvRelease;
+  voice_stage_left_[v] = release;
+  voice_env_slope_[v] = -voice_env_target_[v] / float(release);
+}
+
+void NoteNagaSynthSampler::resetVoice(size_t v) {
+  voice_pos_[v] = 0;
+  voice_frac_[v] = 0.0f;
+  voice_step_[v] = 0.0f;
+  voice_env_[v] = 0.0f;
+  voice_env_step_[v] = 0.0f;
+  voice_gain_l_[v] = 0.0f;
+  voice_gain_r_[v] = 0.0f;
+  voice_data_l_[v] = SILENCE + ZONE_PAD_FRONT;
+  voice_data_r_[v] = SILENCE + ZONE_PAD_FRONT;
+  voice_end_[v] = 0;
+  voice_loop_len_[v] = 0;
+  voice_env_target_[v] = 0.0f;
+  voice_env_slope_[v] = 0.0f;
+  voice_stage_left_[v] = 0;
+  voice_stage_[v] = EnvOff;
+  voice_ended_[v] = false;
+  voice_track_[v] = nullptr;
+  voice_note_id_[v] = 0;
+  voice_age_[v] = 0;
+}
+
+void NoteNagaSynthSampler::moveVoice(size_t from, size_t to) {
+  voice_pos_[to] = voice_pos_[from];
+  voice_frac_[to] = voice_frac_[from];
+  voice_step_[to] = voice_step_[from];
+  voice_env_[to] = voice_env_[from];
+  voice_env_step_[to] = voice_env_step_[from];
+  voice_gain_l_[to] = voice_gain_l_[from];
+  voice_gain_r_[to] = voice_gain_r_[from];
+  voice_data_l_[to] = voice_data_l_[from];
+  voice_data_r_[to] = voice_data_r_[from];
+  voice_end_[to] = voice_end_[from];
+  voice_loop_len_[to] = voice_loop_len_[from];
+  voice_env_target_[to] = voice_env_target_[from];
+  voice_env_slope_[to] = voice_env_slope_[from];
+  voice_stage_left_[to] = voice_stage_left_[from];
+  voice_stage_[to] = voice_stage_[from];
+  voice_ended_[to] = voice_ended_[from];
+  voice_track_[to] = voice_track_[from];
+  voice_note_id_[to] = voice_note_id_[from];
+  voice_age_[to] = voice_age_[from];
+}
+
+void NoteNagaSynthSampler::freeFinishedVoices() {
+  // Keep active voices packed at the front, so batches stay dense
+  for (size_t v = num_active_; v-- > 0;) {
+    if (voice_stage_[v] == EnvOff || voice_ended_[v]) {
+      size_t last = --num_active_;
+      if (v != last)
+        moveVoice(last, v);
+      resetVoice(last);
+    }
+  }
+}
+
+float NoteNagaSynthSampler::voiceLevel(size_t v) const {
+  return voice_env_target_[v] * std::max(voice_gain_l_[v], voice_gain_r_[v]);
+}
+
+size_t NoteNagaSynthSampler::pickVictim() const {
+  bool quietest = steal_policy_.load(std::memory_order_relaxed) == NN_VoiceStealPolicy_t::Quietest;
+  size_t victim = num_active_;
+  bool victim_released = false;
+  for (size_t v = 0; v < num_active_; ++v) {
+    bool released = voice_stage_[v] == EnvRelease || voice_stage_[v] == EnvOff;
+    if (victim == num_active_ || (released && !victim_released)) {
+      victim = v;
+      victim_released = released;
+      continue;
+    }
+    if (released != victim_released)
+      continue;
+    // Same group (releasing / held), apply policy
+    if (quietest ? voiceLevel(v) < voiceLevel(victim) : voice_age_[v] < voice_age_[victim])
+      victim = v;
+  }
+  return victim;
+}
+
+void NoteNagaSynthSampler::enforceVoiceLimit(size_t max_voices) {
+  // Limit was lowered (e.g. by the engine load guard), cut the least important voices
+  while (num_active_ > max_voices) {
+    size_t v = pickVictim();
+    size_t last = --num_active_;
+    if (v != last)
+      moveVoice(last, v);
+    resetVoice(last);
+    stolen_voices_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void NoteNagaSynthSampler::updateEnvelopes(size_t num_frames) {
+  float sr = float(sample_rate_);
+  for (size_t v = 0; v < num_active_; ++v) {
+    // Start exactly where the previous chunk should have ended
+    float env = voice_env_target_[v];
+    voice_env_[v] = env;
+
+    int32_t remaining = int32_t(num_frames);
+    while (remaining > 0) {
+      EnvelopeStage stage = voice_stage_[v];
+      if (stage == EnvSustain || stage == EnvOff)
+        break;
+
+      int32_t take = std::min(voice_stage_left_[v], remaining);
+      env += voice_env_slope_[v] * float(take);
+      voice_stage_left_[v] -= take;
+      remaining -= take;
+      if (voice_stage_left_[v] > 0)
+        continue;
+
+      // Stage finished
+      if (stage == EnvAttack) {
+        env = 1.0f;
+        int32_t decay = int32_t(decay_ * sr);
+        if (decay > 0) {
+          voice_stage_[v] = EnvDecay;
+          voice_stage_left_[v] = decay;
+          voice_env_slope_[v] = (sustain_ - 1.0f) / float(decay);
+          continue;
+        }
+        env = sustain_;
+      } else if (stage == EnvDecay) {
+        env = sustain_;
+      } else {
+        env = 0.0f;
+      }
+      // Decay to zero sustain (one-shot drums) ends the voice
+      voice_stage_[v] = (stage == EnvRelease || sustain_ <= 0.0f) ? EnvOff : EnvSustain;
+      voice_env_slope_[v] = 0.0f;
+    }
+
+    voice_env_target_[v] = env;
+    voice_env_step_[v] = (env - voice_env_[v]) / float(num_frames);
+  }
+}
+
+void NoteNagaSynthSampler::renderVoices(float *left, float *right,
+                                        size_t num_frames) {
+  // Per-frame lane accumulators, summed horizontally once per chunk
+  alignas(16) float acc_l[ENV_CHUNK * 4];
+  alignas(16) float acc_r[ENV_CHUNK * 4];
+  std::fill(acc_l, acc_l + num_frames * 4, 0.0f);
+  std::fill(acc_r, acc_r + num_frames * 4, 0.0f);
+
+  const bool cubic = interpolation_ == NN_SamplerInterpolation_t::Cubic;
+  const nn_f4 half = f4_dup(0.5f);
+  const nn_f4 one_half = f4_dup(1.5f);
+  const nn_f4 two = f4_dup(2.0f);
+  const nn_f4 two_half = f4_dup(2.5f);
+
+  alignas(16) int32_t pos[4];
+  alignas(16) float t0l[4], t1l[4], t2l[4], t3l[4];
+  alignas(16) float t0r[4], t1r[4], t2r[4], t3r[4];
+
+  // Lanes after the last active voice hold silent voices (see resetVoice)
+  for (size_t v0 = 0; v0 < num_active_; v0 += 4) {
+    nn_i4 p = i4_load(voice_pos_ + v0);
+    nn_f4 frac = f4_load(voice_frac_ + v0);
+    nn_f4 step = f4_load(voice_step_ + v0);
+    nn_f4 env = f4_load(voice_env_ + v0);
+    nn_f4 env_step = f4_load(voice_env_step_ + v0);
+    nn_f4 gain_l = f4_load(voice_gain_l_ + v0);
+    nn_f4 gain_r = f4_load(voice_gain_r_ + v0);
+
+    for (size_t i = 0; i < num_frames; ++i) {
+      // Gather interpolation taps, handle loop wrap and sample end
+      i4_store(pos, p);
+      for (size_t lane = 0; lane < 4; ++lane) {
+        size_t v = v0 + lane;
+        int32_t q = pos[lane];
+        if (q >= voice_end_[v]) {
+          if (voice_loop_len_[v] > 0) {
+            while (q >= voice_end_[v]) q -= voice_loop_len_[v];
+          } else {
+            q = voice_end_[v];
+            voice_ended_[v] = true;
+          }
+          pos[lane] = q;
+        }
+        const float *dl = voice_data_l_[v] + q;
+        const float *dr = voice_data_r_[v] + q;
+        t1l[lane] = dl[0];
+        t2l[lane] = dl[1];
+        t1r[lane] = dr[0];
+        t2r[lane] = dr[1];
+        if (cubic) {
+          t0l[lane] = dl[-1];
+          t3l[lane] = dl[2];
+          t0r[lane] = dr[-1];
+          t3r[lane] = dr[2];
+        }
+      }
+      p = i4_load(pos);
+
+      nn_f4 s_l, s_r;
+      nn_f4 a1 = f4_load(t1l), a2 = f4_load(t2l);
+      nn_f4 b1 = f4_load(t1r), b2 = f4_load(t2r);
+      if (cubic) {
+        // Catmull-Rom: ((c3 * f + c2) * f + c1) * f + c0
+        nn_f4 a0 = f4_load(t0l), a3 = f4_load(t3l);
+        nn_f4 b0 = f4_load(t0r), b3 = f4_load(t3r);
+        nn_f4 c1 = f4_mul(half, f4_sub(a2, a0));
+        nn_f4 c2 = f4_sub(f4_add(f4_sub(a0, f4_mul(two_half, a1)), f4_mul(two, a2)), f4_mul(half, a3));
+        nn_f4 c3 = f4_add(f4_mul(half, f4_sub(a3, a0)), f4_mul(one_half, f4_sub(a1, a2)));
+        s_l = f4_add(f4_mul(f4_add(f4_mul(f4_add(f4_mul(c3, frac), c2), frac), c1), frac), a1);
+        c1 = f4_mul(half, f4_sub(b2, b0));
+        c2 = f4_sub(f4_add(f4_sub(b0, f4_mul(two_half, b1)), f4_mul(two, b2)), f4_mul(half, b3));
+        c3 = f4_add(f4_mul(half, f4_sub(b3, b0)), f4_mul(one_half, f4_sub(b1, b2)));
+        s_r = f4_add(f4_mul(f4_add(f4_mul(f4_add(f4_mul(c3, frac), c2), frac), c1), frac), b1);
+      } else {
+        s_l = f4_add(a1, f4_mul(frac, f4_sub(a2, a1)));
+        s_r = f4_add(b1, f4_mul(frac, f4_sub(b2, b1)));
+      }
+
+      // Envelope, gain and pan
+      float *out_l = acc_l + i * 4;
+      float *out_r = acc_r + i * 4;
+      f4_store(out_l, f4_add(f4_load(out_l), f4_mul(f4_mul(s_l, env), gain_l)));
+      f4_store(out_r, f4_add(f4_load(out_r), f4_mul(f4_mul(s_r, env), gain_r)));
+      env = f4_add(env, env_step);
+
+      // Advance playback position
+      frac = f4_add(frac, step);
+      nn_i4 whole = f4_trunc(frac);
+      frac = f4_sub(frac, i4_to_f4(whole));
+      p = i4_add(p, whole);
+    }
+
+    i4_store(voice_pos_ + v0, p);
+    f4_store(voice_frac_ + v0, frac);
+    f4_store(voice_env_ + v0, env);
+  }
+
+  for (size_t i = 0; i < num_frames; ++i) {
+    const float *l = acc_l + i * 4;
+    const float *r = acc_r + i * 4;
+    left[i] += (l[0] + l[1]) + (l[2] + l[3]);
+    right[i] += (r[0] + r[1]) + (r[2] + r[3]);
+  }
+}
@@ -22,6 +22,7 @@ static QMap<QString, DSPBlockMeta> dspBlockMeta = {
     { "Exciter",      { "Distortion", "Adds brightness and harmonics.", "icons/device.svg" } },
     { "Delay",        { "Effect",     "Classic delay/echo effect.", "icons/loop.svg" } },
     { "Reverb",       { "Effect",     "Room/space simulation (reverb).", "icons/loop.svg" } },
+    { "Convolution Reverb", { "Effect", "Reverb from an impulse response (WAV file or generated room).", "icons/loop.svg" } },
     { "Chorus",       { "Effect",     "Thickens sound with modulated delay.", "icons/solo.svg" } },
     { "Flanger",      { "Effect",     "Jet/space effect with short modulated delay.", "icons/solo.svg" } },
     { "Phaser",       { "Effect",     "Sweeping filter/phasing effect.", "icons/solo.svg" } },
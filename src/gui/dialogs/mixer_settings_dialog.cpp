@@ -41,6 +41,7 @@ void MixerSettingsDialog::setupUI() {
   QLabel *synthTypeLabel = new QLabel("Type:", synthListGroup);
   synthTypeComboBox = new QComboBox(synthListGroup);
   synthTypeComboBox->addItem("FluidSynth", "fluidsynth");
+  synthTypeComboBox->addItem("FluidSynth (Multi-core)", "fluidsynth_sharded");
   synthTypeComboBox->addItem("External MIDI", "external_midi");
 
   addButton = new QPushButton("Add", synthListGroup);
@@ -159,6 +160,14 @@ void MixerSettingsDialog::onSynthesizerSelected(int index) {
     // Display current SoundFont path
     soundFontPathEdit->setText(
         QString::fromStdString(fluidSynth->getSoundFontPath()));
+  } else if (NoteNagaSynthFluidSynthSharded *shardedSynth =
+                 dynamic_cast<NoteNagaSynthFluidSynthSharded *>(synth)) {
+    // Sharded FluidSynth shares the FluidSynth configuration panel
+    fluidSynthGroup->setVisible(true);
+    externalMidiGroup->setVisible(false);
+
+    soundFontPathEdit->setText(
+        QString::fromStdString(shardedSynth->getSoundFontPath()));
   } else if (NoteNagaSynthExternalMidi *externalMidi =
                  dynamic_cast<NoteNagaSynthExternalMidi *>(synth)) {
     // Show External MIDI configuration
@@ -198,6 +207,8 @@ void MixerSettingsDialog::addSynthesizer() {
   // Create a name for the new synthesizer
   if (type == "fluidsynth") {
     synthName = "FluidSynth";
+  } else if (type == "fluidsynth_sharded") {
+    synthName = "FluidSynth MC";
   } else if (type == "external_midi") {
     synthName = "External MIDI";
   } else {
@@ -234,6 +245,10 @@ void MixerSettingsDialog::addSynthesizer() {
       // Create default FluidSynth with empty SoundFont path
       // User will need to set the SoundFont path later
       newSynth = new NoteNagaSynthFluidSynth(finalName.toStdString(), "");
+    } else if (type == "fluidsynth_sharded") {
+      // Number of shards is derived from CPU core count
+      newSynth =
+          new NoteNagaSynthFluidSynthSharded(finalName.toStdString(), "");
     } else if (type == "external_midi") {
       // Create external MIDI synthesizer with auto-selected port
       newSynth = new NoteNagaSynthExternalMidi(finalName.toStdString());
@@ -331,8 +346,10 @@ void MixerSettingsDialog::applyFluidSynthChanges() {
       item->data(Qt::UserRole).value<void *>());
   NoteNagaSynthFluidSynth *fluidSynth =
       dynamic_cast<NoteNagaSynthFluidSynth *>(synth);
+  NoteNagaSynthFluidSynthSharded *shardedSynth =
+      dynamic_cast<NoteNagaSynthFluidSynthSharded *>(synth);
 
-  if (!fluidSynth) {
+  if (!fluidSynth && !shardedSynth) {
     QMessageBox::warning(this, "Error",
                          "Selected synthesizer is not a FluidSynth instance.");
     return;
@@ -345,7 +362,7 @@ void MixerSettingsDialog::applyFluidSynthChanges() {
   }
 
   // Apply SoundFont change in real-time
-  bool success = fluidSynth->setSoundFont(soundFontPath.toStdString());
+  bool success = synth->setConfig("soundfont", soundFontPath.toStdString());
 
   if (success) {
     QMessageBox::information(this, "SoundFont Changed",
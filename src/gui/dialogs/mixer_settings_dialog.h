@@ -3,6 +3,7 @@
 #include <note_naga_engine/note_naga_engine.h>
 #include <note_naga_engine/synth/synth_external_midi.h>
 #include <note_naga_engine/synth/synth_fluidsynth.h>
+#include <note_naga_engine/synth/synth_fluidsynth_sharded.h>
 
 #include <QComboBox>
 #include <QDialog>
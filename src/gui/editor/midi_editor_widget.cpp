@@ -231,7 +231,7 @@ void MidiEditorWidget::refreshMarker() {
         marker_line = nullptr;
     }
 
-    int marker_x = engine->getProject()->getCurrentTick() * config.time_scale;
+    int marker_x = engine->getAudibleTick() * config.time_scale;
     int visible_y0 = verticalScrollBar()->value();
     int visible_y1 = visible_y0 + viewport()->height();
 
@@ -256,7 +256,8 @@ void MidiEditorWidget::refreshSequence(NoteNagaMidiSeq *seq) {
 
 void MidiEditorWidget::currentTickChanged(int tick) {
     if (engine->isPlaying()) {
-        int marker_x = int(tick * config.time_scale);
+        // Follow what is heard, the DSP chains may delay the output
+        int marker_x = int(engine->getAudibleTick() * config.time_scale);
         int width = viewport()->width();
         int current_scroll = this->horizontalScrollBar()->value();
         int value = current_scroll;
@@ -1,9 +1,13 @@
 #include "dsp_block_widget.h"
 #include "../nn_gui_utils.h"
+#include <note_naga_engine/dsp/dsp_block_convolution_reverb.h>
 #include <QButtonGroup>
+#include <QFileDialog>
+#include <QFileInfo>
 #include <QIcon>
 #include <QResizeEvent>
 #include <QSpacerItem>
+#include <algorithm>
 #include <cmath>
 
 static constexpr int VSLIDER_WIDTH = 30;
@@ -120,6 +124,15 @@ void DSPBlockWidget::buildLeftBar() {
     leftBarLayout_->addWidget(titleLabel_, 0);
     leftBarLayout_->addStretch(1);
 
+    // CPU load of the block (average, peak in tooltip)
+    loadBar_ = new QProgressBar(leftBar_);
+    loadBar_->setOrientation(Qt::Vertical);
+    loadBar_->setRange(0, 100);
+    loadBar_->setValue(0);
+    loadBar_->setTextVisible(false);
+    loadBar_->setFixedSize(6, 40);
+    leftBarLayout_->addWidget(loadBar_, 0, Qt::AlignHCenter);
+
     auto addCenteredButton = [&](QPushButton* btn) {
         QWidget* wrapper = new QWidget(leftBar_);
         wrapper->setStyleSheet("QWidget { background: transparent; }");
@@ -151,6 +164,15 @@ void DSPBlockWidget::buildLeftBar() {
     addCenteredButton(deleteBtn_);
 }
 
+void DSPBlockWidget::setLoad(const NN_DSPLoad_t& load) {
+    // Scale so that one percent of the real-time budget fills the bar
+    int value = std::clamp(int(load.average * 10000.0f), 0, 100);
+    if (loadBar_->value() != value) loadBar_->setValue(value);
+    loadBar_->setToolTip(QString("CPU load\nAverage: %1 %\nPeak: %2 %")
+                             .arg(load.average * 100.0f, 0, 'f', 2)
+                             .arg(load.peak * 100.0f, 0, 'f', 2));
+}
+
 //
 // --- BUTTON BAR ---
 //
@@ -197,6 +219,33 @@ void DSPBlockWidget::buildButtonBar() {
         }
         if (control) buttonWidgets_.push_back(control);
     }
+
+    // Impulse response file of the convolution reverb
+    if (auto *convolution = dynamic_cast<DSPBlockConvolutionReverb *>(block_)) {
+        auto irTooltip = [convolution]() {
+            QString path = QString::fromStdString(convolution->getImpulseResponsePath());
+            return path.isEmpty() ? QString("Load impulse response (generated room)")
+                                  : "Load impulse response (" + QFileInfo(path).fileName() + ")";
+        };
+        auto *loadBtn = create_small_button(":/icons/open.svg", irTooltip(), "loadIrBtn", 24, buttonBar_);
+        connect(loadBtn, &QPushButton::clicked, this, [this, convolution, loadBtn, irTooltip]() {
+            QString path = QFileDialog::getOpenFileName(this, "Load impulse response", "", "WAV Files (*.wav)");
+            if (path.isEmpty()) return;
+            convolution->loadImpulseResponse(path.toStdString());
+            loadBtn->setToolTip(irTooltip());
+        });
+        buttonBarLayout_->addWidget(loadBtn);
+        buttonWidgets_.push_back(loadBtn);
+
+        auto *roomBtn = create_small_button(":/icons/clear.svg", "Use generated room", "roomBtn", 24, buttonBar_);
+        connect(roomBtn, &QPushButton::clicked, this, [convolution, loadBtn, irTooltip]() {
+            convolution->useGeneratedRoom();
+            loadBtn->setToolTip(irTooltip());
+        });
+        buttonBarLayout_->addWidget(roomBtn);
+        buttonWidgets_.push_back(roomBtn);
+        buttonCount += 2;
+    }
     buttonBarLayout_->addStretch(1);
     buttonBar_->setVisible(buttonCount > 0);
 }
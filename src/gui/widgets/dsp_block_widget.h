@@ -5,6 +5,7 @@
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QPushButton>
+#include <QProgressBar>
 #include <vector>
 #include <memory>
 
@@ -21,6 +22,7 @@ public:
     explicit DSPBlockWidget(NoteNagaDSPBlockBase* block, QWidget* parent = nullptr);
 
     NoteNagaDSPBlockBase* block() const { return block_; }
+    void setLoad(const NN_DSPLoad_t& load);
     QSize minimumSizeHint() const override;
 
 protected:
@@ -52,6 +54,7 @@ private:
     QPushButton* rightBtn_;
     QPushButton* deactivateBtn_;
     QPushButton* deleteBtn_;
+    QProgressBar* loadBar_;
 
     // Content area
     QWidget* contentWidget_;
@@ -1,18 +1,24 @@
 #include "dsp_engine_widget.h"
 
 #include <note_naga_engine/dsp/dsp_factory.h>
+#include <note_naga_engine/io/dsp_chain_preset.h>
 #include "../nn_gui_utils.h"
 #include "../dialogs/dsp_block_chooser_dialog.h"
+#include <QFileDialog>
+#include <QFileInfo>
 #include <QFrame>
 #include <QHBoxLayout>
 #include <QIcon>
 #include <QLabel>
+#include <QMessageBox>
+#include <QProgressBar>
 #include <QPushButton>
 #include <QScrollArea>
 #include <QSlider>
 #include <QSpacerItem>
 #include <QTimer>
 #include <QVBoxLayout>
+#include <algorithm>
 
 DSPEngineWidget::DSPEngineWidget(NoteNagaEngine *engine, QWidget *parent)
     : QWidget(parent), engine(engine), title_widget(nullptr), dsp_layout(nullptr) {
@@ -54,13 +60,22 @@ void DSPEngineWidget::initTitleUI() {
     btn_clear = create_small_button(":/icons/clear.svg", "Remove all DSP modules", "btn_clear");
     btn_enable = create_small_button(":/icons/active.svg", "Enable / Disable DSP", "btn_enable");
     btn_enable->setCheckable(true);
+    btn_aux = create_small_button(":/icons/route.svg", "Add aux bus", "btn_aux");
+    btn_save_preset = create_small_button(":/icons/save.svg", "Save chain preset", "btn_save_preset");
+    btn_load_preset = create_small_button(":/icons/open.svg", "Load chain preset", "btn_load_preset");
 
     layout->addWidget(btn_add, 0, Qt::AlignBottom | Qt::AlignHCenter);
     layout->addWidget(btn_clear, 0, Qt::AlignBottom | Qt::AlignHCenter);
+    layout->addWidget(btn_aux, 0, Qt::AlignBottom | Qt::AlignHCenter);
+    layout->addWidget(btn_save_preset, 0, Qt::AlignBottom | Qt::AlignHCenter);
+    layout->addWidget(btn_load_preset, 0, Qt::AlignBottom | Qt::AlignHCenter);
     layout->addWidget(btn_enable, 0, Qt::AlignBottom | Qt::AlignHCenter);
 
     connect(btn_add, &QPushButton::clicked, this, &DSPEngineWidget::addDSPClicked);
     connect(btn_clear, &QPushButton::clicked, this, &DSPEngineWidget::removeAllDSPClicked);
+    connect(btn_aux, &QPushButton::clicked, this, &DSPEngineWidget::auxBusClicked);
+    connect(btn_save_preset, &QPushButton::clicked, this, &DSPEngineWidget::savePresetClicked);
+    connect(btn_load_preset, &QPushButton::clicked, this, &DSPEngineWidget::loadPresetClicked);
     connect(btn_enable, &QPushButton::clicked, this, &DSPEngineWidget::toggleDSPEnabled);
 }
 
@@ -81,6 +96,12 @@ void DSPEngineWidget::updateSynthesizerSelector() {
             synth_selector->addItem(name, QVariant::fromValue(static_cast<void*>(soft_synth)));
         }
     }
+
+    // Add aux buses (item data is the bus index)
+    NoteNagaDSPEngine *dsp_engine = engine->getDSPEngine();
+    for (int bus = 0; dsp_engine && bus < dsp_engine->getAuxBusCount(); ++bus) {
+        synth_selector->addItem("Aux: " + QString::fromStdString(dsp_engine->getAuxBusName(bus)), QVariant(bus));
+    }
     
     // Restore selection if possible
     if (!current_text.isEmpty()) {
@@ -96,17 +117,20 @@ void DSPEngineWidget::updateSynthesizerSelector() {
 void DSPEngineWidget::onSynthesizerSelected(int index) {
     if (index < 0) return;
     
-    // Get the selected synth
-    if (index == 0) {
-        current_synth = nullptr; // Master
-    } else {
+    // Get the selected synth or aux bus
+    current_synth = nullptr;
+    current_aux_bus = -1;
+    if (index > 0) {
         QVariant data = synth_selector->itemData(index);
-        if (data.isValid()) {
+        if (data.userType() == QMetaType::Int) {
+            current_aux_bus = data.toInt();
+        } else if (data.isValid()) {
             current_synth = static_cast<INoteNagaSoftSynth*>(data.value<void*>());
         }
     }
     
     // Update UI
+    updateAuxButton();
     refreshDSPWidgets();
 }
 
@@ -133,6 +157,128 @@ void DSPEngineWidget::clearDSPWidgets() {
         widget->deleteLater();
     }
     dsp_widgets.clear();
+
+    if (sends_widget) {
+        dsp_layout->removeWidget(sends_widget);
+        sends_widget->deleteLater();
+        sends_widget = nullptr;
+    }
+}
+
+std::vector<NoteNagaDSPBlockBase*> DSPEngineWidget::currentChainBlocks() const {
+    NoteNagaDSPEngine *dsp_engine = engine->getDSPEngine();
+    if (current_aux_bus >= 0) return dsp_engine->getAuxBusDSPBlocks(current_aux_bus);
+    if (current_synth) return dsp_engine->getSynthDSPBlocks(current_synth);
+    return dsp_engine->getDSPBlocks();
+}
+
+void DSPEngineWidget::addToCurrentChain(NoteNagaDSPBlockBase *block) {
+    NoteNagaDSPEngine *dsp_engine = engine->getDSPEngine();
+    if (current_aux_bus >= 0) {
+        dsp_engine->addAuxBusDSPBlock(current_aux_bus, block);
+    } else if (current_synth) {
+        dsp_engine->addSynthDSPBlock(current_synth, block);
+    } else {
+        dsp_engine->addDSPBlock(block);
+    }
+}
+
+void DSPEngineWidget::removeFromCurrentChain(NoteNagaDSPBlockBase *block) {
+    NoteNagaDSPEngine *dsp_engine = engine->getDSPEngine();
+    if (current_aux_bus >= 0) {
+        dsp_engine->removeAuxBusDSPBlock(current_aux_bus, block);
+    } else if (current_synth) {
+        dsp_engine->removeSynthDSPBlock(current_synth, block);
+    } else {
+        dsp_engine->removeDSPBlock(block);
+    }
+}
+
+void DSPEngineWidget::reorderCurrentChain(int from_idx, int to_idx) {
+    NoteNagaDSPEngine *dsp_engine = engine->getDSPEngine();
+    if (current_aux_bus >= 0) {
+        dsp_engine->reorderAuxBusDSPBlock(current_aux_bus, from_idx, to_idx);
+    } else if (current_synth) {
+        dsp_engine->reorderSynthDSPBlock(current_synth, from_idx, to_idx);
+    } else {
+        dsp_engine->reorderDSPBlock(from_idx, to_idx);
+    }
+}
+
+void DSPEngineWidget::replaceCurrentChain(const std::vector<NoteNagaDSPBlockBase*> &blocks) {
+    NoteNagaDSPEngine *dsp_engine = engine->getDSPEngine();
+    if (current_aux_bus >= 0) {
+        dsp_engine->setAuxBusDSPBlocks(current_aux_bus, blocks);
+    } else if (current_synth) {
+        dsp_engine->setSynthDSPBlocks(current_synth, blocks);
+    } else {
+        dsp_engine->setDSPBlocks(blocks);
+    }
+}
+
+void DSPEngineWidget::buildSendsWidget() {
+    NoteNagaDSPEngine *dsp_engine = engine->getDSPEngine();
+    int bus_count = dsp_engine->getAuxBusCount();
+    if (!current_synth || bus_count == 0) return;
+
+    sends_widget = new QFrame();
+    sends_widget->setObjectName("SendsWidget");
+    sends_widget->setStyleSheet("QFrame#SendsWidget { background-color: #32353b; border: 1px solid #19191f; "
+                                "border-radius: 6px; }");
+    QVBoxLayout *layout = new QVBoxLayout(sends_widget);
+    layout->setContentsMargins(4, 4, 4, 4);
+    layout->setSpacing(4);
+
+    QLabel *title = new QLabel("Sends", sends_widget);
+    title->setAlignment(Qt::AlignCenter);
+    title->setStyleSheet("font-size: 12px; color: #ddd; font-weight: bold;");
+    layout->addWidget(title);
+
+    for (int bus = 0; bus < bus_count; ++bus) {
+        AudioDial *dial = new AudioDial(sends_widget);
+        dial->setRange(0.0f, 1.0f);
+        dial->setValue(dsp_engine->getSynthAuxSend(current_synth, bus));
+        dial->setDefaultValue(0.0f);
+        dial->setLabel(QString::fromStdString(dsp_engine->getAuxBusName(bus)));
+        dial->setGradient(QColor("#6cb0ff"), QColor("#ae6cff"));
+        dial->showLabel(true);
+        dial->showValue(true);
+        dial->setValueDecimals(2);
+        INoteNagaSoftSynth *synth = current_synth;
+        connect(dial, &AudioDial::valueChanged, this, [this, synth, bus](float val) {
+            engine->getDSPEngine()->setSynthAuxSend(synth, bus, val);
+        });
+        layout->addWidget(dial);
+    }
+    layout->addStretch(1);
+    dsp_layout->insertWidget(dsp_layout->count() - 1, sends_widget);
+}
+
+void DSPEngineWidget::updateAuxButton() {
+    bool aux = current_aux_bus >= 0;
+    btn_aux->setToolTip(aux ? "Remove aux bus" : "Add aux bus");
+    btn_aux->setIcon(QIcon(aux ? ":/icons/remove.svg" : ":/icons/route.svg"));
+}
+
+void DSPEngineWidget::auxBusClicked() {
+    NoteNagaDSPEngine *dsp_engine = engine->getDSPEngine();
+    if (!dsp_engine) return;
+
+    if (current_aux_bus >= 0) {
+        // Remove the selected bus together with its blocks
+        std::vector<NoteNagaDSPBlockBase*> blocks = dsp_engine->getAuxBusDSPBlocks(current_aux_bus);
+        clearDSPWidgets();
+        dsp_engine->removeAuxBus(current_aux_bus);
+        for (NoteNagaDSPBlockBase *block : blocks) delete block;
+        synth_selector->setCurrentIndex(0); // Master
+        updateSynthesizerSelector();
+        return;
+    }
+
+    int bus = dsp_engine->addAuxBus("Bus " + std::to_string(dsp_engine->getAuxBusCount() + 1));
+    updateSynthesizerSelector();
+    synth_selector->setCurrentIndex(synth_selector->findText(
+        "Aux: " + QString::fromStdString(dsp_engine->getAuxBusName(bus))));
 }
 
 void DSPEngineWidget::refreshDSPWidgets() {
@@ -141,15 +287,11 @@ void DSPEngineWidget::refreshDSPWidgets() {
     
     if (!engine) return;
     
-    // Get current DSP blocks (for master or synth)
-    std::vector<NoteNagaDSPBlockBase*> blocks;
-    if (current_synth == nullptr) {
-        // Master blocks
-        blocks = engine->getDSPEngine()->getDSPBlocks();
-    } else {
-        // Synth-specific blocks
-        blocks = engine->getDSPEngine()->getSynthDSPBlocks(current_synth);
-    }
+    // Send levels of the selected synth
+    buildSendsWidget();
+
+    // Get current DSP blocks (for master, synth or aux bus)
+    std::vector<NoteNagaDSPBlockBase*> blocks = currentChainBlocks();
     
     // Create widgets for each block
     for (auto block : blocks) {
@@ -159,13 +301,7 @@ void DSPEngineWidget::refreshDSPWidgets() {
         
         // Delete handler
         connect(dsp_widget, &DSPBlockWidget::deleteRequested, this, [this, dsp_widget, block]() {
-            if (current_synth == nullptr) {
-                // Remove from master
-                engine->getDSPEngine()->removeDSPBlock(block);
-            } else {
-                // Remove from synth
-                engine->getDSPEngine()->removeSynthDSPBlock(current_synth, block);
-            }
+            removeFromCurrentChain(block);
             dsp_layout->removeWidget(dsp_widget);
             dsp_widgets.erase(std::remove(dsp_widgets.begin(), dsp_widgets.end(), dsp_widget), dsp_widgets.end());
             dsp_widget->deleteLater();
@@ -176,11 +312,7 @@ void DSPEngineWidget::refreshDSPWidgets() {
         connect(dsp_widget, &DSPBlockWidget::moveLeftRequested, this, [this, dsp_widget, block]() {
             int idx = std::distance(dsp_widgets.begin(), std::find(dsp_widgets.begin(), dsp_widgets.end(), dsp_widget));
             if (idx > 0) {
-                if (current_synth == nullptr) {
-                    engine->getDSPEngine()->reorderDSPBlock(idx, idx-1);
-                } else {
-                    engine->getDSPEngine()->reorderSynthDSPBlock(current_synth, idx, idx-1);
-                }
+                reorderCurrentChain(idx, idx-1);
                 dsp_widgets.erase(dsp_widgets.begin() + idx);
                 dsp_widgets.insert(dsp_widgets.begin() + idx-1, dsp_widget);
                 dsp_layout->removeWidget(dsp_widget);
@@ -191,11 +323,7 @@ void DSPEngineWidget::refreshDSPWidgets() {
         connect(dsp_widget, &DSPBlockWidget::moveRightRequested, this, [this, dsp_widget, block]() {
             int idx = std::distance(dsp_widgets.begin(), std::find(dsp_widgets.begin(), dsp_widgets.end(), dsp_widget));
             if (idx < int(dsp_widgets.size())-1) {
-                if (current_synth == nullptr) {
-                    engine->getDSPEngine()->reorderDSPBlock(idx, idx+1);
-                } else {
-                    engine->getDSPEngine()->reorderSynthDSPBlock(current_synth, idx, idx+1);
-                }
+                reorderCurrentChain(idx, idx+1);
                 dsp_widgets.erase(dsp_widgets.begin() + idx);
                 dsp_widgets.insert(dsp_widgets.begin() + idx+1, dsp_widget);
                 dsp_layout->removeWidget(dsp_widget);
@@ -274,15 +402,57 @@ void DSPEngineWidget::initUI() {
 
     info_layout->addWidget(center_section, 1);
 
+    // Voice usage of all synths (active / stolen / dropped)
+    QLabel *lbl_voices = new QLabel(info_panel);
+    lbl_voices->setAlignment(Qt::AlignCenter);
+    lbl_voices->setStyleSheet("font-size: 10px; color: #aaa;");
+    info_layout->addWidget(lbl_voices);
+
+    // CPU load of the whole render and of the selected synth
+    QProgressBar *load_bar = new QProgressBar(info_panel);
+    load_bar->setRange(0, 100);
+    load_bar->setValue(0);
+    load_bar->setTextVisible(false);
+    load_bar->setFixedHeight(6);
+    info_layout->addWidget(load_bar);
+
+    QLabel *lbl_load = new QLabel(info_panel);
+    lbl_load->setAlignment(Qt::AlignCenter);
+    lbl_load->setStyleSheet("font-size: 10px; color: #aaa;");
+    info_layout->addWidget(lbl_load);
+
     main_layout->addWidget(info_panel, 0);
 
     // Timer pro aktualizaci hodnoty
     QTimer *timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, [this, volume_bar]() {
+    connect(timer, &QTimer::timeout, this, [this, volume_bar, lbl_voices, load_bar, lbl_load]() {
         if (engine) {
             if (engine->getDSPEngine() == nullptr) return;
             auto dbs = engine->getDSPEngine()->getCurrentVolumeDb();
             volume_bar->setVolumesDb(dbs.first, dbs.second);
+
+            NN_SynthVoiceStats_t stats = engine->getDSPEngine()->getTotalVoiceStats();
+            lbl_voices->setText(QString("Voices: %1/%2\nStolen: %3 Dropped: %4")
+                                    .arg(stats.active_voices)
+                                    .arg(stats.max_voices)
+                                    .arg(stats.stolen_voices)
+                                    .arg(stats.dropped_notes));
+
+            NoteNagaDSPEngine *dsp_engine = engine->getDSPEngine();
+            float render_load = dsp_engine->getRenderLoad();
+            load_bar->setValue(std::clamp(int(render_load * 100.0f), 0, 100));
+            QString load_text = QString("CPU: %1 %").arg(render_load * 100.0f, 0, 'f', 1);
+            if (current_synth) {
+                NN_DSPLoad_t synth_load = dsp_engine->getSynthLoad(current_synth);
+                load_text += QString("\nSynth: %1 % (peak %2 %)")
+                                 .arg(synth_load.average * 100.0f, 0, 'f', 1)
+                                 .arg(synth_load.peak * 100.0f, 0, 'f', 1);
+            }
+            lbl_load->setText(load_text);
+
+            for (DSPBlockWidget *widget : dsp_widgets) {
+                widget->setLoad(dsp_engine->getBlockLoad(widget->block()));
+            }
         }
     });
     timer->start(50);
@@ -301,35 +471,57 @@ void DSPEngineWidget::addDSPClicked() {
     NoteNagaDSPBlockBase *new_block = selected->create();
     if (!new_block) return;
 
-    if (current_synth == nullptr) {
-        // Add to master
-        engine->getDSPEngine()->addDSPBlock(new_block);
-    } else {
-        // Add to synth
-        engine->getDSPEngine()->addSynthDSPBlock(current_synth, new_block);
-    }
+    addToCurrentChain(new_block);
     
     // Refresh UI
     refreshDSPWidgets();
 }
 
 void DSPEngineWidget::removeAllDSPClicked() {
-    if (current_synth == nullptr) {
-        // Remove all master DSP blocks
-        for (auto *dsp_widget : dsp_widgets) {
-            engine->getDSPEngine()->removeDSPBlock(dsp_widget->block());
-            delete dsp_widget->block();
-        }
-    } else {
-        // Remove all synth DSP blocks
-        for (auto *dsp_widget : dsp_widgets) {
-            engine->getDSPEngine()->removeSynthDSPBlock(current_synth, dsp_widget->block());
-            delete dsp_widget->block();
-        }
+    // Remove all DSP blocks of the selected chain
+    for (auto *dsp_widget : dsp_widgets) {
+        removeFromCurrentChain(dsp_widget->block());
+        delete dsp_widget->block();
     }
     
     // Clear UI
     clearDSPWidgets();
+    buildSendsWidget();
+}
+
+void DSPEngineWidget::savePresetClicked() {
+    if (!engine || !engine->getDSPEngine()) return;
+    QString path = QFileDialog::getSaveFileName(this, "Save DSP chain preset", "",
+                                                "DSP Chain Presets (*.nnchain);;Text Presets (*.txt)");
+    if (path.isEmpty()) return;
+
+    DSPChainPreset preset = DSPChainPreset::fromBlocks(currentChainBlocks());
+    preset.name = QFileInfo(path).completeBaseName().toStdString();
+    bool binary = QFileInfo(path).suffix().toLower() != "txt";
+    if (!preset.save(path.toStdString(), binary)) {
+        QMessageBox::warning(this, "Save DSP chain preset", "Failed to save preset:\n" + path);
+    }
+}
+
+void DSPEngineWidget::loadPresetClicked() {
+    if (!engine || !engine->getDSPEngine()) return;
+    QString path = QFileDialog::getOpenFileName(this, "Load DSP chain preset", "",
+                                                "DSP Chain Presets (*.nnchain *.txt);;All Files (*)");
+    if (path.isEmpty()) return;
+
+    DSPChainPreset preset;
+    if (!preset.load(path.toStdString())) {
+        QMessageBox::warning(this, "Load DSP chain preset", "Failed to load preset:\n" + path);
+        return;
+    }
+
+    // New blocks are created and prepared here, the audio thread switches to the whole
+    // chain at once and the old blocks can be deleted when the call returns
+    std::vector<NoteNagaDSPBlockBase*> old_blocks = currentChainBlocks();
+    clearDSPWidgets();
+    replaceCurrentChain(preset.createBlocks());
+    for (NoteNagaDSPBlockBase *block : old_blocks) delete block;
+    refreshDSPWidgets();
 }
 
 void DSPEngineWidget::toggleDSPEnabled() {
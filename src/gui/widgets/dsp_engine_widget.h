@@ -22,7 +22,8 @@
 
 /**
  * @brief DSPWidget provides a user interface for managing DSP modules in the application.
- * It includes a title bar with buttons for adding, removing, and clearing DSP modules,
+ * It includes a title bar with buttons for adding, removing, and clearing DSP modules
+ * and for saving / loading chain presets,
  * and a scrollable area to display the DSP modules.
  */
 class DSPEngineWidget : public QWidget {
@@ -45,6 +46,9 @@ private:
     QPushButton *btn_add;
     QPushButton *btn_clear;
     QPushButton *btn_enable;
+    QPushButton *btn_aux;
+    QPushButton *btn_save_preset;
+    QPushButton *btn_load_preset;
     
     // Combobox to select synthesizer
     VerticalComboBox *synth_selector;
@@ -52,15 +56,33 @@ private:
     // Currently selected synth (nullptr for master)
     INoteNagaSoftSynth *current_synth = nullptr;
 
+    // Currently selected aux bus (-1 if master or a synth is selected)
+    int current_aux_bus = -1;
+
+    // Send levels of the selected synth to all aux buses
+    QWidget *sends_widget = nullptr;
+
     void initTitleUI();
     void initUI();
     void refreshDSPWidgets();
     void clearDSPWidgets();
+    void buildSendsWidget();
+    void updateAuxButton();
+
+    // Operations on the selected chain (master, synth or aux bus)
+    std::vector<NoteNagaDSPBlockBase*> currentChainBlocks() const;
+    void addToCurrentChain(NoteNagaDSPBlockBase *block);
+    void removeFromCurrentChain(NoteNagaDSPBlockBase *block);
+    void reorderCurrentChain(int from_idx, int to_idx);
+    void replaceCurrentChain(const std::vector<NoteNagaDSPBlockBase*> &blocks);
 
 private slots:
     void addDSPClicked();
     void removeAllDSPClicked();
     void toggleDSPEnabled();
+    void auxBusClicked();
+    void savePresetClicked();
+    void loadPresetClicked();
     void onSynthesizerSelected(int index);
     void onSynthAdded(NoteNagaSynthesizer *synth);
     void onSynthRemoved(NoteNagaSynthesizer *synth);
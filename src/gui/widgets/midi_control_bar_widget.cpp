@@ -177,9 +177,8 @@ void MidiControlBarWidget::updateBPM() {
 }
 
 void MidiControlBarWidget::updateProgressBar() {
-    NoteNagaProject *project = this->engine->getProject();
     double us_per_tick = double(this->tempo) / double(this->ppq);
-    double cur_sec = double(project->getCurrentTick()) * us_per_tick / 1'000'000.0;
+    double cur_sec = double(this->engine->getAudibleTick()) * us_per_tick / 1'000'000.0;
     progress_bar->setCurrentTime(cur_sec);
 }
 
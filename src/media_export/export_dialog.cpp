@@ -305,9 +305,20 @@ void ExportDialog::setupUi()
     m_audioBitrateSpin->setRange(64, 320);
     m_audioBitrateSpin->setValue(192);
     m_audioBitrateSpin->setSuffix(tr(" kbps"));
+    m_audioSampleRateCombo = new QComboBox;
+    for (int rate : {44100, 48000, 96000}) {
+        m_audioSampleRateCombo->addItem(tr("%1 Hz").arg(rate), rate);
+    }
+    // Default to the live rate, exporting in it does not recreate the synthesizers
+    const int liveSampleRate = m_engine->getDSPEngine()->getSampleRate();
+    if (m_audioSampleRateCombo->findData(liveSampleRate) < 0) {
+        m_audioSampleRateCombo->addItem(tr("%1 Hz").arg(liveSampleRate), liveSampleRate);
+    }
+    m_audioSampleRateCombo->setCurrentIndex(m_audioSampleRateCombo->findData(liveSampleRate));
     
     audioFormLayout->addRow(tr("Format:"), m_audioFormatCombo);
     audioFormLayout->addRow(tr("Bitrate:"), m_audioBitrateSpin);
+    audioFormLayout->addRow(tr("Sample rate:"), m_audioSampleRateCombo);
     
     settingsLayout->addWidget(m_audioSettingsGroup);
     // <-- Konec nových audio/video skupin -->
@@ -791,6 +802,10 @@ void ExportDialog::onExportClicked()
     
     QString audioFormat = m_audioFormatCombo->currentText().toLower();
     int audioBitrate = m_audioBitrateSpin->value();
+    // Video soundtracks keep the live sample rate configured by the user
+    int audioSampleRate = (mode == MediaExporter::AudioOnly) 
+                          ? m_audioSampleRateCombo->currentData().toInt() 
+                          : m_engine->getDSPEngine()->getSampleRate();
     
     QString filter;
     QString defaultSuffix;
@@ -831,7 +846,7 @@ void ExportDialog::onExportClicked()
     
     m_exporter = new MediaExporter(m_sequence, outputPath, resolution, fps, this->m_engine, 
                                    secondsVisible, settings, 
-                                   mode, audioFormat, audioBitrate);
+                                   mode, audioFormat, audioBitrate, audioSampleRate);
     
     m_exporter->moveToThread(m_exportThread);
 
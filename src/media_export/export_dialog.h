@@ -115,6 +115,7 @@ private:
     QGroupBox *m_audioSettingsGroup;
     QComboBox *m_audioFormatCombo;
     QSpinBox *m_audioBitrateSpin;
+    QComboBox *m_audioSampleRateCombo;
 
     // Background settings
     QGroupBox *m_bgGroup;
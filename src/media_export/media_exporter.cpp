@@ -2,8 +2,10 @@
 
 #include "media_renderer.h"
 #include <note_naga_engine/note_naga_engine.h>
+#include <note_naga_engine/core/dsp_denormals.h>
 #include <opencv2/opencv.hpp>
 #include <QImage>
+#include <cstdint>
 #include <fstream>
 #include <QProcess>
 #include <QFileInfo>
@@ -54,6 +56,7 @@ MediaExporter::MediaExporter(NoteNagaMidiSeq *sequence, QString outputPath,
                              ExportMode exportMode, 
                              const QString& audioFormat, 
                              int audioBitrate, 
+                             int audioSampleRate,
                              QObject *parent)
     : QObject(parent), m_sequence(sequence), m_outputPath(outputPath),
       m_resolution(resolution), m_fps(fps), m_engine(engine),
@@ -61,6 +64,7 @@ MediaExporter::MediaExporter(NoteNagaMidiSeq *sequence, QString outputPath,
       m_exportMode(exportMode), 
       m_audioFormat(audioFormat), 
       m_audioBitrate(audioBitrate), 
+      m_audioSampleRate(audioSampleRate),
       m_framesRendered(0), m_totalFrames(0)
 {
     connect(&m_audioWatcher, &QFutureWatcher<bool>::finished, this, &MediaExporter::onTaskFinished);
@@ -198,7 +202,7 @@ bool MediaExporter::exportAudio(const QString &outputPath)
 {
     ManualModeGuard manualMode(this->m_engine);
 
-    const int sampleRate = 44100;
+    const int sampleRate = m_audioSampleRate;
     const int numChannels = 2;
     const double totalDuration = nn_ticks_to_seconds(m_engine->getProject()->getActiveSequence()->getMaxTick(), m_engine->getProject()->getPPQ(), m_engine->getProject()->getTempo()) + 2.0;
     const int totalSamples = static_cast<int>(totalDuration * sampleRate);
@@ -234,6 +238,22 @@ bool MediaExporter::exportAudio(const QString &outputPath)
     std::sort(allEvents.begin(), allEvents.end(), [](const MidiEvent &a, const MidiEvent &b)
               { return a.tick < b.tick; });
 
+    // Offline rendering has no deadline, keep full polyphony
+    bool voiceGuardEnabled = dspEngine->isVoiceGuardEnabled();
+    dspEngine->setVoiceGuardEnabled(false);
+
+    // Render in the export format with the largest blocks, the live format is restored afterwards
+    const int liveSampleRate = dspEngine->getSampleRate();
+    const size_t liveBlockFrames = dspEngine->getMaxBlockFrames();
+    dspEngine->prepare(sampleRate, SIZE_MAX);
+
+    // Same floating point mode as the audio callback, tails would render much slower with denormals
+    NoteNagaScopedNoDenormals noDenormals;
+
+    // Latent DSP blocks delay the output, render that much longer and drop the start
+    const int latencySamples = static_cast<int>(dspEngine->getOutputLatencySamples());
+    audioBuffer.resize(size_t(totalSamples + latencySamples) * numChannels, 0.0f);
+
     mixer->stopAllNotes();
     int last_tick = 0;
     int totalSamplesRendered = 0;
@@ -272,11 +292,15 @@ bool MediaExporter::exportAudio(const QString &outputPath)
     }
     emit audioProgressUpdated(100);
 
-    int remainingSamples = totalSamples - totalSamplesRendered;
+    int remainingSamples = totalSamples + latencySamples - totalSamplesRendered;
     if (remainingSamples > 0)
     {
         dspEngine->render(audioBuffer.data() + totalSamplesRendered * numChannels, remainingSamples, false);
     }
+    audioBuffer.erase(audioBuffer.begin(), audioBuffer.begin() + size_t(latencySamples) * numChannels);
+    dspEngine->setVoiceGuardEnabled(voiceGuardEnabled);
+    dspEngine->prepare(liveSampleRate, liveBlockFrames);
+
     std::ofstream file(outputPath.toStdString(), std::ios::binary);
     if (!file.is_open())
         return false;
@@ -31,6 +31,7 @@ public:
                            ExportMode exportMode, 
                            const QString& audioFormat, 
                            int audioBitrate, 
+                           int audioSampleRate,
                            QObject *parent = nullptr);
     ~MediaExporter();
 
@@ -59,6 +60,7 @@ private:
     ExportMode m_exportMode;
     QString m_audioFormat;
     int m_audioBitrate;
+    int m_audioSampleRate;
     
     // --- Stored settings ---
     double m_secondsVisible;